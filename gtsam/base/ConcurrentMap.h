@@ -43,6 +43,10 @@ using ConcurrentMapBase = tbb::concurrent_unordered_map<
 
 // If we're not using TBB, use a FastMap for ConcurrentMap
 #include <gtsam/base/FastMap.h>
+#include <initializer_list>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 template <typename KEY, typename VALUE>
 using ConcurrentMapBase = gtsam::FastMap<KEY, VALUE>;
 
@@ -90,12 +94,91 @@ public:
 #ifndef GTSAM_USE_TBB
   // If we're not using TBB and this is actually a FastMap, we need to add these functions and hide
   // the original erase functions.
-  void unsafe_erase(typename Base::iterator position) { ((Base*)this)->erase(position); }
-  typename Base::size_type unsafe_erase(const KEY& k) { return ((Base*)this)->erase(k); }
+  void unsafe_erase(typename Base::iterator position) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    ((Base*)this)->erase(position);
+  }
+  typename Base::size_type unsafe_erase(const KEY& k) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return ((Base*)this)->erase(k);
+  }
   void unsafe_erase(typename Base::iterator first, typename Base::iterator last) {
-    return ((Base*)this)->erase(first, last); }
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    ((Base*)this)->erase(first, last);
+  }
+  void clear() {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    Base::clear();
+  }
+
+  // Parallel algorithms running on the GTSAM ThreadPool insert into the same map from several
+  // threads, as they would into a tbb::concurrent_unordered_map, so every member that modifies
+  // the map is serialized.  Iterators and references stay valid as in any std::map.  Unlike
+  // with TBB, lookups (find, count, at, exists and iteration) must not overlap modifications.
+  typedef std::pair<typename Base::iterator, bool> InsertResult;
+  InsertResult insert(const typename Base::value_type& value) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::insert(value);
+  }
+  InsertResult insert(typename Base::value_type&& value) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::insert(std::move(value));
+  }
+  template<typename P, typename = typename std::enable_if<
+      std::is_constructible<typename Base::value_type, P&&>::value>::type>
+  InsertResult insert(P&& value) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::insert(std::forward<P>(value));
+  }
+  typename Base::iterator insert(typename Base::const_iterator hint,
+                                 const typename Base::value_type& value) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::insert(hint, value);
+  }
+  typename Base::iterator insert(typename Base::const_iterator hint,
+                                 typename Base::value_type&& value) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::insert(hint, std::move(value));
+  }
+  template<typename INPUTITERATOR>
+  void insert(INPUTITERATOR first, INPUTITERATOR last) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    Base::insert(first, last);
+  }
+  void insert(std::initializer_list<typename Base::value_type> values) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    Base::insert(values);
+  }
+  template<typename... ARGS>
+  InsertResult emplace(ARGS&&... args) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::emplace(std::forward<ARGS>(args)...);
+  }
+  template<typename... ARGS>
+  typename Base::iterator emplace_hint(typename Base::const_iterator hint, ARGS&&... args) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::emplace_hint(hint, std::forward<ARGS>(args)...);
+  }
+  VALUE& operator[](const KEY& key) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::operator[](key);
+  }
+  VALUE& operator[](KEY&& key) {
+    std::lock_guard<std::mutex> lock(insertMutex_.mutex);
+    return Base::operator[](std::move(key));
+  }
+
 private:
   void erase() {}
+
+  // A mutex that is not copied along with the map
+  struct InsertMutex {
+    std::mutex mutex;
+    InsertMutex() {}
+    InsertMutex(const InsertMutex&) {}
+    InsertMutex& operator=(const InsertMutex&) { return *this; }
+  };
+  InsertMutex insertMutex_;
 public:
 #endif
 
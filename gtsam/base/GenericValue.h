@@ -28,6 +28,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <new>
 #include <typeinfo> // operator typeid
 
 #ifdef _WIN32
@@ -111,6 +112,21 @@ public:
       delete this;
     }
 
+    /// Size of this object for cloneInto_, 0 for classes derived from GenericValue
+    size_t sizeOf_() const override {
+      return typeid(*this) == typeid(GenericValue) ? sizeof(GenericValue) : 0;
+    }
+
+    /// Alignment of this object for cloneInto_
+    size_t alignOf_() const override {
+      return alignof(GenericValue);
+    }
+
+    /// Copy construct this object in preallocated memory, see Value::cloneInto_
+    Value* cloneInto_(void* storage) const override {
+      return ::new (storage) GenericValue(*this);
+    }
+
     /**
      * Clone this value (normal clone on the heap, delete with 'delete' operator)
      */
@@ -129,6 +145,11 @@ public:
       return resultAsValue;
     }
 
+    /// Generic Value interface version of retract in place, without a temporary Value
+    void retractInPlace_(const Vector& delta) override {
+      value_ = traits<T>::Retract(value_, delta);
+    }
+
     /// Generic Value interface version of localCoordinates
     Vector localCoordinates_(const Value& value2) const override {
       // Cast the base class Value pointer to a templated generic class pointer
@@ -0,0 +1,125 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    LatencyHistogram.cpp
+ * @brief   Histogram of durations with a bounded relative error
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/base/LatencyHistogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+const size_t kSubBucketBits = 5;
+const uint64_t kSubBuckets = 1 << kSubBucketBits;
+
+// Index of the most significant bit of a nonzero value
+size_t MostSignificantBit(uint64_t value) {
+  size_t msb = 0;
+  for (size_t shift = 32; shift > 0; shift /= 2) {
+    if (value >> shift) {
+      value >>= shift;
+      msb += shift;
+    }
+  }
+  return msb;
+}
+}  // namespace
+
+/* ************************************************************************* */
+size_t LatencyHistogram::BucketIndex(uint64_t nanoseconds) {
+  // Values below kSubBuckets have a bucket each, above that every power of two
+  // has kSubBuckets buckets
+  if (nanoseconds < kSubBuckets) return nanoseconds;
+  const size_t shift = MostSignificantBit(nanoseconds) - kSubBucketBits;
+  return kSubBuckets * (shift + 1) + (nanoseconds >> shift) - kSubBuckets;
+}
+
+/* ************************************************************************* */
+uint64_t LatencyHistogram::BucketLowest(size_t index) {
+  if (index < kSubBuckets) return index;
+  const size_t shift = index / kSubBuckets - 1;
+  return (kSubBuckets + index % kSubBuckets) << shift;
+}
+
+/* ************************************************************************* */
+void LatencyHistogram::record(double seconds) {
+  const double nanoseconds = std::max(seconds, 0.0) * 1e9;
+  // Saturate instead of overflowing, at about 584 years
+  const uint64_t value = nanoseconds < 1.8e19 ? static_cast<uint64_t>(nanoseconds)
+                                              : UINT64_MAX;
+  const size_t index = BucketIndex(value);
+  if (index >= counts_.size()) counts_.resize(index + 1, 0);
+  ++counts_[index];
+  min_ = count_ == 0 ? value : std::min(min_, value);
+  max_ = count_ == 0 ? value : std::max(max_, value);
+  ++count_;
+  sum_ += std::max(seconds, 0.0);
+}
+
+/* ************************************************************************* */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  if (other.count_ == 0) return;
+  if (other.counts_.size() > counts_.size()) counts_.resize(other.counts_.size(), 0);
+  for (size_t i = 0; i < other.counts_.size(); ++i) counts_[i] += other.counts_[i];
+  min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+  max_ = count_ == 0 ? other.max_ : std::max(max_, other.max_);
+  count_ += other.count_;
+  sum_ += other.sum_;
+}
+
+/* ************************************************************************* */
+void LatencyHistogram::reset() { *this = LatencyHistogram(); }
+
+/* ************************************************************************* */
+double LatencyHistogram::min() const { return min_ * 1e-9; }
+
+/* ************************************************************************* */
+double LatencyHistogram::max() const { return max_ * 1e-9; }
+
+/* ************************************************************************* */
+double LatencyHistogram::mean() const { return count_ == 0 ? 0.0 : sum_ / count_; }
+
+/* ************************************************************************* */
+double LatencyHistogram::percentile(double p) const {
+  if (count_ == 0) return 0.0;
+  const double rank = std::min(std::max(p, 0.0), 100.0) / 100.0 * count_;
+  const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(rank)));
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    cumulative += counts_[i];
+    if (cumulative >= target) {
+      // Middle of the bucket, clamped to the recorded range
+      const uint64_t lowest = BucketLowest(i), next = BucketLowest(i + 1);
+      const uint64_t middle = next > lowest ? lowest + (next - lowest) / 2 : lowest;
+      return std::min(std::max(middle, min_), max_) * 1e-9;
+    }
+  }
+  return max();
+}
+
+/* ************************************************************************* */
+void LatencyHistogram::print(const string& s) const {
+  cout << s << "count: " << count_ << ", mean: " << 1e3 * mean()
+       << " ms, p50: " << 1e3 * percentile(50) << " ms, p90: " << 1e3 * percentile(90)
+       << " ms, p99: " << 1e3 * percentile(99) << " ms, max: " << 1e3 * max() << " ms"
+       << endl;
+}
+
+}  // namespace gtsam
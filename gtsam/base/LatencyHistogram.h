@@ -0,0 +1,79 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    LatencyHistogram.h
+ * @brief   Histogram of durations with a bounded relative error
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * A histogram of durations, with buckets in the style of HdrHistogram: every
+ * power of two nanoseconds is split into 32 linear buckets, so that recorded
+ * durations and percentiles are accurate to about 3% from nanoseconds to
+ * hours, in a few kilobytes.  Recording is a few integer operations.
+ *
+ * Not thread-safe, use one histogram per thread or object and merge them.
+ */
+class GTSAM_EXPORT LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+
+  /// Record a duration in seconds, negative durations count as zero
+  void record(double seconds);
+
+  /// Add the counts of another histogram
+  void merge(const LatencyHistogram& other);
+
+  /// Forget all recorded durations
+  void reset();
+
+  /// Number of recorded durations
+  size_t count() const { return count_; }
+
+  /// Shortest recorded duration in seconds, zero if none
+  double min() const;
+
+  /// Longest recorded duration in seconds, zero if none
+  double max() const;
+
+  /// Mean of the recorded durations in seconds, zero if none
+  double mean() const;
+
+  /// The duration in seconds that p percent of the recorded durations do not
+  /// exceed, for p in [0, 100], up to the bucket precision.  Zero if none.
+  double percentile(double p) const;
+
+  /// Print count, mean, p50, p90, p99 and max in milliseconds
+  void print(const std::string& s = "") const;
+
+ private:
+  static size_t BucketIndex(uint64_t nanoseconds);
+  static uint64_t BucketLowest(size_t index);
+
+  std::vector<uint64_t> counts_;  ///< Grown to the highest bucket recorded
+  size_t count_ = 0;
+  uint64_t min_ = 0, max_ = 0;  ///< In nanoseconds
+  double sum_ = 0.0;            ///< In seconds
+};
+
+}  // namespace gtsam
@@ -259,6 +259,13 @@ namespace gtsam {
       full().triangularView<Eigen::Upper>() = xpr.template triangularView<Eigen::Upper>();
     }
 
+    /// Add the active matrix of another SymmetricBlockMatrix with the same dimensions to the
+    /// active matrix. Only reads and writes the upper triangular part.
+    void addFullMatrix(const SymmetricBlockMatrix& other) {
+      assert(rows() == other.rows());
+      full().triangularView<Eigen::Upper>() += other.full();
+    }
+
     /// Set the entire active matrix zero.
     void setZero() {
       full().triangularView<Eigen::Upper>().setZero();
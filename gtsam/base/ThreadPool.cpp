@@ -0,0 +1,394 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ThreadPool.cpp
+ * @brief   Work-stealing thread pool and the parallel loops GTSAM is built on
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/base/ThreadPool.h>
+
+#include <cstdlib>
+
+namespace gtsam {
+
+namespace {
+// The pool the current thread is a worker of, and the index of its queue
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+
+// Tasks per thread aimed for when choosing the grain size automatically
+const size_t kChunksPerThread = 8;
+
+// Number of chunks of deterministic reductions, which may not depend on the number of threads
+const size_t kDeterministicChunks = 256;
+}  // namespace
+
+/* ************************************************************************* */
+size_t ParallelOptions::threads() const {
+  return nrThreads > 0 ? nrThreads : MaxConcurrency();
+}
+
+/* ************************************************************************* */
+size_t ParallelOptions::grain(size_t n, size_t minimumGrain) const {
+  if (grainSize > 0) return grainSize;
+  const size_t nrChunks =
+      deterministic ? kDeterministicChunks : kChunksPerThread * threads();
+  return std::max(std::max(minimumGrain, size_t(1)), n / nrChunks);
+}
+
+/* ************************************************************************* */
+// Tasks submitted under a concurrency limit wait in a queue of their own.  At most limit - 1
+// drain tasks on the pool execute them, next to the thread that called execute, and threads
+// waiting within the arena help as well.
+struct ThreadPool::Arena {
+  const size_t limit;
+  std::mutex mutex;
+  std::deque<Task> tasks;
+  size_t drainers;  ///< Drain tasks that were submitted and did not finish yet
+
+  explicit Arena(size_t limit) : limit(limit), drainers(0) {}
+
+  bool pop(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty()) return false;
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+  }
+
+  bool empty() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.empty();
+  }
+};
+
+/* ************************************************************************* */
+ThreadPool::Arena*& ThreadPool::CurrentArena() {
+  thread_local Arena* arena = nullptr;
+  return arena;
+}
+
+/* ************************************************************************* */
+ThreadPool::ThreadPool(size_t nrThreads) : queued_(0), stop_(false) {
+  const size_t nrWorkers = nrThreads > 1 ? nrThreads - 1 : 0;
+  for (size_t i = 0; i <= nrWorkers; ++i) queues_.emplace_back(new Queue());
+  workers_.reserve(nrWorkers);
+  for (size_t i = 0; i < nrWorkers; ++i)
+    workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+/* ************************************************************************* */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_ = true;
+  }
+  wakeUp_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+/* ************************************************************************* */
+void ThreadPool::submit(Task task) {
+  if (workers_.empty()) {
+    task();
+    return;
+  }
+  Arena* arena = currentPool == this ? CurrentArena() : nullptr;
+  if (!arena) {
+    enqueue(std::move(task));
+    return;
+  }
+  bool newDrainer = false;
+  {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    arena->tasks.push_back(std::move(task));
+    if (arena->drainers + 1 < arena->limit) {
+      ++arena->drainers;
+      newDrainer = true;
+    }
+  }
+  if (newDrainer)
+    enqueue([this, arena] { drain(arena); });
+  else
+    notifyWaiters();  // all threads of the arena are busy, a waiting one may take it
+}
+
+/* ************************************************************************* */
+void ThreadPool::enqueue(Task task) {
+  Queue& queue = currentPool == this ? *queues_[currentIndex] : *queues_.back();
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  queued_.fetch_add(1);
+  // Taking the lock orders the increment before a worker's check of queued_ in workerLoop
+  { std::lock_guard<std::mutex> lock(sleepMutex_); }
+  wakeUp_.notify_one();
+}
+
+/* ************************************************************************* */
+void ThreadPool::drain(Arena* arena) {
+  struct Restore {
+    Arena* arena;
+    ~Restore() { CurrentArena() = arena; }
+  } restore = {CurrentArena()};
+  CurrentArena() = arena;
+  Task task;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(arena->mutex);
+      if (arena->tasks.empty()) {
+        --arena->drainers;  // last access, execute may return after this
+        break;
+      }
+      task = std::move(arena->tasks.front());
+      arena->tasks.pop_front();
+    }
+    task();
+    task = nullptr;
+  }
+  notifyWaiters();
+}
+
+/* ************************************************************************* */
+bool ThreadPool::tryRunOne() {
+  Task task;
+  if (currentPool == this) {
+    Arena* arena = CurrentArena();
+    if (arena && arena->pop(task)) {
+      task();
+      return true;
+    }
+    if (!popOrSteal(currentIndex, task)) return false;
+    // Tasks of the pool queues were not submitted within the arena
+    struct Restore {
+      Arena* arena;
+      ~Restore() { CurrentArena() = arena; }
+    } restore = {arena};
+    CurrentArena() = nullptr;
+    task();
+  } else {
+    // Tasks run by a thread outside the pool still belong to this pool
+    if (!popOrSteal(workers_.size(), task)) return false;
+    execute(task);
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+void ThreadPool::helpUntil(const std::function<bool()>& done) {
+  while (!done()) {
+    if (tryRunOne()) continue;
+    Arena* arena = currentPool == this ? CurrentArena() : nullptr;
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wakeUp_.wait(lock, [&] {
+      return done() || queued_.load() > 0 || (arena && !arena->empty());
+    });
+  }
+}
+
+/* ************************************************************************* */
+void ThreadPool::notifyWaiters() {
+  // Taking the lock orders the caller's change before a waiter's check in helpUntil
+  { std::lock_guard<std::mutex> lock(sleepMutex_); }
+  wakeUp_.notify_all();
+}
+
+/* ************************************************************************* */
+void ThreadPool::execute(const std::function<void()>& f, size_t maxConcurrency) {
+  if (currentPool == this && maxConcurrency == 0) {
+    f();
+    return;
+  }
+  struct Restore {
+    ThreadPool* pool;
+    size_t index;
+    Arena* arena;
+    ~Restore() {
+      currentPool = pool;
+      currentIndex = index;
+      CurrentArena() = arena;
+    }
+  } restore = {currentPool, currentIndex, CurrentArena()};
+  if (currentPool != this) {
+    // Threads from outside the pool use the shared queue
+    currentPool = this;
+    currentIndex = workers_.size();
+    CurrentArena() = nullptr;
+  }
+  if (maxConcurrency == 0) {
+    f();
+    return;
+  }
+  if (maxConcurrency >= size()) {
+    CurrentArena() = nullptr;
+    f();
+    return;
+  }
+
+  Arena arena(maxConcurrency);
+  CurrentArena() = &arena;
+  std::exception_ptr error;
+  try {
+    f();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // Tasks of the arena refer to it, so they and their drainers have to finish first
+  helpUntil([&arena] {
+    std::lock_guard<std::mutex> lock(arena.mutex);
+    return arena.tasks.empty() && arena.drainers == 0;
+  });
+  if (error) std::rethrow_exception(error);
+}
+
+/* ************************************************************************* */
+size_t ThreadPool::concurrency() const {
+  const Arena* arena = currentPool == this ? CurrentArena() : nullptr;
+  return arena ? arena->limit : size();
+}
+
+/* ************************************************************************* */
+bool ThreadPool::popOrSteal(size_t index, Task& task) {
+  if (queued_.load() == 0) return false;
+  const size_t nrWorkers = workers_.size();
+
+  // Newest task of our own queue, while it is still hot in the cache
+  if (index < nrWorkers) {
+    Queue& own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued_.fetch_sub(1);
+      return true;
+    }
+  }
+
+  // Otherwise the oldest task of another worker or of the shared queue, which is last
+  for (size_t k = 0; k <= nrWorkers; ++k) {
+    const size_t victim = (index + 1 + k) % (nrWorkers + 1);
+    if (victim == index && index < nrWorkers) continue;
+    Queue& queue = *queues_[victim];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      queued_.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+/* ************************************************************************* */
+void ThreadPool::workerLoop(size_t index) {
+  currentPool = this;
+  currentIndex = index;
+  Task task;
+  while (true) {
+    if (popOrSteal(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wakeUp_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+    if (stop_ && queued_.load() == 0) return;
+  }
+}
+
+/* ************************************************************************* */
+ThreadPool& ThreadPool::Get() {
+  static ThreadPool pool(DefaultNrThreads());
+  return pool;
+}
+
+/* ************************************************************************* */
+ThreadPool& ThreadPool::Current() {
+  return currentPool ? *currentPool : Get();
+}
+
+/* ************************************************************************* */
+size_t ThreadPool::DefaultNrThreads() {
+  static const size_t nrThreads = [] {
+    if (const char* env = std::getenv("GTSAM_NUM_THREADS")) {
+      const int n = std::atoi(env);
+      if (n > 0) return static_cast<size_t>(n);
+    }
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }();
+  return nrThreads;
+}
+
+/* ************************************************************************* */
+size_t MaxConcurrency() {
+#ifdef GTSAM_USE_TBB
+  return static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+#else
+  return ThreadPool::Current().concurrency();
+#endif
+}
+
+#ifdef GTSAM_USE_TBB
+
+/* ************************************************************************* */
+TaskGroup::TaskGroup() {}
+
+/* ************************************************************************* */
+TaskGroup::~TaskGroup() {}
+
+/* ************************************************************************* */
+void TaskGroup::cancel() { tasks_.cancel(); }
+
+/* ************************************************************************* */
+void TaskGroup::wait() { tasks_.wait(); }
+
+#else
+
+/* ************************************************************************* */
+TaskGroup::TaskGroup()
+    : pool_(ThreadPool::Current()), pending_(0), cancelled_(false) {}
+
+/* ************************************************************************* */
+TaskGroup::~TaskGroup() {
+  // Queued tasks refer to this group, so they have to finish first
+  cancel();
+  pool_.helpUntil([this] { return pending_.load() == 0; });
+}
+
+/* ************************************************************************* */
+void TaskGroup::cancel() { cancelled_.store(true); }
+
+/* ************************************************************************* */
+void TaskGroup::wait() {
+  pool_.helpUntil([this] { return pending_.load() == 0; });
+  cancelled_.store(false);
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    std::swap(error, error_);
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+/* ************************************************************************* */
+void TaskGroup::fail(std::exception_ptr error) {
+  std::lock_guard<std::mutex> lock(errorMutex_);
+  if (!error_) error_ = error;
+  cancelled_.store(true);
+}
+
+#endif
+
+}  // namespace gtsam
@@ -0,0 +1,329 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ThreadPool.h
+ * @brief   Work-stealing thread pool and the parallel loops GTSAM is built on
+ * @date    Oct 16, 2026
+ */
+#pragma once
+
+#include <gtsam/dllexport.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>    // tbb::blocked_range
+#include <tbb/parallel_for.h>     // tbb::parallel_for
+#include <tbb/parallel_reduce.h>  // tbb::parallel_reduce
+#include <tbb/task_arena.h>       // tbb::task_arena
+#include <tbb/task_group.h>       // tbb::task_group
+#endif
+
+// GTSAM parallelizes loops and recursive algorithms through parallelFor, parallelReduce and
+// TaskGroup below.  When GTSAM is compiled with TBB they run on the TBB scheduler, otherwise on
+// ThreadPool, a small std::thread work-stealing pool owned by GTSAM, so that builds without TBB
+// get multi-core scaling too.
+//
+// Every parallel call takes a ParallelOptions with the number of threads and the grain size,
+// where 0 means the default: all cores (or the GTSAM_NUM_THREADS environment variable) and a
+// grain size giving several chunks per thread.  ParallelOptions::Serial() runs on the calling
+// thread only.
+
+namespace gtsam {
+
+/// Number of threads and grain size of a parallel loop
+struct GTSAM_EXPORT ParallelOptions {
+  size_t nrThreads;  ///< Number of threads to use, 0 for the default and 1 to run serially
+  size_t grainSize;  ///< Minimum number of iterations per task, 0 to choose automatically
+
+  /// Make reductions independent of the number of threads and of scheduling: chunks do not
+  /// depend on the number of threads and their results are combined in order.
+  bool deterministic;
+
+  explicit ParallelOptions(size_t nrThreads = 0, size_t grainSize = 0,
+                           bool deterministic = false)
+      : nrThreads(nrThreads), grainSize(grainSize), deterministic(deterministic) {}
+
+  /// Options running everything on the calling thread
+  static ParallelOptions Serial() { return ParallelOptions(1); }
+
+  /// The number of threads these options resolve to in the current context
+  size_t threads() const;
+
+  /// The number of iterations per task for a loop of n iterations, at least minimumGrain
+  size_t grain(size_t n, size_t minimumGrain = 1) const;
+
+  /// The same options with the grain size resolved for a loop of n iterations
+  ParallelOptions resolved(size_t n, size_t minimumGrain = 1) const {
+    return ParallelOptions(nrThreads, grain(n, minimumGrain), deterministic);
+  }
+};
+
+/**
+ * A fixed-size work-stealing thread pool.  Every worker thread owns a task queue: tasks
+ * submitted from a worker are pushed onto and popped from the back of its own queue, idle
+ * workers steal from the front of the other queues, and tasks submitted from outside the pool
+ * go to a shared queue.  A pool of n threads starts n - 1 workers, as the thread waiting for
+ * tasks (see TaskGroup) executes tasks as well.
+ *
+ * GTSAM uses a single pool, ThreadPool::Get(), for the lifetime of the program.  Callers asking
+ * for fewer threads get a concurrency limit on that pool rather than a pool of their own, see
+ * execute.
+ */
+class GTSAM_EXPORT ThreadPool {
+ public:
+  typedef std::function<void()> Task;
+
+  /// Create a pool for nrThreads threads, i.e. start nrThreads - 1 workers
+  explicit ThreadPool(size_t nrThreads);
+
+  /// Stop the workers, after executing tasks that are already queued
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Number of threads, including the waiting thread
+  size_t size() const { return workers_.size() + 1; }
+
+  /// Queue a task.  A pool of size one executes it immediately instead.
+  void submit(Task task);
+
+  /// Execute one queued task on the calling thread, returns false if there was none
+  bool tryRunOne();
+
+  /// Execute queued tasks on the calling thread until done() returns true, and block while
+  /// there is nothing to execute.  Whoever makes done() true has to call notifyWaiters().
+  void helpUntil(const std::function<bool()>& done);
+
+  /// Wake the threads blocked in helpUntil, so they check their condition again
+  void notifyWaiters();
+
+  /**
+   * Call f on the calling thread with this pool as ThreadPool::Current(), similar to
+   * tbb::task_arena::execute.  If maxConcurrency is smaller than size(), the tasks f submits,
+   * and the tasks those submit, are executed by at most maxConcurrency threads at a time,
+   * including the calling thread.
+   */
+  void execute(const std::function<void()>& f, size_t maxConcurrency = 0);
+
+  /// The number of threads that may execute the tasks submitted from the calling thread
+  size_t concurrency() const;
+
+  /// The shared pool, with DefaultNrThreads() threads
+  static ThreadPool& Get();
+
+  /// The pool the calling thread is a worker of, or Get() on threads outside any pool
+  static ThreadPool& Current();
+
+  /// GTSAM_NUM_THREADS if set in the environment, otherwise the number of hardware threads
+  static size_t DefaultNrThreads();
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // Tasks submitted under a concurrency limit, see execute
+  struct Arena;
+  static Arena*& CurrentArena();
+
+  void workerLoop(size_t index);
+  void enqueue(Task task);
+  bool popOrSteal(size_t index, Task& task);
+  void drain(Arena* arena);
+
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<Queue> > queues_;  ///< One per worker, the last one shared
+  std::atomic<size_t> queued_;
+  std::mutex sleepMutex_;
+  std::condition_variable wakeUp_;
+  bool stop_;
+};
+
+/**
+ * A group of tasks that can be waited for, similar to tbb::task_group.  Without TBB the tasks
+ * run on ThreadPool::Current() at construction.  Tasks may run further task groups.  wait()
+ * executes queued tasks while the group is not finished, blocks once there is nothing left to
+ * execute, and rethrows the first exception thrown by a task, after which the remaining tasks
+ * of the group are skipped.
+ */
+class GTSAM_EXPORT TaskGroup {
+ public:
+  TaskGroup();
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /// Queue a task, a copy of f is called with no arguments
+  template <typename F>
+  void run(F&& f) {
+#ifdef GTSAM_USE_TBB
+    tasks_.run(std::forward<F>(f));
+#else
+    pending_.fetch_add(1);
+    pool_.submit([this, f]() {
+      if (!cancelled_.load()) {
+        try {
+          f();
+        } catch (...) {
+          fail(std::current_exception());
+        }
+      }
+      // The group may be destroyed as soon as pending_ is zero, the pool outlives it
+      ThreadPool& pool = pool_;
+      if (pending_.fetch_sub(1) == 1) pool.notifyWaiters();
+    });
+#endif
+  }
+
+  /// Skip the tasks of this group that did not start yet
+  void cancel();
+
+  /// Wait for all tasks, executing queued tasks meanwhile
+  void wait();
+
+ private:
+#ifdef GTSAM_USE_TBB
+  tbb::task_group tasks_;
+#else
+  void fail(std::exception_ptr error);
+
+  ThreadPool& pool_;
+  std::atomic<size_t> pending_;
+  std::atomic<bool> cancelled_;
+  std::mutex errorMutex_;
+  std::exception_ptr error_;
+#endif
+};
+
+/// Number of threads parallel algorithms called from the current thread may use
+GTSAM_EXPORT size_t MaxConcurrency();
+
+/// Call f on the calling thread, such that parallel algorithms it calls use options.nrThreads
+/// threads, or the current number of threads if it is 0.  Similar to tbb::task_arena::execute.
+/// Without TBB, at most ThreadPool::Get().size() threads are used.
+template <typename F>
+void runWithThreads(const ParallelOptions& options, const F& f) {
+#ifdef GTSAM_USE_TBB
+  if (options.nrThreads == 0) {
+    f();
+  } else {
+    tbb::task_arena arena(static_cast<int>(options.nrThreads));
+    arena.execute(f);
+  }
+#else
+  if (options.nrThreads == 0)
+    f();
+  else
+    ThreadPool::Get().execute(f, options.nrThreads);
+#endif
+}
+
+/**
+ * Call body(first, last) on chunks [first, last) covering [begin, end), in parallel.  The
+ * chunks are about options.grain(end - begin) iterations long.
+ */
+template <typename BODY>
+void parallelFor(size_t begin, size_t end, const BODY& body,
+                 const ParallelOptions& options = ParallelOptions()) {
+  if (end <= begin) return;
+  const size_t n = end - begin, grain = options.grain(n);
+  if (grain >= n || options.threads() <= 1) {
+    body(begin, end);
+    return;
+  }
+  runWithThreads(options, [&] {
+#ifdef GTSAM_USE_TBB
+    tbb::parallel_for(tbb::blocked_range<size_t>(begin, end, grain),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        body(range.begin(), range.end());
+                      });
+#else
+    // The calling thread works on the first chunk, then helps with the others while waiting
+    TaskGroup tasks;
+    for (size_t first = begin + grain; first < end; first += grain) {
+      const size_t last = std::min(first + grain, end);
+      tasks.run([&body, first, last]() { body(first, last); });
+    }
+    try {
+      body(begin, begin + grain);
+    } catch (...) {
+      tasks.cancel();
+      tasks.wait();
+      throw;
+    }
+    tasks.wait();
+#endif
+  });
+}
+
+/**
+ * Reduce over [begin, end): every chunk [first, last) is reduced by body(first, last, identity)
+ * and the partial results are combined with join(a, b).  Chunks are formed as in parallelFor.
+ * With options.deterministic, or without TBB, the partial results are joined in order, so the
+ * result does not depend on scheduling.  Only deterministic reductions are also independent of
+ * the number of threads.
+ */
+template <typename T, typename BODY, typename JOIN>
+T parallelReduce(size_t begin, size_t end, const T& identity, const BODY& body,
+                 const JOIN& join, const ParallelOptions& options = ParallelOptions()) {
+  if (end <= begin) return identity;
+  const size_t n = end - begin, grain = options.grain(n);
+  if (grain >= n) return body(begin, end, identity);
+  if (!options.deterministic) {
+    if (options.threads() <= 1) return body(begin, end, identity);
+#ifdef GTSAM_USE_TBB
+    T result = identity;
+    runWithThreads(options, [&] {
+      result = tbb::parallel_reduce(
+          tbb::blocked_range<size_t>(begin, end, grain), identity,
+          [&](const tbb::blocked_range<size_t>& range, const T& init) {
+            return body(range.begin(), range.end(), init);
+          },
+          join);
+    });
+    return result;
+#endif
+  }
+
+  // Reduce chunks of a fixed size in parallel, then join their results in order
+  const size_t nrChunks = (n + grain - 1) / grain;
+  std::vector<T> partial(nrChunks, identity);
+  parallelFor(0, nrChunks,
+              [&](size_t firstChunk, size_t lastChunk) {
+                for (size_t c = firstChunk; c < lastChunk; ++c) {
+                  const size_t first = begin + c * grain;
+                  partial[c] = body(first, std::min(first + grain, end), identity);
+                }
+              },
+              ParallelOptions(options.nrThreads, 1));
+  T result = partial[0];
+  for (size_t c = 1; c < nrChunks; ++c) result = join(result, partial[c]);
+  return result;
+}
+
+}  // namespace gtsam
@@ -42,6 +42,18 @@ namespace gtsam {
     /** Deallocate a raw pointer of this value */
     virtual void deallocate_() const = 0;
 
+    /** Size in bytes of the memory cloneInto_() needs, or 0 if it is not supported, as in this
+     *  default implementation */
+    virtual size_t sizeOf_() const { return 0; }
+
+    /** Alignment in bytes of the memory cloneInto_() needs */
+    virtual size_t alignOf_() const { return alignof(Value); }
+
+    /** Copy construct this value in \c storage, which has sizeOf_() bytes aligned to
+     *  alignOf_(), and return it.  The copy has to be destroyed by calling its destructor, and
+     *  not with deallocate_.  Only called if sizeOf_() is not 0. */
+    virtual Value* cloneInto_(void* /*storage*/) const { return nullptr; }
+
     /** Clone this value (normal clone on the heap, delete with 'delete' operator) */
     virtual boost::shared_ptr<Value> clone() const = 0;
 
@@ -66,6 +78,21 @@ namespace gtsam {
      */
     virtual Value* retract_(const Vector& delta) const = 0;
 
+    /** Increment this value in place, see retract_().  The default implementation assigns
+     * the result of retract_(), derived classes can avoid allocating that temporary.
+     * @param delta The delta vector in the tangent space of this value
+     */
+    virtual void retractInPlace_(const Vector& delta) {
+      const Value* retracted = retract_(delta);
+      try {
+        *this = *retracted;
+      } catch (...) {
+        retracted->deallocate_();
+        throw;
+      }
+      retracted->deallocate_();
+    }
+
     /** Compute the coordinates in the tangent space of this value that
      * retract() would map to \c value.
      * @param value The value whose coordinates should be determined in the
@@ -104,6 +104,42 @@ pair<size_t, bool> choleskyCareful(Matrix& ATA, int order) {
   return make_pair(maxrank, success);
 }
 
+/* ************************************************************************* */
+// Factor the frontal block A = R'*R and compute S = inv(R') * B, for a number N of frontal
+// dimensions known at compile time.  The LLT and the triangular solve then work on a
+// fixed-size matrix on the stack, avoiding the overhead of dynamic-size Eigen that dominates
+// the small cliques of pose graphs.
+template <int N>
+static bool frontalCholeskyFixed(Matrix& ABC, size_t topleft, size_t n) {
+  auto A = ABC.block<N, N>(topleft, topleft);
+  const Eigen::LLT<Eigen::Matrix<double, N, N>, Eigen::Upper> llt(A);
+  if (llt.info() != Eigen::Success)
+    return false;
+  A.template triangularView<Eigen::Upper>() = llt.matrixU();
+
+  if (size_t(N) < n) {
+    auto B = ABC.block<N, Eigen::Dynamic>(topleft, topleft + N, N, n - N);
+    llt.matrixL().solveInPlace(B);
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+// Factor the frontal block A = R'*R and compute S = inv(R') * B for any number of frontal
+// dimensions.  The LLT works in place on ABC, and is blocked for large frontal blocks.
+static bool frontalCholeskyDynamic(Matrix& ABC, size_t nFrontal, size_t topleft, size_t n) {
+  Eigen::Ref<Matrix> A = ABC.block(topleft, topleft, nFrontal, nFrontal);
+  const Eigen::LLT<Eigen::Ref<Matrix>, Eigen::Upper> llt(A);
+  if (llt.info() != Eigen::Success)
+    return false;
+
+  if (nFrontal < n) {
+    auto B = ABC.block(topleft, topleft + nFrontal, nFrontal, n - nFrontal);
+    llt.matrixL().solveInPlace(B);
+  }
+  return true;
+}
+
 /* ************************************************************************* */
 bool choleskyPartial(Matrix& ABC, size_t nFrontal, size_t topleft) {
   gttic(choleskyPartial);
@@ -115,37 +151,35 @@ bool choleskyPartial(Matrix& ABC, size_t nFrontal, size_t topleft) {
   const size_t n = static_cast<size_t>(ABC.rows() - topleft);
   assert(nFrontal <= size_t(n));
 
-  // Create views on blocks
-  auto A = ABC.block(topleft, topleft, nFrontal, nFrontal);
-  auto B = ABC.block(topleft, topleft + nFrontal, nFrontal, n - nFrontal);
-  auto C = ABC.block(topleft + nFrontal, topleft + nFrontal, n - nFrontal, n - nFrontal);
-
-  // Compute Cholesky factorization A = R'*R, overwrites A.
-  gttic(LLT);
-  Eigen::LLT<Matrix, Eigen::Upper> llt(A);
-  Eigen::ComputationInfo lltResult = llt.info();
-  if (lltResult != Eigen::Success)
+  // Compute Cholesky factorization A = R'*R, overwrites A, and S = inv(R') * B, overwrites B.
+  // The kernel is chosen by the frontal dimension, with fixed-size kernels for the dimensions
+  // of common cliques, e.g., one or two Pose2, Pose3, NavState or Cal3Bundler cameras.
+  gttic(LLT_compute_S);
+  bool success;
+  switch (nFrontal) {
+    case 3: success = frontalCholeskyFixed<3>(ABC, topleft, n); break;
+    case 6: success = frontalCholeskyFixed<6>(ABC, topleft, n); break;
+    case 9: success = frontalCholeskyFixed<9>(ABC, topleft, n); break;
+    case 12: success = frontalCholeskyFixed<12>(ABC, topleft, n); break;
+    default: success = frontalCholeskyDynamic(ABC, nFrontal, topleft, n);
+  }
+  if (!success)
     return false;
-  auto R = A.triangularView<Eigen::Upper>();
-  R = llt.matrixU();
-  gttoc(LLT);
-
-  // Compute S = inv(R') * B
-  gttic(compute_S);
-  if (nFrontal < n)
-    R.transpose().solveInPlace(B);
-  gttoc(compute_S);
+  gttoc(LLT_compute_S);
 
   // Compute L = C - S' * S
   gttic(compute_L);
-  if (nFrontal < n)
+  if (nFrontal < n) {
+    auto B = ABC.block(topleft, topleft + nFrontal, nFrontal, n - nFrontal);
+    auto C = ABC.block(topleft + nFrontal, topleft + nFrontal, n - nFrontal, n - nFrontal);
     C.selfadjointView<Eigen::Upper>().rankUpdate(B.transpose(), -1.0);
+  }
   gttoc(compute_L);
 
   // Check last diagonal element - Eigen does not check it
+  const auto R = ABC.block(topleft, topleft, nFrontal, nFrontal);
   if (nFrontal >= 2) {
     int exp2, exp1;
-    // NOTE(gareth): R is already the size of A, so we don't need to add topleft here.
     (void)frexp(R(nFrontal - 2, nFrontal - 2), &exp2);
     (void)frexp(R(nFrontal - 1, nFrontal - 1), &exp1);
     return (exp2 - exp1 < underconstrainedExponentDifference);
@@ -57,6 +57,9 @@ GTSAM_EXPORT std::pair<size_t,bool> choleskyCareful(Matrix& ATA, int order = -1)
  *
  * if non-zero, factorization proceeds in bottom-right corner starting at topleft
  *
+ * Frontal blocks of 3, 6, 9 and 12 dimensions are factored with fixed-size kernels,
+ * others in place with Eigen's (blocked) LLT.
+ *
  * @return \c true if the decomposition is successful, \c false if \c A was
  * not positive-definite.
  */
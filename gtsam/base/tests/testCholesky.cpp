@@ -34,7 +34,12 @@ TEST(cholesky, choleskyPartial0) {
 
   // Test passing 0 frontals to partialCholesky
   Matrix RSL(ABC);
-  choleskyPartial(RSL, 0);
+  EXPECT(choleskyPartial(RSL, 0));
+  EXPECT(assert_equal(ABC, RSL, 1e-9));
+
+  // Also with a corner that is not eliminated, and with nothing left to eliminate
+  EXPECT(choleskyPartial(RSL, 0, 1));
+  EXPECT(choleskyPartial(RSL, 0, 3));
   EXPECT(assert_equal(ABC, RSL, 1e-9));
 }
 
@@ -66,6 +71,35 @@ TEST(cholesky, choleskyPartial) {
   EXPECT(assert_equal(expected, actual, 1e-9));
 }
 
+/* ************************************************************************* */
+TEST(cholesky, choleskyPartialKernels) {
+  // Frontal dimensions with fixed-size kernels and around them, with and without separator,
+  // and with a corner that is not eliminated
+  for (size_t nFrontal = 1; nFrontal <= 13; ++nFrontal) {
+    for (size_t nSeparator : {0, 4}) {
+      const size_t topleft = 2, n = nFrontal + nSeparator;
+      Matrix X(n + 3, n);
+      for (size_t i = 0; i < n + 3; ++i)
+        for (size_t j = 0; j < n; ++j) X(i, j) = std::cos(1.0 + i * n + 3.0 * j);
+      const Matrix ABC = X.transpose() * X + 0.1 * Matrix::Identity(n, n);
+
+      Matrix RSL = Matrix::Zero(topleft + n, topleft + n);
+      RSL.bottomRightCorner(n, n) = ABC.triangularView<Eigen::Upper>();
+      EXPECT(choleskyPartial(RSL, nFrontal, topleft));
+
+      // See the function comment for choleskyPartial, this decomposition should hold.
+      Matrix R1 = RSL.bottomRightCorner(n, n).triangularView<Eigen::Upper>().toDenseMatrix();
+      Matrix R2 = R1;
+      R1.transposeInPlace();
+      R1.bottomRightCorner(nSeparator, nSeparator).setIdentity();
+      R2.bottomRightCorner(nSeparator, nSeparator) =
+          R2.bottomRightCorner(nSeparator, nSeparator).selfadjointView<Eigen::Upper>();
+      EXPECT(assert_equal(Matrix(ABC), R1 * R2, 1e-9));
+      EXPECT(assert_equal(Matrix(Matrix::Zero(topleft, topleft + n)), Matrix(RSL.topRows(topleft))));
+    }
+  }
+}
+
 /* ************************************************************************* */
 TEST(cholesky, BadScalingCholesky) {
   Matrix A = (Matrix(2,2) <<
@@ -0,0 +1,83 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testLatencyHistogram.cpp
+ * @brief   Unit tests for LatencyHistogram
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/base/LatencyHistogram.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(LatencyHistogram, empty) {
+  LatencyHistogram histogram;
+  EXPECT_LONGS_EQUAL(0, histogram.count());
+  EXPECT_DOUBLES_EQUAL(0.0, histogram.mean(), 1e-12);
+  EXPECT_DOUBLES_EQUAL(0.0, histogram.percentile(99), 1e-12);
+}
+
+/* ************************************************************************* */
+TEST(LatencyHistogram, percentiles) {
+  // One to thousand milliseconds
+  LatencyHistogram histogram;
+  for (size_t i = 1; i <= 1000; ++i) histogram.record(i * 1e-3);
+
+  EXPECT_LONGS_EQUAL(1000, histogram.count());
+  EXPECT_DOUBLES_EQUAL(1e-3, histogram.min(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(1.0, histogram.max(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(0.5005, histogram.mean(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(0.5, histogram.percentile(50), 0.5 * 0.03);
+  EXPECT_DOUBLES_EQUAL(0.9, histogram.percentile(90), 0.9 * 0.03);
+  EXPECT_DOUBLES_EQUAL(0.99, histogram.percentile(99), 0.99 * 0.03);
+  EXPECT_DOUBLES_EQUAL(1.0, histogram.percentile(100), 0.03);
+  EXPECT_DOUBLES_EQUAL(1e-3, histogram.percentile(0), 1e-3 * 0.03);
+
+  // Durations below a microsecond and beyond hours
+  LatencyHistogram extremes;
+  extremes.record(-1.0);
+  extremes.record(5e-9);
+  extremes.record(3600.0 * 24 * 365);
+  EXPECT_DOUBLES_EQUAL(0.0, extremes.min(), 1e-12);
+  EXPECT_DOUBLES_EQUAL(5e-9, extremes.percentile(50), 1e-12);
+  EXPECT_DOUBLES_EQUAL(3600.0 * 24 * 365, extremes.max(), 1e-3);
+}
+
+/* ************************************************************************* */
+TEST(LatencyHistogram, merge) {
+  LatencyHistogram fast, slow, all;
+  for (size_t i = 0; i < 99; ++i) {
+    fast.record(1e-3);
+    all.record(1e-3);
+  }
+  slow.record(0.1);
+  all.record(0.1);
+
+  fast.merge(slow);
+  EXPECT_LONGS_EQUAL(all.count(), fast.count());
+  EXPECT_DOUBLES_EQUAL(all.mean(), fast.mean(), 1e-12);
+  EXPECT_DOUBLES_EQUAL(all.percentile(99), fast.percentile(99), 1e-12);
+  EXPECT_DOUBLES_EQUAL(0.1, fast.percentile(99.5), 0.1 * 0.03);
+
+  fast.reset();
+  EXPECT_LONGS_EQUAL(0, fast.count());
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -0,0 +1,204 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testThreadPool.cpp
+ * @brief   Unit tests for the thread pool and parallel loops
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/base/ThreadPool.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(ThreadPool, options) {
+  EXPECT_LONGS_EQUAL(1, ParallelOptions::Serial().threads());
+  EXPECT_LONGS_EQUAL(3, ParallelOptions(3).threads());
+  EXPECT_LONGS_EQUAL(7, ParallelOptions(4, 7).grain(1000));
+  // automatic: 8 chunks per thread, at least the minimum
+  EXPECT_LONGS_EQUAL(125, ParallelOptions(1).grain(1000));
+  EXPECT_LONGS_EQUAL(200, ParallelOptions(1).grain(1000, 200));
+  EXPECT_LONGS_EQUAL(1, ParallelOptions(4).grain(10));
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, submit) {
+  // Tasks submitted from outside run on the workers, or while helping
+  ThreadPool pool(4);
+  EXPECT_LONGS_EQUAL(4, pool.size());
+  atomic<int> count(0);
+  for (int i = 0; i < 100; ++i) pool.submit([&count] { ++count; });
+  while (count.load() < 100) pool.tryRunOne();
+  EXPECT_LONGS_EQUAL(100, count.load());
+
+  // A pool of one thread runs tasks immediately
+  ThreadPool serial(1);
+  serial.submit([&count] { ++count; });
+  EXPECT_LONGS_EQUAL(101, count.load());
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, parallelFor) {
+  for (size_t nrThreads : {1, 2, 4}) {
+    for (size_t grain : {0, 1, 7, 1000}) {
+      vector<int> visits(1000, 0);
+      parallelFor(0, visits.size(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) visits[i] += 1;
+      }, ParallelOptions(nrThreads, grain));
+      EXPECT(count(visits.begin(), visits.end(), 1) == 1000);
+    }
+  }
+
+  // Empty range
+  bool called = false;
+  parallelFor(5, 5, [&](size_t, size_t) { called = true; });
+  EXPECT(!called);
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, parallelReduce) {
+  vector<double> values(10000);
+  for (size_t i = 0; i < values.size(); ++i) values[i] = 1.0 / (1.0 + i);
+  const double expected = accumulate(values.begin(), values.end(), 0.0);
+
+  const auto sum = [&](size_t first, size_t last, double total) {
+    for (size_t i = first; i < last; ++i) total += values[i];
+    return total;
+  };
+  for (size_t nrThreads : {1, 2, 4}) {
+    const double actual = parallelReduce(0, values.size(), 0.0, sum, plus<double>(),
+                                         ParallelOptions(nrThreads, 100));
+    EXPECT_DOUBLES_EQUAL(expected, actual, 1e-9);
+  }
+  EXPECT_DOUBLES_EQUAL(3.0, parallelReduce(7, 7, 3.0, sum, plus<double>()), 0);
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, deterministicReduce) {
+  // Chunks do not depend on the number of threads
+  EXPECT_LONGS_EQUAL(39, ParallelOptions(1, 0, true).grain(10000));
+  EXPECT_LONGS_EQUAL(39, ParallelOptions(4, 0, true).grain(10000));
+
+  vector<double> values(10000);
+  for (size_t i = 0; i < values.size(); ++i) values[i] = 1.0 / (1.0 + i * i) - 1e-3 * (i % 7);
+  const auto sum = [&](size_t first, size_t last, double total) {
+    for (size_t i = first; i < last; ++i) total += values[i];
+    return total;
+  };
+  const double serial =
+      parallelReduce(0, values.size(), 0.0, sum, plus<double>(), ParallelOptions(1, 0, true));
+  for (size_t nrThreads : {2, 3, 4})
+    for (int repeat = 0; repeat < 5; ++repeat)
+      EXPECT(serial == parallelReduce(0, values.size(), 0.0, sum, plus<double>(),
+                                      ParallelOptions(nrThreads, 0, true)));
+}
+
+/* ************************************************************************* */
+// Recursive task groups, as in the parallel tree traversals
+static size_t fibonacci(size_t n) {
+  if (n < 2) return n;
+  size_t a = 0, b = 0;
+  TaskGroup tasks;
+  tasks.run([&] { a = fibonacci(n - 1); });
+  b = fibonacci(n - 2);
+  tasks.wait();
+  return a + b;
+}
+
+TEST(ThreadPool, nested) {
+  size_t actual = 0;
+  runWithThreads(ParallelOptions(4), [&] { actual = fibonacci(16); });
+  EXPECT_LONGS_EQUAL(987, actual);
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, concurrencyLimit) {
+  // Fewer threads than the pool has limit the tasks run at a time, without a pool of their own
+  ThreadPool pool(4);
+  atomic<int> running(0), maxRunning(0);
+  pool.execute([&] {
+    EXPECT_LONGS_EQUAL(2, MaxConcurrency());
+    TaskGroup tasks;
+    for (int i = 0; i < 20; ++i)
+      tasks.run([&] {
+        const int now = ++running;
+        int seen = maxRunning.load();
+        while (now > seen && !maxRunning.compare_exchange_weak(seen, now)) {}
+        this_thread::sleep_for(chrono::milliseconds(2));
+        --running;
+      });
+    tasks.wait();
+  }, 2);
+  EXPECT(maxRunning.load() <= 2);
+  EXPECT_LONGS_EQUAL(4, pool.size());
+
+  // Without a limit all threads of the pool are available
+  pool.execute([&] { EXPECT_LONGS_EQUAL(4, MaxConcurrency()); });
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, blockingWait) {
+  // A waiter with nothing left to execute blocks until a long task on a worker finishes
+  ThreadPool pool(2);
+  atomic<bool> started(false), finished(false);
+  pool.execute([&] {
+    TaskGroup tasks;
+    tasks.run([&] {
+      started = true;
+      this_thread::sleep_for(chrono::milliseconds(20));
+      finished = true;
+    });
+    while (!started.load()) this_thread::yield();
+    tasks.wait();
+    EXPECT(finished.load());
+  });
+}
+
+/* ************************************************************************* */
+TEST(ThreadPool, exception) {
+  // The first exception is rethrown by wait, after which the group can be reused
+  TaskGroup tasks;
+  atomic<int> count(0);
+  for (int i = 0; i < 10; ++i)
+    tasks.run([&count, i] {
+      ++count;
+      if (i == 3) throw runtime_error("task failed");
+    });
+  CHECK_EXCEPTION(tasks.wait(), runtime_error);
+  EXPECT(count.load() <= 10);
+  tasks.run([&count] { count = -1; });
+  tasks.wait();
+  EXPECT_LONGS_EQUAL(-1, count.load());
+
+  // parallelFor propagates exceptions as well
+  CHECK_EXCEPTION(parallelFor(0, 100, [](size_t first, size_t) {
+    if (first >= 50) throw invalid_argument("chunk failed");
+  }, ParallelOptions(4, 10)), invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -19,12 +19,17 @@
 #include <gtsam/base/TestableAssertions.h>
 #include <gtsam/base/treeTraversal-inst.h>
 
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/assign/std/list.hpp>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_arena.h>
+#endif
+
 using boost::assign::operator+=;
 using namespace std;
 using namespace gtsam;
@@ -35,6 +40,7 @@ struct TestNode {
   vector<shared_ptr> children;
   TestNode() : data(-1) {}
   TestNode(int data) : data(data) {}
+  int problemSize() const { return 1; }
 };
 
 struct TestForest {
@@ -126,6 +132,76 @@ TEST(treeTraversal, DepthFirst)
   EXPECT(assert_container_equality(postOrderExpected, postVisitor.visited));
 }
 
+/* ************************************************************************* */
+struct ParallelVisits {
+  // Visits may be concurrent, so the visitors below only write to the slot of the visited node.
+  // We record the parent data passed to every pre-order visit, and in post-order check that all
+  // children were post-visited before their parent.
+  std::vector<int> parentData;
+  std::vector<char> postVisited;  // not vector<bool>, whose elements share words
+  bool childrenFirst;
+  explicit ParallelVisits(size_t n) : parentData(n, -2), postVisited(n, 0), childrenFirst(true) {}
+};
+
+struct ParallelPreOrderVisitor {
+  ParallelVisits& visits;
+  int operator()(const TestNode::shared_ptr& node, int parent) {
+    visits.parentData[node->data] = parent;
+    return node->data;
+  }
+};
+
+struct ParallelPostOrderVisitor {
+  ParallelVisits& visits;
+  void operator()(const TestNode::shared_ptr& node, int myData) {
+    for(const TestNode::shared_ptr& child: node->children)
+      if(!visits.postVisited[child->data])
+        visits.childrenFirst = false;
+    visits.postVisited[node->data] = 1;
+  }
+};
+
+/* ************************************************************************* */
+TEST(treeTraversal, DepthFirstParallel)
+{
+  // A wider forest than makeTestForest so there are subtrees to run in parallel
+  TestForest forest;
+  int next = 0;
+  std::vector<int> expectedParents;
+  for(int r = 0; r < 4; ++r) {
+    forest.roots_.push_back(boost::make_shared<TestNode>(next++));
+    expectedParents.push_back(-1);
+    for(int c = 0; c < 5; ++c) {
+      TestNode::shared_ptr child = boost::make_shared<TestNode>(next++);
+      forest.roots_.back()->children.push_back(child);
+      expectedParents.push_back(forest.roots_.back()->data);
+      for(int g = 0; g < 3; ++g) {
+        child->children.push_back(boost::make_shared<TestNode>(next++));
+        expectedParents.push_back(child->data);
+      }
+    }
+  }
+
+  ParallelVisits visits(next);
+  ParallelPreOrderVisitor preVisitor = {visits};
+  ParallelPostOrderVisitor postVisitor = {visits};
+  int rootData = -1;
+#ifdef GTSAM_USE_TBB
+  // Force several workers even on a single core machine
+  tbb::task_arena arena(4);
+  arena.execute([&] {
+    treeTraversal::DepthFirstForestParallel(forest, rootData, preVisitor, postVisitor);
+  });
+#else
+  treeTraversal::DepthFirstForestParallel(forest, rootData, preVisitor, postVisitor);
+#endif
+
+  EXPECT(assert_container_equality(expectedParents, visits.parentData));
+  EXPECT(std::find(visits.postVisited.begin(), visits.postVisited.end(), 0) ==
+         visits.postVisited.end());
+  EXPECT(visits.childrenFirst);
+}
+
 /* ************************************************************************* */
 TEST(treeTraversal, CloneForest)
 {
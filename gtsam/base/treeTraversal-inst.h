@@ -135,9 +135,14 @@ void DepthFirstForest(FOREST& forest, DATA& rootData, VISITOR_PRE& visitorPre) {
   DepthFirstForest(forest, rootData, visitorPre, visitorPost);
 }
 
-/** Traverse a forest depth-first with pre-order and post-order visits.
+/** Traverse a forest depth-first with pre-order and post-order visits, in parallel.  Subtrees
+ *  are traversed in parallel tasks, on the TBB scheduler when GTSAM is compiled with TBB and on
+ *  the GTSAM ThreadPool otherwise, with the same visitor semantics as DepthFirstForest.  The
+ *  visits to the children of a node are ordered as in DepthFirstForest, but visits to different
+ *  subtrees may be concurrent.
  *  @param forest The forest of trees to traverse.  The method \c forest.roots() should exist
- *         and return a collection of (shared) pointers to \c FOREST::Node.
+ *         and return a collection of (shared) pointers to \c FOREST::Node, and nodes should
+ *         provide a \c problemSize() estimate of their work.
  *  @param visitorPre \c visitorPre(node, parentData) will be called at every node, before
  *         visiting its children, and will be passed, by reference, the \c DATA object returned
  *         by the visit to its parent.  Likewise, \c visitorPre should return the \c DATA object
@@ -148,22 +153,44 @@ void DepthFirstForest(FOREST& forest, DATA& rootData, VISITOR_PRE& visitorPre) {
  *         its children, and will be passed, by reference, the \c DATA object returned by the
  *         call to \c visitorPre (the \c DATA object may be modified by visiting the children).
  *  @param rootData The data to pass by reference to \c visitorPre when it is called on each
- *         root node. */
+ *         root node.
+ *  @param options Number of threads, and the minimum total problem size of a subtree for it to
+ *         be traversed in its own task.  A grain size of 0 derives it from the total problem
+ *         size of the forest and the number of threads. */
 template<class FOREST, typename DATA, typename VISITOR_PRE,
     typename VISITOR_POST>
 void DepthFirstForestParallel(FOREST& forest, DATA& rootData,
     VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost,
-    int problemSizeThreshold = 10) {
-#ifdef GTSAM_USE_TBB
+    const ParallelOptions& options) {
   // Typedefs
   typedef typename FOREST::Node Node;
+  typedef internal::TraversalTask<Node, DATA, VISITOR_PRE, VISITOR_POST> TraversalTask;
 
-  tbb::task::spawn_root_and_wait(
-      internal::CreateRootTask<Node>(forest.roots(), rootData, visitorPre,
-          visitorPost, problemSizeThreshold));
-#else
-  DepthFirstForest(forest, rootData, visitorPre, visitorPost);
-#endif
+  // No point in estimating subtree costs if we cannot run anything in parallel
+  const size_t nrThreads = options.threads();
+  if (nrThreads <= 1) {
+    DepthFirstForest(forest, rootData, visitorPre, visitorPost);
+    return;
+  }
+
+  const internal::SubtreeCosts<Node> costs(forest.roots());
+  const size_t grainSize = internal::GrainSize(costs.total(), nrThreads, options.grainSize);
+  runWithThreads(options, [&] {
+    TraversalTask::processChildren(forest.roots(), rootData, visitorPre, visitorPost, costs,
+        grainSize);
+  });
+}
+
+/** Traverse a forest depth-first in parallel with the default number of threads, see above.
+ *  @param problemSizeThreshold Minimum total problem size of a subtree for it to be traversed
+ *         in its own task, 0 to choose automatically. */
+template<class FOREST, typename DATA, typename VISITOR_PRE,
+    typename VISITOR_POST>
+void DepthFirstForestParallel(FOREST& forest, DATA& rootData,
+    VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost,
+    int problemSizeThreshold = 0) {
+  DepthFirstForestParallel(forest, rootData, visitorPre, visitorPost,
+      ParallelOptions(0, (size_t) std::max(problemSizeThreshold, 0)));
 }
 
 /* ************************************************************************* */
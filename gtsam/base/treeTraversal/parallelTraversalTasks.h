@@ -17,13 +17,18 @@
 #pragma once
 
 #include <gtsam/global_includes.h>
+#include <gtsam/base/ThreadPool.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 
 #ifdef GTSAM_USE_TBB
-#include <tbb/task.h>               // tbb::task, tbb::task_list
 #include <tbb/scalable_allocator.h> // tbb::scalable_allocator
+#endif
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace gtsam {
 
@@ -33,95 +38,141 @@ namespace gtsam {
     namespace internal {
 
       /* ************************************************************************* */
+      /// Estimated work in every subtree of a forest, used to decide which subtrees are large
+      /// enough to be traversed in their own task. The cost of a node is its problemSize(), with
+      /// a minimum of one, and the cost of a subtree is the sum over its nodes.
+      template<typename NODE>
+      class SubtreeCosts
+      {
+        std::unordered_map<const NODE*, size_t> costs_;
+        size_t total_;
+
+      public:
+        template<typename ROOTS>
+        explicit SubtreeCosts(const ROOTS& roots) : total_(0)
+        {
+          // Iterative post-order so that deep trees (e.g. chains) do not overflow the stack
+          typedef std::pair<const NODE*, bool> Entry;
+          std::vector<Entry> stack;
+          for(const boost::shared_ptr<NODE>& root: roots)
+            stack.push_back(Entry(root.get(), false));
+          while(!stack.empty())
+          {
+            Entry entry = stack.back();
+            if(entry.second)
+            {
+              stack.pop_back();
+              size_t cost = (size_t) std::max(entry.first->problemSize(), 1);
+              for(const boost::shared_ptr<NODE>& child: entry.first->children)
+                cost += costs_.at(child.get());
+              costs_[entry.first] = cost;
+            }
+            else
+            {
+              stack.back().second = true;
+              for(const boost::shared_ptr<NODE>& child: entry.first->children)
+                stack.push_back(Entry(child.get(), false));
+            }
+          }
+          for(const boost::shared_ptr<NODE>& root: roots)
+            total_ += costs_.at(root.get());
+        }
+
+        size_t operator()(const boost::shared_ptr<NODE>& node) const { return costs_.at(node.get()); }
+        size_t total() const { return total_; }
+      };
+
+      /* ************************************************************************* */
+      /// Grain size heuristic: aim for several tasks per worker thread so that work stealing can
+      /// balance unequal subtrees, but never spawn tasks for subtrees cheaper than minimumCost.
+      inline size_t GrainSize(size_t totalCost, size_t nrThreads, size_t minimumCost)
+      {
+        static const size_t tasksPerThread = 8;
+        return std::max(std::max(minimumCost, (size_t) 1), totalCost / (tasksPerThread * nrThreads));
+      }
+
+      /* ************************************************************************* */
+      /// Task traversing the subtree rooted at treeNode, whose pre-order visit already happened.
+      /// Children with expensive subtrees are traversed in their own tasks, cheap ones serially.
       template<typename NODE, typename DATA, typename VISITOR_PRE, typename VISITOR_POST>
-      class PreOrderTask : public tbb::task
+      class TraversalTask
       {
       public:
+        typedef SubtreeCosts<NODE> Costs;
+
         const boost::shared_ptr<NODE>& treeNode;
         boost::shared_ptr<DATA> myData;
         VISITOR_PRE& visitorPre;
         VISITOR_POST& visitorPost;
-        int problemSizeThreshold;
-        bool makeNewTasks;
-
-        bool isPostOrderPhase;
+        const Costs& costs;
+        size_t grainSize;
 
-        PreOrderTask(const boost::shared_ptr<NODE>& treeNode, const boost::shared_ptr<DATA>& myData,
-                     VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost, int problemSizeThreshold,
-                     bool makeNewTasks = true)
+        TraversalTask(const boost::shared_ptr<NODE>& treeNode, const boost::shared_ptr<DATA>& myData,
+                      VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost, const Costs& costs,
+                      size_t grainSize)
             : treeNode(treeNode),
               myData(myData),
               visitorPre(visitorPre),
               visitorPost(visitorPost),
-              problemSizeThreshold(problemSizeThreshold),
-              makeNewTasks(makeNewTasks),
-              isPostOrderPhase(false) {}
+              costs(costs),
+              grainSize(grainSize) {}
+
+        void operator()() const
+        {
+          processChildren(treeNode->children, *myData, visitorPre, visitorPost, costs, grainSize);
+          (void) visitorPost(treeNode, *myData);
+        }
 
-        tbb::task* execute() override
+        /// Visit children of a node (or the roots of a forest) with parent data parentData.
+        template<typename CHILDREN>
+        static void processChildren(const CHILDREN& children, DATA& parentData,
+                                    VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost,
+                                    const Costs& costs, size_t grainSize)
         {
-          if(isPostOrderPhase)
+          if(children.empty())
+            return;
+
+          // Run all pre-order visits first and in order: the visitors may modify the parent data,
+          // which is only safe before any child task starts.
+          std::vector<boost::shared_ptr<DATA> > childData;
+          childData.reserve(children.size());
+          for(const boost::shared_ptr<NODE>& child: children)
+#ifdef GTSAM_USE_TBB
+            childData.push_back(boost::allocate_shared<DATA>(
+                tbb::scalable_allocator<DATA>(), visitorPre(child, parentData)));
+#else
+            childData.push_back(boost::make_shared<DATA>(visitorPre(child, parentData)));
+#endif
+
+          TaskGroup childTasks;
+          for(size_t i = 0; i < children.size(); ++i)
+            if(costs(children[i]) >= grainSize)
+              childTasks.run(TraversalTask(children[i], childData[i], visitorPre, visitorPost,
+                                           costs, grainSize));
+
+          // Traverse the small subtrees in this task while the large ones run in parallel
+          try
           {
-            // Run the post-order visitor since this task was recycled to run the post-order visitor
-            (void) visitorPost(treeNode, *myData);
-            return nullptr;
+            for(size_t i = 0; i < children.size(); ++i)
+              if(costs(children[i]) < grainSize)
+                processNodeRecursively(children[i], *childData[i], visitorPre, visitorPost);
           }
-          else
+          catch(...)
           {
-            if(makeNewTasks)
-            {
-              if(!treeNode->children.empty())
-              {
-                // Allocate post-order task as a continuation
-                isPostOrderPhase = true;
-                recycle_as_continuation();
-
-                bool overThreshold = (treeNode->problemSize() >= problemSizeThreshold);
-
-                tbb::task* firstChild = 0;
-                tbb::task_list childTasks;
-                for(const boost::shared_ptr<NODE>& child: treeNode->children)
-                {
-                  // Process child in a subtask.  Important:  Run visitorPre before calling
-                  // allocate_child so that if visitorPre throws an exception, we will not have
-                  // allocated an extra child, this causes a TBB error.
-                  boost::shared_ptr<DATA> childData = boost::allocate_shared<DATA>(
-                      tbb::scalable_allocator<DATA>(), visitorPre(child, *myData));
-                  tbb::task* childTask =
-                      new (allocate_child()) PreOrderTask(child, childData, visitorPre, visitorPost,
-                                                          problemSizeThreshold, overThreshold);
-                  if (firstChild)
-                    childTasks.push_back(*childTask);
-                  else
-                    firstChild = childTask;
-                }
-
-                // If we have child tasks, start subtasks and wait for them to complete
-                set_ref_count((int)treeNode->children.size());
-                spawn(childTasks);
-                return firstChild;
-              }
-              else
-              {
-                // Run the post-order visitor in this task if we have no children
-                (void) visitorPost(treeNode, *myData);
-                return nullptr;
-              }
-            }
-            else
-            {
-              // Process this node and its children in this task
-              processNodeRecursively(treeNode, *myData);
-              return nullptr;
-            }
+            childTasks.cancel();
+            childTasks.wait();
+            throw;
           }
+          childTasks.wait();
         }
 
-        void processNodeRecursively(const boost::shared_ptr<NODE>& node, DATA& myData)
+        static void processNodeRecursively(const boost::shared_ptr<NODE>& node, DATA& myData,
+                                           VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost)
         {
           for(const boost::shared_ptr<NODE>& child: node->children)
           {
             DATA childData = visitorPre(child, myData);
-            processNodeRecursively(child, childData);
+            processNodeRecursively(child, childData, visitorPre, visitorPost);
           }
 
           // Run the post-order visitor
@@ -129,53 +180,8 @@ namespace gtsam {
         }
       };
 
-      /* ************************************************************************* */
-      template<typename ROOTS, typename NODE, typename DATA, typename VISITOR_PRE, typename VISITOR_POST>
-      class RootTask : public tbb::task
-      {
-      public:
-        const ROOTS& roots;
-        DATA& myData;
-        VISITOR_PRE& visitorPre;
-        VISITOR_POST& visitorPost;
-        int problemSizeThreshold;
-        RootTask(const ROOTS& roots, DATA& myData, VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost,
-          int problemSizeThreshold) :
-          roots(roots), myData(myData), visitorPre(visitorPre), visitorPost(visitorPost),
-          problemSizeThreshold(problemSizeThreshold) {}
-
-        tbb::task* execute() override
-        {
-          typedef PreOrderTask<NODE, DATA, VISITOR_PRE, VISITOR_POST> PreOrderTask;
-          // Create data and tasks for our children
-          tbb::task_list tasks;
-          for(const boost::shared_ptr<NODE>& root: roots)
-          {
-            boost::shared_ptr<DATA> rootData = boost::allocate_shared<DATA>(tbb::scalable_allocator<DATA>(), visitorPre(root, myData));
-            tasks.push_back(*new(allocate_child())
-              PreOrderTask(root, rootData, visitorPre, visitorPost, problemSizeThreshold));
-          }
-          // Set TBB ref count
-          set_ref_count(1 + (int) roots.size());
-          // Spawn tasks
-          spawn_and_wait_for_all(tasks);
-          // Return nullptr
-          return nullptr;
-        }
-      };
-
-      template<typename NODE, typename ROOTS, typename DATA, typename VISITOR_PRE, typename VISITOR_POST>
-      RootTask<ROOTS, NODE, DATA, VISITOR_PRE, VISITOR_POST>&
-        CreateRootTask(const ROOTS& roots, DATA& rootData, VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost, int problemSizeThreshold)
-      {
-          typedef RootTask<ROOTS, NODE, DATA, VISITOR_PRE, VISITOR_POST> RootTask;
-          return *new(tbb::task::allocate_root()) RootTask(roots, rootData, visitorPre, visitorPost, problemSizeThreshold);
-        }
-
     }
 
   }
 
 }
-
-#endif
@@ -73,6 +73,16 @@ public:
   typedef Eigen::Matrix<double, ZDim, D> MatrixZD;
   typedef std::vector<MatrixZD, Eigen::aligned_allocator<MatrixZD> > FBlocks;
 
+  /// Jacobians of the measurements of every camera with respect to a point of
+  /// dimension N
+  template<int N>
+  using EBlocks = std::vector<Eigen::Matrix<double, ZDim, N>,
+      Eigen::aligned_allocator<Eigen::Matrix<double, ZDim, N> > >;
+
+  /// Errors of the measurements of every camera
+  typedef std::vector<Eigen::Matrix<double, ZDim, 1>,
+      Eigen::aligned_allocator<Eigen::Matrix<double, ZDim, 1> > > BBlocks;
+
   /**
    * print
    * @param s optional string naming the factor
@@ -189,18 +199,86 @@ public:
     return augmentedHessian;
   }
 
+  /**
+   * Do Schur complement, given the Jacobians Fs and Es and the errors bs of
+   * every camera and P, into a SymmetricBlockMatrix with m blocks of dimension D
+   * and a last one of dimension 1, overwriting its upper triangle:
+   * G = F' * F - F' * E * P * E' * F
+   * g = F' * (b - E * P * E' * b)
+   * Fixed size version, that works on fixed-size blocks only
+   */
+  template<int N> // N = 2 or 3
+  static void SchurComplement(const FBlocks& Fs, const EBlocks<N>& Es,
+      const Eigen::Matrix<double, N, N>& P, const BBlocks& bs,
+      /*output ->*/SymmetricBlockMatrix& augmentedHessian) {
+
+    // a single point is observed in m cameras
+    size_t m = Fs.size();
+
+    // (Nx1) = sum of (NxZDim) * (ZDimx1)
+    Eigen::Matrix<double, N, 1> Etb = Eigen::Matrix<double, N, 1>::Zero();
+    double bSquaredNorm = 0.0;
+    for (size_t i = 0; i < m; i++) {
+      Etb.noalias() += Es[i].transpose() * bs[i];
+      bSquaredNorm += bs[i].squaredNorm();
+    }
+
+    // Blockwise Schur complement
+    for (size_t i = 0; i < m; i++) { // for each camera
+
+      const MatrixZD& Fi = Fs[i];
+      const auto FiT = Fi.transpose();
+      const Eigen::Matrix<double, ZDim, N> Ei_P = Es[i] * P;
+
+      // D = (DxZDim) * (ZDim - (ZDimxN) * (Nx1))
+      augmentedHessian.setOffDiagonalBlock(i, m, FiT * (bs[i] - Ei_P * Etb));
+
+      // (DxD) = (DxZDim) * ( (ZDimxD) - (ZDimxN) * (NxZDim) * (ZDimxD) )
+      augmentedHessian.setDiagonalBlock(i, FiT * (Fi - Ei_P * Es[i].transpose() * Fi));
+
+      // upper triangular part of the hessian
+      for (size_t j = i + 1; j < m; j++) { // for each camera
+        const MatrixZD& Fj = Fs[j];
+
+        // (DxD) = (DxZDim) * ( (ZDimxN) * (NxZDim) * (ZDimxD) )
+        augmentedHessian.setOffDiagonalBlock(i, j, -FiT
+            * (Ei_P * Es[j].transpose() * Fj));
+      }
+    } // end of for over cameras
+
+    augmentedHessian.diagonalBlock(m)(0, 0) = bSquaredNorm;
+  }
+
   /// Computes Point Covariance P, with lambda parameter
   template<int N> // N = 2 or 3
   static void ComputePointCovariance(Eigen::Matrix<double, N, N>& P,
       const Matrix& E, double lambda, bool diagonalDamping = false) {
 
-    Matrix EtE = E.transpose() * E;
+    Eigen::Matrix<double, N, N> EtE = E.transpose() * E;
+
+    if (diagonalDamping) { // diagonal of the hessian
+      EtE.diagonal() += lambda * EtE.diagonal();
+    } else {
+      EtE += lambda * Eigen::Matrix<double, N, N>::Identity();
+    }
+
+    P = (EtE).inverse();
+  }
+
+  /// Computes Point Covariance P, with lambda parameter, from the Jacobian
+  /// blocks of every camera
+  template<int N> // N = 2 or 3
+  static void ComputePointCovariance(Eigen::Matrix<double, N, N>& P,
+      const EBlocks<N>& Es, double lambda, bool diagonalDamping = false) {
+
+    Eigen::Matrix<double, N, N> EtE = Eigen::Matrix<double, N, N>::Zero();
+    for (const Eigen::Matrix<double, ZDim, N>& Ei : Es)
+      EtE.noalias() += Ei.transpose() * Ei;
 
     if (diagonalDamping) { // diagonal of the hessian
       EtE.diagonal() += lambda * EtE.diagonal();
     } else {
-      DenseIndex n = E.cols();
-      EtE += lambda * Eigen::MatrixXd::Identity(n, n);
+      EtE += lambda * Eigen::Matrix<double, N, N>::Identity();
     }
 
     P = (EtE).inverse();
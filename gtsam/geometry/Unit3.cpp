@@ -74,12 +74,10 @@ static Point3 CalculateBestAxis(const Point3& n) {
 
 /* ************************************************************************* */
 const Matrix32& Unit3::basis(OptionalJacobian<6, 2> H) const {
-#ifdef GTSAM_USE_TBB
   // NOTE(hayk): At some point it seemed like this reproducably resulted in
   // deadlock. However, I don't know why and I can no longer reproduce it.
   // It either was a red herring or there is still a latent bug left to debug.
   std::unique_lock<std::mutex> lock(B_mutex_);
-#endif
 
   const bool cachedBasis = static_cast<bool>(B_);
   const bool cachedJacobian = static_cast<bool>(H_B_);
@@ -432,6 +432,139 @@ TEST( triangulation, StereotriangulateNonlinear ) {
   }
 }
 
+//******************************************************************************
+// Three cameras and noisy tracks of five landmarks, some seen in only two cameras
+namespace batch {
+typedef PinholeCamera<Cal3_S2> Camera;
+const Pose3 pose3 = pose1 * Pose3(Rot3::Ypr(0.1, 0.2, 0.1), Point3(0.1, -2, -.1));
+const Camera camera3(pose3, Cal3_S2(700, 500, 0, 640, 480));
+const Point3 landmarks[] = {landmark, Point3(5, -0.5, 1.2), Point3(6, 0, 2),
+                            Point3(4, 1, 0.5), Point3(7, 0.2, 1)};
+
+CameraSet<Camera> cameras() {
+  CameraSet<Camera> cameras;
+  cameras += camera1, camera2, camera3;
+  return cameras;
+}
+
+vector<TriangulationTrack<Camera> > tracks() {
+  const CameraSet<Camera> cameras = batch::cameras();
+  vector<TriangulationTrack<Camera> > tracks;
+  for (size_t j = 0; j < 5; ++j) {
+    TriangulationTrack<Camera> track;
+    for (size_t i = 0; i < 3; ++i)
+      if (j < 3 || i != j - 3)
+        track.emplace_back(i, cameras[i].project(landmarks[j])
+                                  + Point2(0.3 * i - 0.4, 0.2 * j - 0.3));
+    tracks.push_back(track);
+  }
+  return tracks;
+}
+
+// The cameras and measurements of a track, to triangulate it on its own
+void split(const TriangulationTrack<Camera>& track, CameraSet<Camera>& trackCameras,
+           Point2Vector& measured) {
+  const CameraSet<Camera> cameras = batch::cameras();
+  for (const auto& measurement : track) {
+    trackCameras.push_back(cameras[measurement.first]);
+    measured.push_back(measurement.second);
+  }
+}
+}  // namespace batch
+
+//******************************************************************************
+TEST( triangulation, normalEquationsDLT) {
+  // Same as the SVD for a well-conditioned system
+  std::vector<Matrix34, Eigen::aligned_allocator<Matrix34>> projection_matrices;
+  projection_matrices.push_back(CameraProjectionMatrix<Cal3_S2>(*sharedCal)(pose1));
+  projection_matrices.push_back(CameraProjectionMatrix<Cal3_S2>(*sharedCal)(pose2));
+  Point2Vector measurements;
+  measurements += z1 + Point2(0.5, -0.3), z2;
+  Matrix A(4, 4);
+  for (size_t i = 0; i < 2; i++) {
+    A.row(2 * i) = measurements[i].x() * projection_matrices[i].row(2) - projection_matrices[i].row(0);
+    A.row(2 * i + 1) = measurements[i].y() * projection_matrices[i].row(2) - projection_matrices[i].row(1);
+  }
+  const Matrix4 AtA = A.transpose() * A;
+  boost::optional<Vector4> v = internal::triangulateHomogeneousDLTNormal(AtA, 1e-9);
+  CHECK(v);
+  const Point3 expected = triangulateDLT(projection_matrices, measurements, 1e-9);
+  EXPECT(assert_equal(expected, Point3(v->head<3>() / (*v)[3]), 1e-9));
+
+  // Falls back for rank-deficient systems and large rank tolerances
+  EXPECT(!internal::triangulateHomogeneousDLTNormal(Matrix4(A.topRows(2).transpose() * A.topRows(2)), 1e-9));
+  EXPECT(!internal::triangulateHomogeneousDLTNormal(AtA, 1e9));
+}
+
+//******************************************************************************
+TEST( triangulation, batch) {
+  using namespace batch;
+  const CameraSet<Camera> cameras = batch::cameras();
+  const vector<TriangulationTrack<Camera> > tracks = batch::tracks();
+
+  // The same points as triangulating every track on its own
+  const TriangulationParameters params;
+  const vector<TriangulationResult> actual = triangulateSafe(cameras, tracks, params);
+  EXPECT_LONGS_EQUAL(5, actual.size());
+  for (size_t j = 0; j < 5; ++j) {
+    CameraSet<Camera> trackCameras;
+    Point2Vector measured;
+    split(tracks[j], trackCameras, measured);
+    const TriangulationResult expected = triangulateSafe(trackCameras, measured, params);
+    CHECK(actual[j].valid());
+    EXPECT(assert_equal(*expected, *actual[j], 1e-9));
+    EXPECT(assert_equal(landmarks[j], *actual[j], 0.1));
+  }
+
+  // Refining moves the points to the minimum of the reprojection errors
+  const TriangulationParameters refine(1.0, true);
+  const vector<TriangulationResult> refined = triangulateSafe(cameras, tracks, refine);
+  for (size_t j = 0; j < 5; ++j) {
+    CameraSet<Camera> trackCameras;
+    Point2Vector measured;
+    split(tracks[j], trackCameras, measured);
+    const Point3 expected = triangulateNonlinear(trackCameras, measured, *actual[j]);
+    CHECK(refined[j].valid());
+    EXPECT(assert_equal(expected, *refined[j], 1e-4));
+    Vector3 gradient = Vector3::Zero();
+    for (size_t i = 0; i < trackCameras.size(); ++i) {
+      Matrix23 H;
+      gradient += H.transpose() * (trackCameras[i].project(*refined[j], boost::none, H) - measured[i]);
+    }
+    EXPECT(assert_equal(Vector3(Vector3::Zero()), gradient, 1e-6));
+  }
+
+  // As many threads as tracks give the same results
+  const vector<TriangulationResult> parallel =
+      triangulateSafe(cameras, tracks, refine, ParallelOptions(4, 1));
+  for (size_t j = 0; j < 5; ++j)
+    EXPECT(assert_equal(*refined[j], *parallel[j], 1e-9));
+}
+
+//******************************************************************************
+TEST( triangulation, batchChecks) {
+  using namespace batch;
+  const CameraSet<Camera> cameras = batch::cameras();
+  vector<TriangulationTrack<Camera> > tracks = batch::tracks();
+
+  // A track seen once, and one seen twice by the same camera
+  tracks.push_back({{0, z1}});
+  tracks.push_back({{1, z2}, {1, z2}});
+  vector<TriangulationResult> actual =
+      triangulateSafe(cameras, tracks, TriangulationParameters());
+  EXPECT(actual[5].degenerate());
+  EXPECT(actual[6].degenerate());
+
+  // Far points, and outliers
+  actual = triangulateSafe(cameras, tracks, TriangulationParameters(1.0, false, 6.5));
+  EXPECT(actual[0].valid());
+  EXPECT(actual[4].farPoint());
+  tracks[0][2].second += Point2(10, -10);
+  actual = triangulateSafe(cameras, tracks, TriangulationParameters(1.0, false, -1, 5));
+  EXPECT(actual[0].outlier());
+  EXPECT(actual[1].valid());
+}
+
 //******************************************************************************
 int main() {
   TestResult tr;
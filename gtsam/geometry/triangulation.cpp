@@ -62,6 +62,31 @@ Point3 triangulateDLT(const std::vector<Matrix34, Eigen::aligned_allocator<Matri
   return Point3(v.head<3>() / v[3]);
 }
 
+namespace internal {
+
+// The eigenvector of A'A is accurate to about the machine precision divided
+// by this ratio of its third to its largest eigenvalue
+static const double kMinimumConditioning = 1e-8;
+
+boost::optional<Vector4> triangulateHomogeneousDLTNormal(const Matrix4& AtA,
+    double rank_tol) {
+
+  // Eigenvalues in increasing order, the squared singular values of A
+  Eigen::SelfAdjointEigenSolver<Matrix4> eigen(AtA);
+  if (eigen.info() != Eigen::Success)
+    return boost::none;
+  const Vector4& lambda = eigen.eigenvalues();
+
+  // Rank 3 by a clear margin, and a well separated null space
+  if (lambda(1) <= 4 * rank_tol * rank_tol
+      || lambda(1) < kMinimumConditioning * lambda(3))
+    return boost::none;
+
+  return Vector4(eigen.eigenvectors().col(0));
+}
+
+}  // namespace internal
+
 ///
 /**
  * Optimize for triangulation
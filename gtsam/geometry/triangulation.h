@@ -26,6 +26,10 @@
 #include <gtsam/slam/TriangulationFactor.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/inference/Symbol.h>
+#include <gtsam/base/ThreadPool.h>
+
+#include <utility>
+#include <vector>
 
 namespace gtsam {
 
@@ -496,6 +500,184 @@ TriangulationResult triangulateSafe(const CameraSet<CAMERA>& cameras,
     }
 }
 
+/**
+ * The measurements of one landmark in a shared CameraSet, as pairs of the
+ * index of a camera and the measurement in that camera
+ */
+template<class CAMERA>
+using TriangulationTrack = std::vector<std::pair<size_t, typename CAMERA::Measurement> >;
+
+namespace internal {
+
+/**
+ * DLT triangulation from the 4x4 normal equations A'A of the DLT system, by
+ * the eigenvector of its smallest eigenvalue. The eigenvalues are the squared
+ * singular values of A, so half of the precision is lost. Returns boost::none
+ * unless the third singular value of A is well above rank_tol and the
+ * eigenvector is accurate; callers then use triangulateDLT instead.
+ */
+GTSAM_EXPORT boost::optional<Vector4> triangulateHomogeneousDLTNormal(
+    const Matrix4& AtA, double rank_tol);
+
+/**
+ * Refine a triangulated point by Gauss-Newton on its reprojection errors,
+ * stopping when the error no longer decreases.
+ * @param cameras the shared set of cameras
+ * @param track the measurements of the point in cameras
+ * @param initialEstimate e.g. from the DLT
+ * @param maxIterations the maximum number of Gauss-Newton steps
+ * @return refined Point3
+ */
+template<class CAMERA>
+Point3 refineTriangulation(const CameraSet<CAMERA>& cameras,
+    const TriangulationTrack<CAMERA>& track, const Point3& initialEstimate,
+    size_t maxIterations = 10) {
+  Point3 point = initialEstimate, previous = initialEstimate;
+  double previousError = std::numeric_limits<double>::infinity();
+  for (size_t iteration = 0;; ++iteration) {
+    // Normal equations of the linearized reprojection errors
+    Matrix3 H = Matrix3::Zero();
+    Vector3 g = Vector3::Zero();
+    double error = 0.0;
+    for (const auto& measurement : track) {
+      Eigen::Matrix<double, 2, 3> J;
+      const Vector2 e = measurement.second
+          - cameras.at(measurement.first).project2(point, boost::none, J);
+      H.noalias() += J.transpose() * J;
+      g.noalias() += J.transpose() * e;
+      error += e.squaredNorm();
+    }
+    if (error >= previousError) // no more progress, keep the best point
+      return previous;
+    if (iteration == maxIterations)
+      return point;
+
+    const Vector3 delta = H.ldlt().solve(g);
+    previous = point;
+    previousError = error;
+    point += delta;
+    if (delta.norm() <= 1e-10 * (1.0 + point.norm()))
+      return point;
+  }
+}
+
+/// Triangulate one track of triangulateSafe on many tracks
+template<class CAMERA>
+TriangulationResult triangulateTrack(const CameraSet<CAMERA>& cameras,
+    const std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> >& projections,
+    const TriangulationTrack<CAMERA>& track, const TriangulationParameters& params) {
+
+  // if we have a single measurement the track is uninformative
+  if (track.size() < 2)
+    return TriangulationResult::Degenerate();
+
+  try {
+    // Accumulate the normal equations of the DLT system A*v = 0
+    Matrix4 AtA = Matrix4::Zero();
+    for (const auto& measurement : track) {
+      const Matrix34& projection = projections.at(measurement.first);
+      const Point2& p = measurement.second;
+      Eigen::Matrix<double, 2, 4> A;
+      A.row(0) = p.x() * projection.row(2) - projection.row(0);
+      A.row(1) = p.y() * projection.row(2) - projection.row(1);
+      AtA.noalias() += A.transpose() * A;
+    }
+
+    // Triangulate linearly, falling back to the SVD of A if needed
+    Point3 point;
+    if (boost::optional<Vector4> v =
+            triangulateHomogeneousDLTNormal(AtA, params.rankTolerance)) {
+      point = v->head<3>() / (*v)[3];
+    } else {
+      std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> > trackProjections;
+      Point2Vector measured;
+      trackProjections.reserve(track.size());
+      measured.reserve(track.size());
+      for (const auto& measurement : track) {
+        trackProjections.push_back(projections.at(measurement.first));
+        measured.push_back(measurement.second);
+      }
+      point = triangulateDLT(trackProjections, measured, params.rankTolerance);
+    }
+
+    // Then refine using non-linear optimization
+    if (params.enableEPI)
+      point = refineTriangulation(cameras, track, point);
+
+    // Check landmark distance and re-projection errors, as triangulateSafe does
+    double maxReprojError = 0.0;
+    for (const auto& measurement : track) {
+      const CAMERA& camera = cameras.at(measurement.first);
+      const Pose3& pose = camera.pose();
+      if (params.landmarkDistanceThreshold > 0
+          && distance3(pose.translation(), point)
+              > params.landmarkDistanceThreshold)
+        return TriangulationResult::FarPoint();
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+      // verify that the triangulated point lies in front of all cameras
+      const Point3& p_local = pose.transformTo(point);
+      if (p_local.z() <= 0)
+        return TriangulationResult::BehindCamera();
+#endif
+      if (params.dynamicOutlierRejectionThreshold > 0) {
+        Point2 reprojectionError(camera.project(point) - measurement.second);
+        maxReprojError = std::max(maxReprojError, reprojectionError.norm());
+      }
+    }
+    if (params.dynamicOutlierRejectionThreshold > 0
+        && maxReprojError > params.dynamicOutlierRejectionThreshold)
+      return TriangulationResult::Outlier();
+
+    return TriangulationResult(point);
+  } catch (TriangulationUnderconstrainedException&) {
+    // rotation-only, parallel cameras, or motion towards the landmark
+    return TriangulationResult::Degenerate();
+  } catch (CheiralityException&) {
+    // point is behind one of the cameras while refining or checking it
+    return TriangulationResult::BehindCamera();
+  }
+}
+
+}  // namespace internal
+
+/**
+ * Triangulate many landmarks seen in a shared set of cameras, with the checks
+ * of triangulateSafe. The projection matrices of the cameras are computed
+ * once, then the tracks are triangulated in parallel. The DLT is solved from
+ * its 4x4 normal equations where that is accurate, and by SVD otherwise.
+ * With params.enableEPI each point is refined by a few Gauss-Newton steps on
+ * its reprojection errors, rather than by optimizing a factor graph with
+ * Levenberg-Marquardt, so refined points may differ from those of
+ * triangulateSafe within the tolerance of that optimization.
+ * @param cameras pinhole cameras shared by all tracks
+ * @param tracks for every landmark its measurements in cameras
+ * @param params the triangulation parameters, as for triangulateSafe
+ * @param parallel how to split the tracks across threads
+ * @return a TriangulationResult for every track
+ */
+template<class CAMERA>
+std::vector<TriangulationResult> triangulateSafe(const CameraSet<CAMERA>& cameras,
+    const std::vector<TriangulationTrack<CAMERA> >& tracks,
+    const TriangulationParameters& params,
+    const ParallelOptions& parallel = ParallelOptions()) {
+
+  // Projection matrices of all cameras
+  typedef CameraProjectionMatrix<typename CAMERA::CalibrationType> ProjectionMatrix;
+  std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> > projections(cameras.size());
+  parallelFor(0, cameras.size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      projections[i] = ProjectionMatrix(cameras[i].calibration())(cameras[i].pose());
+  }, parallel.resolved(cameras.size(), 64));
+
+  // Triangulate the tracks, a few dozen at a time
+  std::vector<TriangulationResult> results(tracks.size());
+  parallelFor(0, tracks.size(), [&](size_t first, size_t last) {
+    for (size_t j = first; j < last; ++j)
+      results[j] = internal::triangulateTrack(cameras, projections, tracks[j], params);
+  }, parallel.resolved(tracks.size(), 32));
+  return results;
+}
+
 // Vector of Cameras - used by the Python/MATLAB wrapper
 using CameraSetCal3Bundler = CameraSet<PinholeCamera<Cal3Bundler>>;
 using CameraSetCal3_S2 = CameraSet<PinholeCamera<Cal3_S2>>;
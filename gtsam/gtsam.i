@@ -2259,6 +2259,7 @@ virtual class NonlinearOptimizerParams {
   bool isMultifrontal() const;
   bool isSequential() const;
   bool isCholmod() const;
+  bool isSchurComplement() const;
   bool isIterative() const;
 };
 
@@ -232,7 +232,7 @@ EliminatableClusterTree<BAYESTREE, GRAPH>::eliminate(const Eliminate& function)
   {
     TbbOpenMPMixedScope threadLimiter;  // Limits OpenMP threads since we're mixing TBB and OpenMP
     treeTraversal::DepthFirstForestParallel(*this, rootsContainer, Data::EliminationPreOrderVisitor,
-                                            visitorPost, 10);
+                                            visitorPost);
   }
 
   // Create BayesTree from roots stored in the dummy BayesTree node.
@@ -0,0 +1,70 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    FactorKeysSignature.h
+ * @brief   The keys of every factor of a graph, to detect structure changes
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/linear/GaussianFactorGraph.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * The keys of every factor of a GaussianFactorGraph, in factor order, with no
+ * keys for null factors.  The solvers that cache symbolic work record the
+ * signature of the graph they analyzed, and reuse the analysis for any later
+ * graph that matches it, i.e. has the same factor keys in the same order.
+ */
+class FactorKeysSignature {
+  std::vector<KeyVector> factorKeys_;
+
+ public:
+  /// Empty signature, which only matches the empty graph
+  FactorKeysSignature() {}
+
+  /// Record the signature of gfg
+  explicit FactorKeysSignature(const GaussianFactorGraph& gfg) { record(gfg); }
+
+  /// Replace the signature by the one of gfg
+  void record(const GaussianFactorGraph& gfg) {
+    factorKeys_.clear();
+    factorKeys_.reserve(gfg.size());
+    for (const auto& factor : gfg)
+      factorKeys_.push_back(factor ? factor->keys() : KeyVector());
+  }
+
+  /// Check whether gfg has the same factor keys in the same order
+  bool matches(const GaussianFactorGraph& gfg) const {
+    if (gfg.size() != factorKeys_.size()) return false;
+    for (size_t f = 0; f < gfg.size(); ++f) {
+      if (gfg[f]) {
+        if (gfg[f]->keys() != factorKeys_[f]) return false;
+      } else if (!factorKeys_[f].empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Number of factors recorded
+  size_t size() const { return factorKeys_.size(); }
+
+  /// The keys of factor f
+  const KeyVector& operator[](size_t f) const { return factorKeys_[f]; }
+};
+
+}  // namespace gtsam
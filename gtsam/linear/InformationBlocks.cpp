@@ -0,0 +1,63 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    InformationBlocks.cpp
+ * @brief   Blocks of the information matrix of a Gaussian factor, read in place
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/linear/InformationBlocks.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+InformationBlocks::InformationBlocks(const GaussianFactor& factor)
+    : jacobian_(dynamic_cast<const JacobianFactor*>(&factor)),
+      hessian_(dynamic_cast<const HessianFactor*>(&factor)) {
+  if (jacobian_ && jacobian_->isConstrained())
+    throw invalid_argument(
+        "InformationBlocks: constrained noise models are not supported, "
+        "use a QR-based linear solver instead");
+  if (jacobian_ && jacobian_->get_model() && !jacobian_->get_model()->isUnit())
+    jacobian_ = nullptr;
+  if (!jacobian_ && !hessian_) {
+    augmented_ = factor.augmentedInformation();
+    offsets_.push_back(0);
+    for (auto it = factor.begin(); it != factor.end(); ++it)
+      offsets_.push_back(offsets_.back() + factor.getDim(it));
+    offsets_.push_back(offsets_.back() + 1);
+  }
+}
+
+/* ************************************************************************* */
+void InformationBlocks::add(size_t a, size_t b, Eigen::Ref<Matrix> dst) const {
+  if (jacobian_) {
+    const auto Aa = jacobian_->getA(jacobian_->begin() + a);
+    if (b == jacobian_->size())
+      dst.noalias() += Aa.transpose() * jacobian_->getb();
+    else
+      dst.noalias() += Aa.transpose() * jacobian_->getA(jacobian_->begin() + b);
+  } else if (hessian_) {
+    dst += hessian_->info().block(a, b);
+  } else {
+    dst += augmented_.block(offsets_[a], offsets_[b], offsets_[a + 1] - offsets_[a],
+                            offsets_[b + 1] - offsets_[b]);
+  }
+}
+
+}  // namespace gtsam
@@ -0,0 +1,57 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    InformationBlocks.h
+ * @brief   Blocks of the information matrix of a Gaussian factor, read in place
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+#include <gtsam/dllexport.h>
+
+#include <vector>
+
+namespace gtsam {
+
+// Forward declarations
+class GaussianFactor;
+class HessianFactor;
+class JacobianFactor;
+
+/**
+ * The blocks of the augmented information matrix [A b]'[A b] of a whitened
+ * GaussianFactor, for the solvers that assemble normal equations.  Jacobian
+ * factors with no or a unit noise model, as linearized nonlinear factors are,
+ * and Hessian factors are read in place; other factors are converted to their
+ * augmented information matrix once.
+ *
+ * Factors with constrained noise models have no finite information matrix and
+ * are rejected with std::invalid_argument.
+ */
+class GTSAM_EXPORT InformationBlocks {
+  const JacobianFactor* jacobian_;
+  const HessianFactor* hessian_;
+  Matrix augmented_;
+  std::vector<size_t> offsets_;
+
+ public:
+  /// Blocks of factor, which has to outlive this object
+  explicit InformationBlocks(const GaussianFactor& factor);
+
+  /// dst += block (a, b), where a and b index the keys of the factor and
+  /// b = size() of the factor selects the information vector A'b
+  void add(size_t a, size_t b, Eigen::Ref<Matrix> dst) const;
+};
+
+}  // namespace gtsam
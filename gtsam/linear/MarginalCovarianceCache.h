@@ -0,0 +1,203 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MarginalCovarianceCache.h
+ * @brief   Marginal covariances of a Gaussian Bayes tree, cached per clique
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/linear/GaussianConditional.h>
+#include <gtsam/inference/BayesTree.h>
+#include <gtsam/base/FastMap.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Recovers marginal covariances from a Bayes tree of GaussianConditionals, and
+ * caches the covariance of every clique it visits.
+ *
+ * The covariance of a clique, over its frontal and separator variables, follows
+ * from its conditional R x_F + S x_S = d and the covariance of the separator,
+ * which is part of the covariance of the parent clique (Kaess and Dellaert,
+ * "Covariance recovery from a square root information matrix for data
+ * association", RAS 2009):
+ *   Sigma_FS = -R^-1 S Sigma_SS
+ *   Sigma_FF = R^-1 R^-T - Sigma_FS S^T R^-T
+ * so a query only computes the dense clique blocks on the path from the root
+ * to the clique of the variable, and queries sharing ancestors share them.
+ *
+ * Entries stay valid as long as the clique, its conditional, its parent and the
+ * entries above it are unchanged, which is checked on every query.  As ISAM2
+ * creates new cliques for the top of the tree it re-eliminates and relinks the
+ * subtrees it keeps, only the cliques below a change are recomputed.
+ *
+ * Queries lock the cache, so const members of ISAM2, Marginals or a snapshot
+ * may be called from several threads; they are answered one at a time.  Copies
+ * start empty, as a cache only refers to the cliques of its own Bayes tree.
+ */
+template <class CLIQUE>
+class MarginalCovarianceCache {
+ public:
+  typedef CLIQUE Clique;
+  typedef boost::shared_ptr<Clique> sharedClique;
+  typedef BayesTree<Clique> BayesTreeType;
+
+ private:
+  /// The covariance of a clique, and what it was computed from
+  struct Entry {
+    boost::weak_ptr<Clique> clique;
+    boost::weak_ptr<Clique> parent;
+    GaussianConditional::shared_ptr conditional;
+    FastMap<Key, std::pair<size_t, size_t> > blocks;  ///< Offset and dimension of every key
+    Matrix covariance;  ///< Over the frontal, then the separator variables
+  };
+
+  std::unordered_map<const Clique*, Entry> entries_;
+  size_t pruneSize_ = 64;  ///< Drop entries of deleted cliques above this size
+  mutable std::mutex mutex_;
+
+ public:
+  MarginalCovarianceCache() {}
+
+  /// Copies start empty
+  MarginalCovarianceCache(const MarginalCovarianceCache&) {}
+
+  /// Assigning drops the cached cliques
+  MarginalCovarianceCache& operator=(const MarginalCovarianceCache&) {
+    clear();
+    return *this;
+  }
+
+  /// The marginal covariance of a single variable
+  Matrix marginalCovariance(const BayesTreeType& bayesTree, Key key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry& entry = cliqueEntry(bayesTree.clique(key));
+    const std::pair<size_t, size_t>& block = entry.blocks.at(key);
+    return entry.covariance.block(block.first, block.first, block.second, block.second);
+  }
+
+  /// The marginal covariances of several variables, sharing the cliques they
+  /// have in common on their path to the root
+  FastMap<Key, Matrix> marginalCovariances(const BayesTreeType& bayesTree,
+                                           const KeyVector& keys) {
+    FastMap<Key, Matrix> covariances;
+    for (Key key : keys) covariances.emplace(key, marginalCovariance(bayesTree, key));
+    return covariances;
+  }
+
+  /// Number of cached cliques
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  /// Drop all cached cliques
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    pruneSize_ = 64;
+  }
+
+ private:
+  /// The entry of a clique, after updating the entries on its path to the root
+  const Entry& cliqueEntry(const sharedClique& clique) {
+    std::vector<sharedClique> path;
+    for (sharedClique c = clique; c; c = c->parent()) path.push_back(c);
+
+    const Entry* parentEntry = nullptr;
+    bool valid = true;
+    for (auto c = path.rbegin(); c != path.rend(); ++c) {
+      Entry& entry = entries_[c->get()];
+      const sharedClique parent = (*c)->parent();
+      valid = valid && entry.clique.lock() == *c && entry.parent.lock() == parent &&
+              entry.conditional == (*c)->conditional();
+      if (!valid) {
+        entry.clique = *c;
+        entry.parent = parent;
+        entry.conditional = (*c)->conditional();
+        compute(*entry.conditional, parentEntry, &entry);
+      }
+      parentEntry = &entry;
+    }
+    if (entries_.size() > pruneSize_) prune();
+    return entries_.at(clique.get());
+  }
+
+  /// Compute the covariance of a clique from the covariance of its parent
+  static void compute(const GaussianConditional& conditional, const Entry* parentEntry,
+                      Entry* entry) {
+    entry->blocks.clear();
+    size_t offset = 0;
+    for (auto key = conditional.begin(); key != conditional.end(); ++key) {
+      const size_t dim = conditional.getDim(key);
+      entry->blocks.emplace(*key, std::make_pair(offset, dim));
+      offset += dim;
+    }
+
+    Matrix R = conditional.R(), S = conditional.S();
+    if (conditional.get_model()) {
+      R = conditional.get_model()->Whiten(R);
+      if (S.cols() > 0) S = conditional.get_model()->Whiten(S);
+    }
+    const size_t nf = R.cols(), ns = S.cols();
+    const auto Rt = R.triangularView<Eigen::Upper>();
+    const Matrix Rinv = Rt.solve(Matrix::Identity(nf, nf));
+
+    Matrix& covariance = entry->covariance;
+    covariance.resize(nf + ns, nf + ns);
+    covariance.topLeftCorner(nf, nf).noalias() = Rinv * Rinv.transpose();
+    if (ns == 0) return;
+
+    // Gather the separator covariance from the parent clique
+    const auto parents = conditional.parents();
+    for (auto i = parents.begin(); i != parents.end(); ++i) {
+      const std::pair<size_t, size_t>& bi = entry->blocks.at(*i);
+      const std::pair<size_t, size_t>& pi = parentEntry->blocks.at(*i);
+      for (auto j = parents.begin(); j != parents.end(); ++j) {
+        const std::pair<size_t, size_t>& bj = entry->blocks.at(*j);
+        const std::pair<size_t, size_t>& pj = parentEntry->blocks.at(*j);
+        covariance.block(bi.first, bj.first, bi.second, bj.second) =
+            parentEntry->covariance.block(pi.first, pj.first, pi.second, pj.second);
+      }
+    }
+
+    const Matrix K = Rt.solve(S);
+    const Matrix Sfs = -K * covariance.bottomRightCorner(ns, ns);
+    covariance.topLeftCorner(nf, nf).noalias() -= Sfs * K.transpose();
+    covariance.topRightCorner(nf, ns) = Sfs;
+    covariance.bottomLeftCorner(ns, nf) = Sfs.transpose();
+  }
+
+  /// Drop the entries of cliques that no longer exist
+  void prune() {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->second.clique.expired())
+        it = entries_.erase(it);
+      else
+        ++it;
+    }
+    pruneSize_ = std::max<size_t>(64, 2 * entries_.size());
+  }
+};
+
+}  // namespace gtsam
@@ -0,0 +1,144 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MultifrontalSolver.cpp
+ * @brief   Multifrontal solver for Gaussian factor graphs that caches the junction tree
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/linear/MultifrontalSolver.h>
+#include <gtsam/linear/GaussianEliminationTree.h>
+#include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/inferenceExceptions.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/make_shared.hpp>
+
+#include <deque>
+#include <unordered_map>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+boost::shared_ptr<GaussianBayesTree> MultifrontalSolver::eliminate(
+    const GaussianFactorGraph& gfg, const Ordering& ordering,
+    const GaussianFactorGraph::Eliminate& function) {
+  if (!analyzed_ || ordering != ordering_ || !sameStructure(gfg))
+    analyze(gfg, ordering);
+  return eliminateCached(gfg, function);
+}
+
+/* ************************************************************************* */
+boost::shared_ptr<GaussianBayesTree> MultifrontalSolver::eliminate(
+    const GaussianFactorGraph& gfg, Ordering::OrderingType orderingType,
+    const GaussianFactorGraph::Eliminate& function) {
+  if (!analyzed_ || orderingType_ != orderingType || !sameStructure(gfg)) {
+    analyze(gfg, Ordering::Create(orderingType, gfg));
+    orderingType_ = orderingType;
+  }
+  return eliminateCached(gfg, function);
+}
+
+/* ************************************************************************* */
+VectorValues MultifrontalSolver::optimize(const GaussianFactorGraph& gfg,
+                                          const Ordering& ordering,
+                                          const GaussianFactorGraph::Eliminate& function) {
+  return eliminate(gfg, ordering, function)->optimize();
+}
+
+/* ************************************************************************* */
+VectorValues MultifrontalSolver::optimize(const GaussianFactorGraph& gfg,
+                                          Ordering::OrderingType orderingType,
+                                          const GaussianFactorGraph::Eliminate& function) {
+  return eliminate(gfg, orderingType, function)->optimize();
+}
+
+/* ************************************************************************* */
+void MultifrontalSolver::analyze(const GaussianFactorGraph& gfg, const Ordering& ordering) {
+  gttic(MultifrontalSolver_analyze);
+  invalidate();
+
+  // Record factor structure
+  ordering_ = ordering;
+  signature_.record(gfg);
+
+  // Build the trees exactly as eliminateMultifrontal does
+  const VariableIndex variableIndex(gfg);
+  const GaussianEliminationTree etree(gfg, variableIndex, ordering);
+  junctionTree_ = boost::make_shared<GaussianJunctionTree>(etree);
+
+  // Factors left out of the tree have keys missing in the ordering
+  if (!junctionTree_->remainingFactors().empty()) {
+    invalidate();
+    throw InconsistentEliminationRequested();
+  }
+
+  // The clusters hold the factors of gfg, look up their indices. A factor can
+  // appear more than once in a graph, so its indices are used in order.
+  unordered_map<const GaussianFactor*, deque<size_t> > indicesOf;
+  for (size_t f = 0; f < gfg.size(); ++f)
+    if (gfg[f]) indicesOf[gfg[f].get()].push_back(f);
+
+  vector<sharedCluster> stack(junctionTree_->roots().begin(), junctionTree_->roots().end());
+  while (!stack.empty()) {
+    sharedCluster cluster = stack.back();
+    stack.pop_back();
+    vector<size_t> indices;
+    indices.reserve(cluster->factors.size());
+    for (const auto& factor : cluster->factors) {
+      deque<size_t>& candidates = indicesOf.at(factor.get());
+      indices.push_back(candidates.front());
+      candidates.pop_front();
+    }
+    // Do not keep the factors of gfg alive
+    for (auto& factor : cluster->factors) factor.reset();
+    clusterFactors_.emplace_back(cluster, move(indices));
+    stack.insert(stack.end(), cluster->children.begin(), cluster->children.end());
+  }
+  analyzed_ = true;
+}
+
+/* ************************************************************************* */
+boost::shared_ptr<GaussianBayesTree> MultifrontalSolver::eliminateCached(
+    const GaussianFactorGraph& gfg, const GaussianFactorGraph::Eliminate& function) {
+  gttic(MultifrontalSolver_eliminate);
+
+  // Put the factors of gfg into the clusters they were assigned to
+  for (auto& cluster_indices : clusterFactors_) {
+    GaussianFactorGraph& factors = cluster_indices.first->factors;
+    const vector<size_t>& indices = cluster_indices.second;
+    for (size_t k = 0; k < indices.size(); ++k) factors[k] = gfg[indices[k]];
+  }
+
+  // Release the factors again afterwards, so that the caller can reuse them
+  auto releaseFactors = [this]() {
+    for (auto& cluster_indices : clusterFactors_)
+      for (auto& factor : cluster_indices.first->factors) factor.reset();
+  };
+  std::pair<boost::shared_ptr<GaussianBayesTree>, boost::shared_ptr<GaussianFactorGraph> > result;
+  try {
+    result = junctionTree_->eliminate(function);
+  } catch (...) {
+    releaseFactors();
+    throw;
+  }
+  releaseFactors();
+
+  // If any factors are remaining, the ordering was incomplete
+  if (!result.second->empty())
+    throw InconsistentEliminationRequested();
+  return result.first;
+}
+
+}  // namespace gtsam
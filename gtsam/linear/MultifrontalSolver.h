@@ -0,0 +1,118 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MultifrontalSolver.h
+ * @brief   Multifrontal solver for Gaussian factor graphs that caches the junction tree
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/linear/FactorKeysSignature.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/GaussianJunctionTree.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Solves a GaussianFactorGraph by multifrontal elimination, like
+ * GaussianFactorGraph::optimize, while caching the symbolic work across calls.
+ * This is the solver behind the MULTIFRONTAL_* linear solvers of the
+ * nonlinear optimizers.
+ *
+ * The ordering, VariableIndex, elimination tree and junction tree only depend
+ * on the graph structure, so they are built once and reused as long as
+ * subsequent graphs have the same factor keys in the same order. For such a
+ * graph only the factors of every cluster are replaced before the numeric
+ * elimination, which gives exactly the same result as eliminating from scratch.
+ */
+class GTSAM_EXPORT MultifrontalSolver {
+ public:
+  typedef boost::shared_ptr<MultifrontalSolver> shared_ptr;
+
+ private:
+  typedef GaussianJunctionTree::sharedNode sharedCluster;
+  typedef EliminationTraits<GaussianFactorGraph> EliminationTraitsType;
+
+  Ordering ordering_;  ///< Elimination ordering the junction tree was built for
+
+  /// Type ordering_ was computed with, if it was not given explicitly
+  boost::optional<Ordering::OrderingType> orderingType_;
+
+  /// Factor keys of the graph the structure was built for, to detect changes
+  FactorKeysSignature signature_;
+
+  /// The cached junction tree, whose clusters hold no factors between calls
+  boost::shared_ptr<GaussianJunctionTree> junctionTree_;
+
+  /// Every cluster with the indices in the graph of its factors
+  std::vector<std::pair<sharedCluster, std::vector<size_t> > > clusterFactors_;
+
+  bool analyzed_ = false;  ///< True if the cache above is valid
+
+ public:
+  /// Default constructor, structure is built on first call to eliminate
+  MultifrontalSolver() {}
+
+  /// Eliminate using the given ordering, rebuilding the junction tree only if
+  /// the graph structure or the ordering changed since the last call.
+  boost::shared_ptr<GaussianBayesTree> eliminate(
+      const GaussianFactorGraph& gfg, const Ordering& ordering,
+      const GaussianFactorGraph::Eliminate& function = EliminationTraitsType::DefaultEliminate);
+
+  /// Eliminate using an ordering of the given type, which is only computed
+  /// when the graph structure or the ordering type changed since the last call.
+  boost::shared_ptr<GaussianBayesTree> eliminate(
+      const GaussianFactorGraph& gfg, Ordering::OrderingType orderingType = Ordering::COLAMD,
+      const GaussianFactorGraph::Eliminate& function = EliminationTraitsType::DefaultEliminate);
+
+  /// Solve using the given ordering, see eliminate
+  VectorValues optimize(
+      const GaussianFactorGraph& gfg, const Ordering& ordering,
+      const GaussianFactorGraph::Eliminate& function = EliminationTraitsType::DefaultEliminate);
+
+  /// Solve using an ordering of the given type, see eliminate
+  VectorValues optimize(
+      const GaussianFactorGraph& gfg, Ordering::OrderingType orderingType = Ordering::COLAMD,
+      const GaussianFactorGraph::Eliminate& function = EliminationTraitsType::DefaultEliminate);
+
+  /// Check whether the cached symbolic structure can be reused for gfg
+  bool sameStructure(const GaussianFactorGraph& gfg) const { return signature_.matches(gfg); }
+
+  /// Forget the cached structure, the next call will rebuild the junction tree
+  void invalidate() {
+    analyzed_ = false;
+    orderingType_ = boost::none;
+    junctionTree_.reset();
+    clusterFactors_.clear();
+  }
+
+  /// The elimination ordering of the cached structure
+  const Ordering& ordering() const { return ordering_; }
+
+ private:
+  /// Build the elimination and junction trees, and record the factors of every cluster
+  void analyze(const GaussianFactorGraph& gfg, const Ordering& ordering);
+
+  /// Numeric elimination of the cached junction tree with the factors of gfg
+  boost::shared_ptr<GaussianBayesTree> eliminateCached(
+      const GaussianFactorGraph& gfg, const GaussianFactorGraph::Eliminate& function);
+};
+
+}  // namespace gtsam
@@ -39,6 +39,13 @@ void PCGSolverParameters::print(ostream &os) const {
   preconditioner_->print(os);
 }
 
+/*****************************************************************************/
+void SchurPCGSolverParameters::print(ostream &os) const {
+  Base::print(os);
+  os << "SchurPCGSolverParameters:" << endl
+     << "nrThreads:     " << parallel.nrThreads << endl;
+}
+
 /*****************************************************************************/
 PCGSolver::PCGSolver(const PCGSolverParameters &p) {
   parameters_ = p;
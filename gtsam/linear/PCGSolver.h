@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <gtsam/base/ThreadPool.h>
 #include <gtsam/linear/ConjugateGradientSolver.h>
 #include <string>
 
@@ -56,6 +57,28 @@ public:
   void setPreconditionerParams(const boost::shared_ptr<PreconditionerParameters> preconditioner);
 };
 
+/**
+ * Parameters for a PCG solver specialized to the implicit Schur complement of
+ * bundle adjustment, see SchurPCGSolver in gtsam/slam, which works on the
+ * camera parameters in one contiguous vector instead of VectorValues.  Those
+ * solvers depend on the camera type, so the parameters for a camera type
+ * solve() with its solver, which NonlinearOptimizer calls when they are its
+ * iterativeParams.
+ */
+struct GTSAM_EXPORT SchurPCGSolverParameters: public ConjugateGradientParameters {
+public:
+  typedef ConjugateGradientParameters Base;
+  typedef boost::shared_ptr<SchurPCGSolverParameters> shared_ptr;
+
+  /// Threads for setting up the system and multiplying with it
+  ParallelOptions parallel;
+
+  void print(std::ostream &os) const override;
+
+  /// Solve gfg with the solver these parameters are for
+  virtual VectorValues solve(const GaussianFactorGraph &gfg) const = 0;
+};
+
 /**
  * A virtual base class for the preconditioned conjugate gradient solver
  */
@@ -0,0 +1,348 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SchurComplementSolver.cpp
+ * @brief   Solves bundle adjustment systems by eliminating landmarks in closed form
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/linear/SchurComplementSolver.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/InformationBlocks.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/base/FastMap.h>
+#include <gtsam/base/timing.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+const size_t kNone = numeric_limits<size_t>::max();
+
+typedef Eigen::Map<Matrix, 0, Eigen::OuterStride<> > BlockMap;
+}  // namespace
+
+/* ************************************************************************* */
+VectorValues SchurComplementSolver::optimize(const GaussianFactorGraph& gfg) {
+  if (!analyzed_ || !sameStructure(gfg)) analyze(gfg);
+  eliminateLandmarks(gfg);
+  assemble(gfg);
+  return factorizeAndSolve();
+}
+
+/* ************************************************************************* */
+void SchurComplementSolver::analyze(const GaussianFactorGraph& gfg) {
+  gttic(SchurComplement_analyze);
+
+  // Variables in key order, split into cameras and landmarks
+  FastMap<Key, size_t> dims;
+  for (const auto& factor : gfg)
+    if (factor)
+      for (auto it = factor->begin(); it != factor->end(); ++it)
+        dims.emplace(*it, factor->getDim(it));
+  cameras_.clear();
+  landmarks_.clear();
+  dims_.clear();
+  FastMap<Key, size_t> cameraIndex, landmarkIndex;
+  for (const auto& key_dim : dims) {
+    const bool landmark = isLandmark_ ? isLandmark_(key_dim.first) : key_dim.second == 3;
+    if (landmark) {
+      if (key_dim.second != 3)
+        throw invalid_argument("SchurComplementSolver: landmarks need to be 3-dimensional");
+      landmarkIndex.emplace(key_dim.first, landmarks_.size());
+      landmarks_.push_back(key_dim.first);
+    } else {
+      cameraIndex.emplace(key_dim.first, cameras_.size());
+      cameras_.push_back(key_dim.first);
+      dims_.push_back(key_dim.second);
+    }
+  }
+  const size_t nrCameras = cameras_.size(), nrLandmarks = landmarks_.size();
+  columnOffsets_.assign(1, 0);
+  for (const size_t dim : dims_) columnOffsets_.push_back(columnOffsets_.back() + dim);
+
+  // Cameras and landmark of every factor
+  signature_.record(gfg);
+  factorSlots_.clear();
+  factorLandmark_.clear();
+  for (size_t f = 0; f < signature_.size(); ++f) {
+    vector<size_t> slots;
+    size_t landmark = kNone;
+    for (const Key key : signature_[f]) {
+      auto found = landmarkIndex.find(key);
+      if (found == landmarkIndex.end()) {
+        slots.push_back(cameraIndex.at(key));
+        continue;
+      }
+      if (landmark != kNone)
+        throw invalid_argument("SchurComplementSolver: a factor involves two landmarks");
+      landmark = found->second;
+      slots.push_back(kNone);
+    }
+    factorSlots_.push_back(std::move(slots));
+    factorLandmark_.push_back(landmark);
+  }
+  const size_t nrFactors = factorSlots_.size();
+
+  // Factors of every landmark
+  landmarkFactorStart_.assign(nrLandmarks + 1, 0);
+  for (const size_t l : factorLandmark_)
+    if (l != kNone) ++landmarkFactorStart_[l + 1];
+  for (size_t l = 0; l < nrLandmarks; ++l) landmarkFactorStart_[l + 1] += landmarkFactorStart_[l];
+  landmarkFactors_.resize(landmarkFactorStart_.back());
+  vector<size_t> next(landmarkFactorStart_.begin(), landmarkFactorStart_.end() - 1);
+  for (size_t f = 0; f < nrFactors; ++f)
+    if (factorLandmark_[f] != kNone) landmarkFactors_[next[factorLandmark_[f]]++] = f;
+
+  // Cameras of every landmark, and the pair of every key of its factors
+  pairStart_.assign(1, 0);
+  pairLandmark_.clear();
+  pairCamera_.clear();
+  pairOffset_.assign(1, 0);
+  factorPairs_.assign(nrFactors, vector<size_t>());
+  for (size_t l = 0; l < nrLandmarks; ++l) {
+    const size_t first = pairCamera_.size();
+    for (size_t i = landmarkFactorStart_[l]; i < landmarkFactorStart_[l + 1]; ++i)
+      for (const size_t c : factorSlots_[landmarkFactors_[i]])
+        if (c != kNone) pairCamera_.push_back(c);
+    sort(pairCamera_.begin() + first, pairCamera_.end());
+    pairCamera_.erase(unique(pairCamera_.begin() + first, pairCamera_.end()), pairCamera_.end());
+    for (size_t e = first; e < pairCamera_.size(); ++e) {
+      pairLandmark_.push_back(l);
+      pairOffset_.push_back(pairOffset_.back() + 3 * dims_[pairCamera_[e]]);
+    }
+    pairStart_.push_back(pairCamera_.size());
+    for (size_t i = landmarkFactorStart_[l]; i < landmarkFactorStart_[l + 1]; ++i) {
+      const size_t f = landmarkFactors_[i];
+      for (const size_t c : factorSlots_[f])
+        factorPairs_[f].push_back(
+            c == kNone ? kNone
+                       : lower_bound(pairCamera_.begin() + first, pairCamera_.end(), c) -
+                             pairCamera_.begin());
+    }
+  }
+
+  // Pairs and factors of every camera
+  cameraPairStart_.assign(nrCameras + 1, 0);
+  for (const size_t c : pairCamera_) ++cameraPairStart_[c + 1];
+  for (size_t c = 0; c < nrCameras; ++c) cameraPairStart_[c + 1] += cameraPairStart_[c];
+  cameraPairs_.resize(pairCamera_.size());
+  next.assign(cameraPairStart_.begin(), cameraPairStart_.end() - 1);
+  for (size_t e = 0; e < pairCamera_.size(); ++e) cameraPairs_[next[pairCamera_[e]]++] = e;
+
+  cameraFactorStart_.assign(nrCameras + 1, 0);
+  for (const auto& slots : factorSlots_)
+    for (const size_t c : slots)
+      if (c != kNone) ++cameraFactorStart_[c + 1];
+  for (size_t c = 0; c < nrCameras; ++c) cameraFactorStart_[c + 1] += cameraFactorStart_[c];
+  cameraFactors_.resize(cameraFactorStart_.back());
+  next.assign(cameraFactorStart_.begin(), cameraFactorStart_.end() - 1);
+  for (size_t f = 0; f < nrFactors; ++f)
+    for (size_t a = 0; a < factorSlots_[f].size(); ++a)
+      if (factorSlots_[f][a] != kNone)
+        cameraFactors_[next[factorSlots_[f][a]]++] = make_pair(f, a);
+
+  // Block sparsity pattern of the upper triangle: for every block column j
+  // the sorted block rows i <= j, the diagonal block last
+  blockRows_.assign(nrCameras, vector<size_t>());
+  for (size_t j = 0; j < nrCameras; ++j) blockRows_[j].push_back(j);
+  for (size_t l = 0; l < nrLandmarks; ++l)
+    for (size_t a = pairStart_[l]; a < pairStart_[l + 1]; ++a)
+      for (size_t b = a + 1; b < pairStart_[l + 1]; ++b)
+        blockRows_[pairCamera_[b]].push_back(pairCamera_[a]);
+  for (const auto& slots : factorSlots_)
+    for (const size_t i : slots)
+      for (const size_t j : slots)
+        if (i != kNone && j != kNone && i < j) blockRows_[j].push_back(i);
+
+  // Columns of a block column are dense and of the same height, diagonal
+  // blocks are stored in full and the factorization reads their upper half
+  rowOffsets_.assign(nrCameras, vector<size_t>());
+  heights_.assign(nrCameras, 0);
+  size_t nnz = 0;
+  for (size_t j = 0; j < nrCameras; ++j) {
+    vector<size_t>& rows = blockRows_[j];
+    sort(rows.begin(), rows.end());
+    rows.erase(unique(rows.begin(), rows.end()), rows.end());
+    for (const size_t i : rows) {
+      rowOffsets_[j].push_back(heights_[j]);
+      heights_[j] += dims_[i];
+    }
+    nnz += heights_[j] * dims_[j];
+  }
+
+  const size_t N = columnOffsets_.back();
+  reduced_.resize(N, N);
+  reduced_.resizeNonZeros(nnz);
+  int* outer = reduced_.outerIndexPtr();
+  int* inner = reduced_.innerIndexPtr();
+  int k = 0;
+  for (size_t j = 0; j < nrCameras; ++j) {
+    for (size_t c = 0; c < dims_[j]; ++c) {
+      outer[columnOffsets_[j] + c] = k;
+      for (const size_t i : blockRows_[j])
+        for (size_t r = 0; r < dims_[i]; ++r) inner[k++] = columnOffsets_[i] + r;
+    }
+  }
+  outer[N] = k;
+  std::fill(reduced_.valuePtr(), reduced_.valuePtr() + nnz, 0.0);
+
+  // Symbolic factorization, reused for every numeric refactorization
+  if (N > 0) factorization_.analyzePattern(reduced_);
+  analyzed_ = true;
+}
+
+/* ************************************************************************* */
+void SchurComplementSolver::eliminateLandmarks(const GaussianFactorGraph& gfg) {
+  gttic(SchurComplement_eliminate);
+  const size_t nrLandmarks = landmarks_.size();
+  pairData_.assign(pairOffset_.back(), 0.0);
+  landmarkInverse_.resize(nrLandmarks);
+  landmarkInformation_.resize(nrLandmarks);
+  vector<char> failed(nrLandmarks, 0);
+
+  parallelFor(0, nrLandmarks, [&](size_t first, size_t last) {
+    for (size_t l = first; l < last; ++l) {
+      Matrix3 Hpp = Matrix3::Zero();
+      Vector3 gp = Vector3::Zero();
+      for (size_t i = landmarkFactorStart_[l]; i < landmarkFactorStart_[l + 1]; ++i) {
+        const size_t f = landmarkFactors_[i];
+        const vector<size_t>& slots = factorSlots_[f];
+        const InformationBlocks information(*gfg[f]);
+        const size_t p = find(slots.begin(), slots.end(), kNone) - slots.begin();
+        information.add(p, p, Hpp);
+        information.add(p, slots.size(), gp);
+        for (size_t a = 0; a < slots.size(); ++a) {
+          if (a == p) continue;
+          const size_t e = factorPairs_[f][a], dim = dims_[slots[a]];
+          information.add(a, p, BlockMap(pairData_.data() + pairOffset_[e], dim, 3,
+                                         Eigen::OuterStride<>(dim)));
+        }
+      }
+      const Eigen::LLT<Matrix3> llt(Hpp);
+      if (llt.info() != Eigen::Success) {
+        failed[l] = 1;
+        continue;
+      }
+      landmarkInverse_[l] = llt.solve(I_3x3);
+      landmarkInformation_[l] = gp;
+    }
+  }, parallel_.resolved(nrLandmarks, 64));
+
+  for (size_t l = 0; l < nrLandmarks; ++l)
+    if (failed[l]) throw IndeterminantLinearSystemException(landmarks_[l]);
+}
+
+/* ************************************************************************* */
+void SchurComplementSolver::assemble(const GaussianFactorGraph& gfg) {
+  gttic(SchurComplement_assemble);
+  const size_t nrCameras = cameras_.size();
+  double* values = reduced_.valuePtr();
+  const int* outer = reduced_.outerIndexPtr();
+  rhs_.setZero(columnOffsets_.back());
+
+  // Every task writes the block column and information of its cameras only
+  parallelFor(0, nrCameras, [&](size_t first, size_t last) {
+    Matrix V;
+    for (size_t j = first; j < last; ++j) {
+      const size_t dim = dims_[j], height = heights_[j];
+      double* column = values + outer[columnOffsets_[j]];
+      std::fill(column, column + height * dim, 0.0);
+      auto block = [&](size_t i) {
+        const vector<size_t>& rows = blockRows_[j];
+        const size_t pos = lower_bound(rows.begin(), rows.end(), i) - rows.begin();
+        return BlockMap(column + rowOffsets_[j][pos], dims_[i], dim, Eigen::OuterStride<>(height));
+      };
+      auto g = rhs_.segment(columnOffsets_[j], dim);
+
+      // H_cc blocks of all factors on the camera
+      for (size_t k = cameraFactorStart_[j]; k < cameraFactorStart_[j + 1]; ++k) {
+        const size_t f = cameraFactors_[k].first, a = cameraFactors_[k].second;
+        const vector<size_t>& slots = factorSlots_[f];
+        const InformationBlocks information(*gfg[f]);
+        for (size_t b = 0; b < slots.size(); ++b)
+          if (slots[b] != kNone && slots[b] <= j) information.add(b, a, block(slots[b]));
+        information.add(a, slots.size(), g);
+      }
+
+      // - H_ip H_pp^-1 H_pj for the cameras i <= j of every landmark of j
+      for (size_t k = cameraPairStart_[j]; k < cameraPairStart_[j + 1]; ++k) {
+        const size_t e = cameraPairs_[k], l = pairLandmark_[e];
+        V.noalias() = BlockMap(pairData_.data() + pairOffset_[e], dim, 3,
+                               Eigen::OuterStride<>(dim)) * landmarkInverse_[l];
+        g.noalias() -= V * landmarkInformation_[l];
+        for (size_t e2 = pairStart_[l]; e2 < pairStart_[l + 1]; ++e2) {
+          const size_t i = pairCamera_[e2];
+          if (i > j) continue;
+          block(i).noalias() -= BlockMap(pairData_.data() + pairOffset_[e2], dims_[i], 3,
+                                         Eigen::OuterStride<>(dims_[i])) * V.transpose();
+        }
+      }
+    }
+  }, parallel_.resolved(nrCameras, 4));
+}
+
+/* ************************************************************************* */
+VectorValues SchurComplementSolver::factorizeAndSolve() {
+  Vector xc;
+  if (!cameras_.empty()) {
+    gttic(SchurComplement_factorize);
+    factorization_.factorize(reduced_);
+
+    // A zero pivot stops the factorization, a negative one shows up in D.
+    // Both are in the AMD ordering of the factorization.
+    const Vector& D = factorization_.vectorD();
+    Eigen::Index failed = -1;
+    for (Eigen::Index col = 0; col < D.size() && failed < 0; ++col)
+      if (!(D(col) > 0.0)) failed = col;
+    if (failed < 0 && factorization_.info() != Eigen::Success) failed = 0;
+    if (failed >= 0) {
+      const size_t column = factorization_.permutationPinv().indices()(failed);
+      const size_t camera =
+          upper_bound(columnOffsets_.begin(), columnOffsets_.end(), column) -
+          columnOffsets_.begin() - 1;
+      throw IndeterminantLinearSystemException(cameras_[camera]);
+    }
+    gttoc(SchurComplement_factorize);
+    xc = factorization_.solve(rhs_);
+  }
+
+  // Back-substitute x_p = H_pp^-1 (g_p - H_pc x_c)
+  gttic(SchurComplement_backSubstitute);
+  const size_t nrLandmarks = landmarks_.size();
+  vector<Vector3> xp(nrLandmarks);
+  parallelFor(0, nrLandmarks, [&](size_t first, size_t last) {
+    for (size_t l = first; l < last; ++l) {
+      Vector3 g = landmarkInformation_[l];
+      for (size_t e = pairStart_[l]; e < pairStart_[l + 1]; ++e) {
+        const size_t c = pairCamera_[e], dim = dims_[c];
+        g.noalias() -= BlockMap(pairData_.data() + pairOffset_[e], dim, 3,
+                                Eigen::OuterStride<>(dim)).transpose() *
+                       xc.segment(columnOffsets_[c], dim);
+      }
+      xp[l] = landmarkInverse_[l] * g;
+    }
+  }, parallel_.resolved(nrLandmarks, 256));
+
+  VectorValues delta;
+  for (size_t c = 0; c < cameras_.size(); ++c)
+    delta.emplace(cameras_[c], xc.segment(columnOffsets_[c], dims_[c]));
+  for (size_t l = 0; l < nrLandmarks; ++l) delta.emplace(landmarks_[l], xp[l]);
+  return delta;
+}
+
+}  // namespace gtsam
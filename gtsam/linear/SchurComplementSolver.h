@@ -0,0 +1,152 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SchurComplementSolver.h
+ * @brief   Solves bundle adjustment systems by eliminating landmarks in closed form
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+#include <gtsam/base/ThreadPool.h>
+#include <gtsam/linear/FactorKeysSignature.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <boost/shared_ptr.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Solves a GaussianFactorGraph with the structure of bundle adjustment, i.e.
+ * landmarks that share no factor, by eliminating the landmarks in closed form
+ * and factorizing the reduced camera system.  This is the solver behind
+ * NonlinearOptimizerParams::SCHUR_COMPLEMENT.
+ *
+ * Landmarks are the variables selected by a predicate, or all 3-dimensional
+ * variables by default; all other variables are cameras.  For every landmark
+ * p the solver sums its 3x3 Hessian block H_pp, its information vector g_p and
+ * the blocks H_cp to its cameras c, in parallel over landmarks.  The reduced
+ * camera system S = H_cc - H_cp H_pp^-1 H_pc is then assembled in parallel
+ * over its block columns, directly into compressed-column storage with dense
+ * blocks, and factorized with a sparse LDL^T in an AMD ordering of the
+ * cameras.  Back-substitution again runs in parallel over landmarks.
+ *
+ * As in SparseCholeskySolver, the layout of the reduced system and the
+ * symbolic analysis are cached as long as the graph has the same factor keys.
+ * Factors may involve at most one landmark, and constrained noise models are
+ * not supported.
+ */
+class GTSAM_EXPORT SchurComplementSolver {
+ public:
+  typedef boost::shared_ptr<SchurComplementSolver> shared_ptr;
+  typedef std::function<bool(Key)> LandmarkPredicate;
+  typedef Eigen::SparseMatrix<double, Eigen::ColMajor, int> SparseMatrix;
+
+ private:
+  typedef Eigen::SimplicialLDLT<SparseMatrix, Eigen::Upper, Eigen::AMDOrdering<int> >
+      Factorization;
+
+  LandmarkPredicate isLandmark_;
+  ParallelOptions parallel_;
+
+  /// Factor keys of the graph the structure was built for, to detect changes
+  FactorKeysSignature signature_;
+
+  /// Cameras with their dimensions and scalar offsets, and landmarks
+  KeyVector cameras_, landmarks_;
+  std::vector<size_t> dims_, columnOffsets_;
+
+  /// For every factor the camera index of each key, and the landmark of the
+  /// factor, with kNone for the landmark key and for factors without one
+  std::vector<std::vector<size_t> > factorSlots_;
+  std::vector<size_t> factorLandmark_;
+
+  /// The factors of every landmark, and its cameras: for each (landmark,
+  /// camera) pair its landmark, camera and the offset of its H_cp block in
+  /// pairData_.  factorPairs_ holds the pair of each key of the factors on a
+  /// landmark.
+  std::vector<size_t> landmarkFactorStart_, landmarkFactors_;
+  std::vector<size_t> pairStart_, pairLandmark_, pairCamera_, pairOffset_;
+  std::vector<std::vector<size_t> > factorPairs_;
+
+  /// For every camera its pairs, and its factors with the position of the
+  /// camera in them
+  std::vector<size_t> cameraPairStart_, cameraPairs_;
+  std::vector<size_t> cameraFactorStart_;
+  std::vector<std::pair<size_t, size_t> > cameraFactors_;
+
+  /// For every block column of the reduced system its sorted block rows,
+  /// their offsets within a column, and the height of its columns
+  std::vector<std::vector<size_t> > blockRows_;
+  std::vector<std::vector<size_t> > rowOffsets_;
+  std::vector<size_t> heights_;
+
+  // Numeric data of the last solve
+  std::vector<double> pairData_;             ///< H_cp blocks, column-major
+  std::vector<Matrix3> landmarkInverse_;     ///< H_pp^-1
+  std::vector<Vector3> landmarkInformation_; ///< g_p
+  SparseMatrix reduced_;  ///< Reduced camera system, upper triangle and full diagonal blocks
+  Vector rhs_;            ///< Its information vector
+  Factorization factorization_;
+  bool analyzed_ = false;
+
+ public:
+  /// Eliminate the landmarks selected by isLandmark, or all 3-dimensional
+  /// variables if it is empty
+  explicit SchurComplementSolver(const LandmarkPredicate& isLandmark = LandmarkPredicate(),
+                                 const ParallelOptions& parallel = ParallelOptions())
+      : isLandmark_(isLandmark), parallel_(parallel) {}
+
+  /// Solve gfg, re-analyzing only if its structure changed since the last call
+  VectorValues optimize(const GaussianFactorGraph& gfg);
+
+  /// Check whether the cached structure can be reused for gfg
+  bool sameStructure(const GaussianFactorGraph& gfg) const { return signature_.matches(gfg); }
+
+  /// Forget the cached structure, the next call will re-analyze
+  void invalidate() { analyzed_ = false; }
+
+  /// The cameras, in the order of the columns of the reduced system
+  const KeyVector& cameras() const { return cameras_; }
+
+  /// The landmarks eliminated in the last solve
+  const KeyVector& landmarks() const { return landmarks_; }
+
+  /// The reduced camera system of the last solve, with the upper triangle and
+  /// the full diagonal blocks stored
+  const SparseMatrix& reducedSystem() const { return reduced_; }
+
+  /// The information vector of the reduced camera system of the last solve
+  const Vector& reducedInformation() const { return rhs_; }
+
+ private:
+  /// Classify the variables and build the layout of the reduced system
+  void analyze(const GaussianFactorGraph& gfg);
+
+  /// Sum the blocks of every landmark and invert H_pp
+  void eliminateLandmarks(const GaussianFactorGraph& gfg);
+
+  /// Assemble the reduced camera system
+  void assemble(const GaussianFactorGraph& gfg);
+
+  /// Factorize the reduced system and back-substitute the landmarks
+  VectorValues factorizeAndSolve();
+};
+
+}  // namespace gtsam
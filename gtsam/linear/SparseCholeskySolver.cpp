@@ -0,0 +1,225 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SparseCholeskySolver.cpp
+ * @brief   Sparse-matrix Cholesky solver for Gaussian factor graphs
+ * @date    Oct 15, 2026
+ */
+
+#include <gtsam/linear/SparseCholeskySolver.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/InformationBlocks.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/base/FastMap.h>
+#include <gtsam/base/timing.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+VectorValues SparseCholeskySolver::optimize(const GaussianFactorGraph& gfg,
+                                            const Ordering& ordering) {
+  if (!analyzed_ || ordering != ordering_ || !sameStructure(gfg))
+    analyze(gfg, ordering);
+  assemble(gfg);
+  return factorizeAndSolve();
+}
+
+/* ************************************************************************* */
+VectorValues SparseCholeskySolver::optimize(const GaussianFactorGraph& gfg,
+                                            Ordering::OrderingType orderingType) {
+  if (!analyzed_ || orderingType_ != orderingType || !sameStructure(gfg)) {
+    analyze(gfg, Ordering::Create(orderingType, gfg));
+    orderingType_ = orderingType;
+  }
+  assemble(gfg);
+  return factorizeAndSolve();
+}
+
+/* ************************************************************************* */
+void SparseCholeskySolver::analyze(const GaussianFactorGraph& gfg,
+                                   const Ordering& ordering) {
+  gttic(SparseCholesky_analyze);
+  const size_t n = ordering.size();
+  FastMap<Key, size_t> slotOf;
+  for (size_t slot = 0; slot < n; ++slot) slotOf.emplace(ordering[slot], slot);
+
+  // Record factor structure and variable dimensions
+  ordering_ = ordering;
+  orderingType_ = boost::none;
+  dims_.assign(n, 0);
+  signature_.record(gfg);
+  factorSlots_.clear();
+  factorSlots_.reserve(gfg.size());
+  for (const auto& factor : gfg) {
+    vector<size_t> slots;
+    if (factor) {
+      slots.reserve(factor->size());
+      for (auto it = factor->begin(); it != factor->end(); ++it) {
+        auto found = slotOf.find(*it);
+        if (found == slotOf.end())
+          throw invalid_argument(
+              "SparseCholeskySolver: factor graph contains a variable that "
+              "is not in the ordering");
+        slots.push_back(found->second);
+        dims_[found->second] = factor->getDim(it);
+      }
+    }
+    factorSlots_.push_back(std::move(slots));
+  }
+
+  // Scalar column offsets
+  columnOffsets_.resize(n + 1);
+  columnOffsets_[0] = 0;
+  for (size_t slot = 0; slot < n; ++slot)
+    columnOffsets_[slot + 1] = columnOffsets_[slot] + dims_[slot];
+  const size_t N = columnOffsets_[n];
+
+  // Block sparsity pattern of the upper triangle: for every block column j,
+  // the sorted block rows i <= j, including the diagonal block.
+  vector<vector<size_t> > blockRows(n);
+  for (size_t slot = 0; slot < n; ++slot) blockRows[slot].push_back(slot);
+  for (const auto& slots : factorSlots_)
+    for (size_t a = 0; a < slots.size(); ++a)
+      for (size_t b = a + 1; b < slots.size(); ++b)
+        blockRows[max(slots[a], slots[b])].push_back(min(slots[a], slots[b]));
+
+  // Offset of every block row within the columns of its block column. As
+  // blocks are contiguous in a column this offset is the same for all columns
+  // of the block column, and the diagonal block always comes last.
+  vector<vector<int> > rowOffsets(n);
+  size_t nnz = 0;
+  for (size_t j = 0; j < n; ++j) {
+    vector<size_t>& rows = blockRows[j];
+    sort(rows.begin(), rows.end());
+    rows.erase(unique(rows.begin(), rows.end()), rows.end());
+    int height = 0;
+    rowOffsets[j].reserve(rows.size());
+    for (size_t i : rows) {
+      rowOffsets[j].push_back(height);
+      if (i != j) height += static_cast<int>(dims_[i]);
+    }
+    // column c of the diagonal block stores rows 0..c
+    nnz += dims_[j] * height + dims_[j] * (dims_[j] + 1) / 2;
+  }
+
+  // Allocate the compressed-column storage and fill in the pattern
+  hessian_.resize(N, N);
+  hessian_.resizeNonZeros(nnz);
+  int* outer = hessian_.outerIndexPtr();
+  int* inner = hessian_.innerIndexPtr();
+  int k = 0;
+  for (size_t j = 0; j < n; ++j) {
+    for (size_t c = 0; c < dims_[j]; ++c) {
+      outer[columnOffsets_[j] + c] = k;
+      for (size_t i : blockRows[j]) {
+        const size_t height = (i == j) ? c + 1 : dims_[i];
+        for (size_t r = 0; r < height; ++r) inner[k++] = columnOffsets_[i] + r;
+      }
+    }
+  }
+  outer[N] = k;
+  std::fill(hessian_.valuePtr(), hessian_.valuePtr() + nnz, 0.0);
+
+  // Scatter map: offset of every (i <= j) pair of blocks of every factor
+  blockOffsets_.clear();
+  blockOffsets_.reserve(factorSlots_.size());
+  for (const auto& slots : factorSlots_) {
+    vector<int> offsets;
+    offsets.reserve(slots.size() * (slots.size() + 1) / 2);
+    for (size_t a = 0; a < slots.size(); ++a) {
+      for (size_t b = a; b < slots.size(); ++b) {
+        const size_t i = min(slots[a], slots[b]), j = max(slots[a], slots[b]);
+        const vector<size_t>& rows = blockRows[j];
+        const size_t pos = lower_bound(rows.begin(), rows.end(), i) - rows.begin();
+        offsets.push_back(rowOffsets[j][pos]);
+      }
+    }
+    blockOffsets_.push_back(std::move(offsets));
+  }
+
+  // Symbolic factorization, reused for every numeric refactorization
+  factorization_.analyzePattern(hessian_);
+  analyzed_ = true;
+}
+
+/* ************************************************************************* */
+void SparseCholeskySolver::assemble(const GaussianFactorGraph& gfg) {
+  gttic(SparseCholesky_assemble);
+  double* values = hessian_.valuePtr();
+  const int* outer = hessian_.outerIndexPtr();
+  std::fill(values, values + hessian_.nonZeros(), 0.0);
+  rhs_.setZero(columnOffsets_.back());
+
+  Matrix block;
+  for (size_t f = 0; f < gfg.size(); ++f) {
+    const GaussianFactor::shared_ptr& factor = gfg[f];
+    if (!factor) continue;
+    const InformationBlocks information(*factor);
+    const vector<size_t>& slots = factorSlots_[f];
+    const vector<int>& offsets = blockOffsets_[f];
+
+    size_t pair = 0;
+    for (size_t a = 0; a < slots.size(); ++a) {
+      for (size_t b = a; b < slots.size(); ++b, ++pair) {
+        // Orient the block so that rows belong to the earlier variable
+        const bool flip = slots[a] > slots[b];
+        const size_t ri = flip ? b : a, cj = flip ? a : b;
+        const size_t j = slots[cj];
+        const size_t rows = dims_[slots[ri]], cols = dims_[j];
+        block.setZero(rows, cols);
+        information.add(ri, cj, block);
+        for (size_t c = 0; c < cols; ++c) {
+          double* column = values + outer[columnOffsets_[j] + c] + offsets[pair];
+          const size_t height = (a == b) ? c + 1 : rows;
+          for (size_t r = 0; r < height; ++r) column[r] += block(r, c);
+        }
+      }
+      information.add(a, slots.size(),
+                      rhs_.segment(columnOffsets_[slots[a]], dims_[slots[a]]));
+    }
+  }
+}
+
+/* ************************************************************************* */
+VectorValues SparseCholeskySolver::factorizeAndSolve() {
+  gttic(SparseCholesky_factorize);
+  factorization_.factorize(hessian_);
+
+  // A zero pivot stops the factorization, a negative one shows up in D
+  const Vector& D = factorization_.vectorD();
+  Eigen::Index failed = -1;
+  for (Eigen::Index col = 0; col < D.size() && failed < 0; ++col)
+    if (!(D(col) > 0.0)) failed = col;
+  if (failed < 0 && factorization_.info() != Eigen::Success) failed = 0;
+  if (failed >= 0) {
+    const size_t slot =
+        upper_bound(columnOffsets_.begin(), columnOffsets_.end(),
+                    static_cast<size_t>(failed)) - columnOffsets_.begin() - 1;
+    throw IndeterminantLinearSystemException(ordering_[slot]);
+  }
+  gttoc(SparseCholesky_factorize);
+
+  gttic(SparseCholesky_solve);
+  const Vector x = factorization_.solve(rhs_);
+  VectorValues delta;
+  for (size_t slot = 0; slot < ordering_.size(); ++slot)
+    if (dims_[slot] > 0)
+      delta.emplace(ordering_[slot], x.segment(columnOffsets_[slot], dims_[slot]));
+  return delta;
+}
+
+}  // namespace gtsam
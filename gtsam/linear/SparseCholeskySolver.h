@@ -0,0 +1,126 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SparseCholeskySolver.h
+ * @brief   Sparse-matrix Cholesky solver for Gaussian factor graphs
+ * @date    Oct 15, 2026
+ */
+
+#pragma once
+
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/linear/FactorKeysSignature.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Solves a GaussianFactorGraph by assembling the normal equations into one
+ * compressed-column sparse Hessian and factorizing it with a sparse LDL^T.
+ * This is the solver behind NonlinearOptimizerParams::CHOLMOD.
+ *
+ * The symbolic work (column layout, sparsity pattern, the scatter map of
+ * every factor into the Hessian, and the symbolic analysis of the
+ * factorization) only depends on the graph structure and the ordering, so it
+ * is cached and reused as long as subsequent graphs have the same factor keys
+ * in the same order. In a nonlinear optimizer this means that only the numeric
+ * assembly and refactorization are done at every iteration.
+ *
+ * The fill-reducing ordering is the one given by GTSAM (COLAMD, METIS or a
+ * custom ordering), applied at the variable level, so the sparse factorization
+ * itself does not reorder.
+ *
+ * Factors with constrained noise models are not supported, as they have no
+ * finite information matrix: use a QR-based solver for those.
+ */
+class GTSAM_EXPORT SparseCholeskySolver {
+ public:
+  typedef boost::shared_ptr<SparseCholeskySolver> shared_ptr;
+  typedef Eigen::SparseMatrix<double, Eigen::ColMajor, int> SparseMatrix;
+
+ private:
+  typedef Eigen::SimplicialLDLT<SparseMatrix, Eigen::Upper,
+                                Eigen::NaturalOrdering<int> > Factorization;
+
+  /// Variables in elimination order, with scalar column offsets and dims
+  Ordering ordering_;
+  std::vector<size_t> columnOffsets_, dims_;
+
+  /// Type ordering_ was computed with, if it was not given explicitly
+  boost::optional<Ordering::OrderingType> orderingType_;
+
+  /// Factor keys of the graph the structure was built for, to detect changes
+  FactorKeysSignature signature_;
+
+  /// For every factor, the positions of its keys in ordering_
+  std::vector<std::vector<size_t> > factorSlots_;
+
+  /// For every factor and every (i <= j) pair of its slots, the offset of
+  /// block (i,j) within the columns of block column j in the CSC storage
+  std::vector<std::vector<int> > blockOffsets_;
+
+  SparseMatrix hessian_;         ///< Upper triangle of the Hessian
+  Vector rhs_;                   ///< Information vector A'*b
+  Factorization factorization_;  ///< Symbolic analysis and numeric factor
+  bool analyzed_ = false;        ///< True if the cache above is valid
+
+ public:
+  /// Default constructor, structure is built on first call to optimize
+  SparseCholeskySolver() {}
+
+  /// Solve using the given ordering, re-analyzing only if the graph
+  /// structure or the ordering changed since the last call.
+  VectorValues optimize(const GaussianFactorGraph& gfg,
+                        const Ordering& ordering);
+
+  /// Solve using an ordering of the given type, which is only computed when
+  /// the graph structure or the ordering type changed since the last call.
+  VectorValues optimize(const GaussianFactorGraph& gfg,
+                        Ordering::OrderingType orderingType = Ordering::COLAMD);
+
+  /// Check whether the cached symbolic structure can be reused for gfg
+  bool sameStructure(const GaussianFactorGraph& gfg) const {
+    return signature_.matches(gfg);
+  }
+
+  /// Forget the cached structure, the next call will re-analyze
+  void invalidate() { analyzed_ = false; }
+
+  /// The elimination ordering of the cached structure
+  const Ordering& ordering() const { return ordering_; }
+
+  /// The assembled (upper-triangular) Hessian of the last solve
+  const SparseMatrix& hessian() const { return hessian_; }
+
+  /// The information vector of the last solve, in ordering
+  const Vector& informationVector() const { return rhs_; }
+
+ private:
+  /// Build column layout, sparsity pattern and do the symbolic analysis
+  void analyze(const GaussianFactorGraph& gfg, const Ordering& ordering);
+
+  /// Scatter the information blocks of all factors into hessian_/rhs_
+  void assemble(const GaussianFactorGraph& gfg);
+
+  /// Numeric factorization and back-substitution
+  VectorValues factorizeAndSolve();
+};
+
+}  // namespace gtsam
@@ -0,0 +1,124 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testMultifrontalSolver.cpp
+ * @brief   Unit tests for the multifrontal solver caching the junction tree
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/linear/MultifrontalSolver.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/inference/inferenceExceptions.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+// A small graph with mixed dimensions, a loop and a HessianFactor
+static GaussianFactorGraph createGraph(double scale = 1.0) {
+  GaussianFactorGraph gfg;
+  const auto model3 = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.2, 0.3));
+  const auto model2 = noiseModel::Isotropic::Sigma(2, 0.5);
+  gfg.add(X(0), 10 * I_3x3, Vector3(1, 2, 3), model3);
+  for (size_t i = 0; i < 3; ++i) {
+    Matrix3 A;
+    A << 1, scale * i, 0, 0, 1, 0.5, 0.1 * scale, 0, 1;
+    gfg.add(X(i), -A, X(i + 1), I_3x3, Vector3(scale, 0.5, -0.2 * i), model3);
+  }
+  Matrix23 H;
+  H << 1, 0, scale, 0, 1, 2;
+  gfg.add(X(0), H, L(0), -I_2x2, Vector2(0.3, -0.4), model2);
+  gfg.add(X(3), 2 * H, L(0), -I_2x2, Vector2(0.1, 0.2), model2);
+  // Loop closure as a HessianFactor
+  gfg.push_back(boost::make_shared<HessianFactor>(JacobianFactor(
+      X(3), I_3x3, X(0), -scale * I_3x3, Vector3(0.1, 0.1, 0.1), model3)));
+  return gfg;
+}
+
+/* ************************************************************************* */
+TEST(MultifrontalSolver, eliminate) {
+  const GaussianFactorGraph gfg = createGraph();
+  const Ordering ordering = Ordering::Colamd(gfg);
+
+  MultifrontalSolver solver;
+  EXPECT(assert_equal(*gfg.eliminateMultifrontal(ordering), *solver.eliminate(gfg, ordering)));
+  EXPECT(assert_equal(gfg.optimize(ordering), solver.optimize(gfg, ordering), 1e-9));
+  EXPECT(assert_equal(gfg.optimize(ordering, EliminateQR),
+                      solver.optimize(gfg, ordering, EliminateQR), 1e-9));
+  EXPECT(assert_equal(gfg.optimize(), solver.optimize(gfg, Ordering::COLAMD), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(MultifrontalSolver, orderingType) {
+  const GaussianFactorGraph gfg = createGraph();
+
+  // Changing the ordering type rebuilds the junction tree even if the structure is the same
+  MultifrontalSolver solver;
+  solver.eliminate(gfg, Ordering::COLAMD);
+  EXPECT(assert_equal(Ordering::Create(Ordering::COLAMD, gfg), solver.ordering()));
+  const Ordering natural = Ordering::Create(Ordering::NATURAL, gfg);
+  EXPECT(assert_equal(*gfg.eliminateMultifrontal(natural),
+                      *solver.eliminate(gfg, Ordering::NATURAL)));
+  EXPECT(assert_equal(natural, solver.ordering()));
+}
+
+/* ************************************************************************* */
+TEST(MultifrontalSolver, reuseStructure) {
+  const GaussianFactorGraph gfg1 = createGraph(1.0), gfg2 = createGraph(2.0);
+
+  MultifrontalSolver solver;
+  solver.optimize(gfg1);
+  const Ordering ordering = solver.ordering();
+  EXPECT(solver.sameStructure(gfg2));
+
+  // Same structure, different numbers: the junction tree is reused and does not hold on to
+  // the factors
+  const long useCount = gfg2[0].use_count();
+  EXPECT(assert_equal(*gfg2.eliminateMultifrontal(ordering), *solver.eliminate(gfg2)));
+  EXPECT(assert_equal(ordering, solver.ordering()));
+  EXPECT_LONGS_EQUAL(useCount, gfg2[0].use_count());
+
+  // Adding a factor changes the structure
+  GaussianFactorGraph gfg3 = gfg2;
+  gfg3.add(X(1), I_3x3, L(0), Matrix32::Ones(), Vector3(1, 1, 1));
+  EXPECT(!solver.sameStructure(gfg3));
+  EXPECT(assert_equal(gfg3.optimize(ordering), solver.optimize(gfg3, ordering), 1e-9));
+
+  // After invalidating, the structure is rebuilt
+  solver.invalidate();
+  EXPECT(assert_equal(gfg1.optimize(ordering), solver.optimize(gfg1, ordering), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(MultifrontalSolver, incompleteOrdering) {
+  const GaussianFactorGraph gfg = createGraph();
+  Ordering ordering;
+  ordering += X(0), X(1), X(2), X(3);
+
+  MultifrontalSolver solver;
+  CHECK_EXCEPTION(solver.eliminate(gfg, ordering), InconsistentEliminationRequested);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
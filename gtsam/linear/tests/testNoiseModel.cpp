@@ -447,6 +447,14 @@ TEST(NoiseModel, WhitenInPlace)
   model->WhitenInPlace(A);
   Matrix expected = I_3x3 * 10;
   EXPECT(assert_equal(expected, A));
+
+  // vectors, for a diagonal and a constrained model, which keeps its constrained rows
+  Vector v = Vector3(1.0, 2.0, 3.0);
+  Diagonal::Sigmas(Vector3(0.5, 1.0, 2.0))->whitenInPlace(v);
+  EXPECT(assert_equal(Vector3(2.0, 2.0, 1.5), v));
+  v = Vector3(1.0, 2.0, 3.0);
+  Constrained::MixedSigmas(Vector3(0.5, 0.0, 2.0))->whitenInPlace(v);
+  EXPECT(assert_equal(Vector3(2.0, 2.0, 1.5), v));
 }
 
 /* ************************************************************************* */
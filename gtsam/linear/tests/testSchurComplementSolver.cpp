@@ -0,0 +1,150 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testSchurComplementSolver.cpp
+ * @brief   Unit tests for the Schur complement solver
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/linear/SchurComplementSolver.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+// Four landmarks seen by three 6-dimensional cameras, with odometry between
+// the cameras, a prior on a landmark and factors of every kind
+static GaussianFactorGraph createGraph(double scale = 1.0) {
+  GaussianFactorGraph gfg;
+  const auto model2 = noiseModel::Isotropic::Sigma(2, 0.5);
+  for (size_t i = 0; i < 3; ++i) {
+    gfg.add(X(i), 10 * I_6x6, Vector6::Constant(0.1 * i));
+    for (size_t j = 0; j < 4; ++j) {
+      Matrix26 Hx;
+      Hx << 1, scale * i, 0, 0.5, j, 0, 0, 1, 0.2 * j, i, 0, 1;
+      Matrix23 Hl;
+      Hl << 1, 0, 0.1 * (i + j), 0, 1, -0.3 * i;
+      if (i == 1 && j == 2)  // Jacobian with a noise model
+        gfg.add(X(i), Hx, L(j), Hl, Vector2(0.2 * i, -0.1 * j), model2);
+      else
+        gfg.add(X(i), Hx, L(j), Hl, Vector2(0.2 * i, -0.1 * j));
+    }
+  }
+  gfg.add(X(0), -I_6x6, X(1), I_6x6, Vector6::Constant(scale));
+  gfg.push_back(boost::make_shared<HessianFactor>(
+      JacobianFactor(X(1), -I_6x6, X(2), 2 * I_6x6, Vector6::Constant(0.5))));
+  gfg.add(L(3), 2 * I_3x3, Vector3(1, 2, 3));
+  return gfg;
+}
+
+/* ************************************************************************* */
+TEST(SchurComplementSolver, optimize) {
+  const GaussianFactorGraph gfg = createGraph();
+  SchurComplementSolver solver;
+  EXPECT(assert_equal(gfg.optimize(), solver.optimize(gfg), 1e-8));
+  EXPECT(KeyVector({X(0), X(1), X(2)}) == solver.cameras());
+  EXPECT(KeyVector({L(0), L(1), L(2), L(3)}) == solver.landmarks());
+
+  // The reduced system is the Schur complement of the dense Hessian
+  Ordering ordering;
+  ordering += X(0), X(1), X(2), L(0), L(1), L(2), L(3);
+  const auto hessian = gfg.hessian(ordering);
+  const Matrix& H = hessian.first;
+  const Vector& g = hessian.second;
+  const Matrix Hpp_inverse = H.bottomRightCorner(12, 12).inverse();
+  const Matrix S = H.topLeftCorner(18, 18) -
+                   H.topRightCorner(18, 12) * Hpp_inverse * H.bottomLeftCorner(12, 18);
+  const Vector s = g.head(18) - H.topRightCorner(18, 12) * Hpp_inverse * g.tail(12);
+  const Matrix actual = Matrix(solver.reducedSystem()).selfadjointView<Eigen::Upper>();
+  EXPECT(assert_equal(S, actual, 1e-8));
+  EXPECT(assert_equal(s, solver.reducedInformation(), 1e-8));
+}
+
+/* ************************************************************************* */
+TEST(SchurComplementSolver, reuseStructure) {
+  const GaussianFactorGraph gfg1 = createGraph(1.0), gfg2 = createGraph(2.0);
+  SchurComplementSolver solver;
+  solver.optimize(gfg1);
+  EXPECT(solver.sameStructure(gfg2));
+  EXPECT(assert_equal(gfg2.optimize(), solver.optimize(gfg2), 1e-8));
+
+  // A new landmark changes the structure
+  GaussianFactorGraph gfg3 = gfg2;
+  gfg3.add(X(0), Matrix26::Ones(), L(4), Matrix23::Identity(), Vector2(1, 1));
+  gfg3.add(X(2), Matrix26::Identity(), L(4), Matrix23::Ones(), Vector2(1, 0));
+  gfg3.add(L(4), I_3x3, Vector3::Zero());
+  EXPECT(!solver.sameStructure(gfg3));
+  EXPECT(assert_equal(gfg3.optimize(), solver.optimize(gfg3), 1e-8));
+}
+
+/* ************************************************************************* */
+TEST(SchurComplementSolver, parallel) {
+  const GaussianFactorGraph gfg = createGraph();
+  SchurComplementSolver serial({}, ParallelOptions::Serial());
+  SchurComplementSolver parallel({}, ParallelOptions(4, 1));
+  EXPECT(assert_equal(serial.optimize(gfg), parallel.optimize(gfg), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(SchurComplementSolver, predicate) {
+  // Eliminate only the landmarks L(0) and L(1), the others become cameras
+  const GaussianFactorGraph gfg = createGraph();
+  SchurComplementSolver solver([](Key key) {
+    return Symbol(key).chr() == 'l' && Symbol(key).index() < 2;
+  });
+  EXPECT(assert_equal(gfg.optimize(), solver.optimize(gfg), 1e-8));
+  EXPECT_LONGS_EQUAL(5, solver.cameras().size());
+
+  // Landmarks need to be 3-dimensional
+  SchurComplementSolver cameras([](Key key) { return Symbol(key).chr() == 'x'; });
+  CHECK_EXCEPTION(cameras.optimize(gfg), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(SchurComplementSolver, unsupported) {
+  // Factors between landmarks
+  GaussianFactorGraph gfg = createGraph();
+  gfg.add(L(0), I_3x3, L(1), -I_3x3, Vector3::Zero());
+  SchurComplementSolver solver;
+  CHECK_EXCEPTION(solver.optimize(gfg), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(SchurComplementSolver, indeterminant) {
+  // L(0) is only seen with rank 2
+  GaussianFactorGraph gfg;
+  gfg.add(X(0), I_6x6, Vector6::Zero());
+  gfg.add(X(0), Matrix26::Ones(), L(0), Matrix23::Identity(), Vector2(1, 2));
+  SchurComplementSolver solver;
+  CHECK_EXCEPTION(solver.optimize(gfg), IndeterminantLinearSystemException);
+  try {
+    solver.optimize(gfg);
+  } catch (const IndeterminantLinearSystemException& e) {
+    EXPECT_LONGS_EQUAL(L(0), e.nearbyVariable());
+  }
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -0,0 +1,129 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testSparseCholeskySolver.cpp
+ * @brief   Unit tests for the sparse Cholesky solver
+ * @date    Oct 15, 2026
+ */
+
+#include <gtsam/linear/SparseCholeskySolver.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+// A small graph with mixed dimensions, a loop and a HessianFactor
+static GaussianFactorGraph createGraph(double scale = 1.0) {
+  GaussianFactorGraph gfg;
+  const auto model3 = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.2, 0.3));
+  const auto model2 = noiseModel::Isotropic::Sigma(2, 0.5);
+  gfg.add(X(0), 10 * I_3x3, Vector3(1, 2, 3), model3);
+  for (size_t i = 0; i < 3; ++i) {
+    Matrix3 A;
+    A << 1, scale * i, 0, 0, 1, 0.5, 0.1 * scale, 0, 1;
+    gfg.add(X(i), -A, X(i + 1), I_3x3, Vector3(scale, 0.5, -0.2 * i), model3);
+  }
+  Matrix23 H;
+  H << 1, 0, scale, 0, 1, 2;
+  gfg.add(X(0), H, L(0), -I_2x2, Vector2(0.3, -0.4), model2);
+  gfg.add(X(3), 2 * H, L(0), -I_2x2, Vector2(0.1, 0.2), model2);
+  // Loop closure as a HessianFactor
+  gfg.push_back(boost::make_shared<HessianFactor>(JacobianFactor(
+      X(3), I_3x3, X(0), -scale * I_3x3, Vector3(0.1, 0.1, 0.1), model3)));
+  return gfg;
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, optimize) {
+  const GaussianFactorGraph gfg = createGraph();
+  const Ordering ordering = Ordering::Colamd(gfg);
+
+  SparseCholeskySolver solver;
+  const VectorValues actual = solver.optimize(gfg, ordering);
+  const VectorValues expected = gfg.optimize(ordering);
+  EXPECT(assert_equal(expected, actual, 1e-8));
+
+  // Assembled Hessian should be the upper triangle of the dense one
+  const Matrix expectedHessian = gfg.hessian(ordering).first;
+  const Matrix actualHessian =
+      Matrix(solver.hessian()).selfadjointView<Eigen::Upper>();
+  EXPECT(assert_equal(expectedHessian, actualHessian, 1e-8));
+  EXPECT(assert_equal(gfg.hessian(ordering).second,
+                      solver.informationVector(), 1e-8));
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, orderingType) {
+  const GaussianFactorGraph gfg = createGraph();
+  SparseCholeskySolver solver;
+  EXPECT(assert_equal(gfg.optimize(),
+                      solver.optimize(gfg, Ordering::COLAMD), 1e-8));
+  EXPECT(assert_equal(gfg.optimize(),
+                      solver.optimize(gfg, Ordering::METIS), 1e-8));
+
+  // Changing the ordering type re-analyzes even if the structure is the same
+  EXPECT(assert_equal(Ordering::Create(Ordering::METIS, gfg), solver.ordering()));
+  solver.optimize(gfg, Ordering::NATURAL);
+  EXPECT(assert_equal(Ordering::Create(Ordering::NATURAL, gfg), solver.ordering()));
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, reuseStructure) {
+  const GaussianFactorGraph gfg1 = createGraph(1.0), gfg2 = createGraph(2.0);
+  const Ordering ordering = Ordering::Colamd(gfg1);
+
+  SparseCholeskySolver solver;
+  solver.optimize(gfg1, ordering);
+  EXPECT(solver.sameStructure(gfg2));
+
+  // Same structure, different numbers: symbolic analysis is reused
+  EXPECT(assert_equal(gfg2.optimize(ordering), solver.optimize(gfg2, ordering),
+                      1e-8));
+
+  // Adding a factor changes the structure
+  GaussianFactorGraph gfg3 = gfg2;
+  gfg3.add(X(1), I_3x3, L(0), Matrix32::Ones(), Vector3(1, 1, 1));
+  EXPECT(!solver.sameStructure(gfg3));
+  EXPECT(assert_equal(gfg3.optimize(ordering), solver.optimize(gfg3, ordering),
+                      1e-8));
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, indeterminant) {
+  // L(0) only appears with rank 1
+  GaussianFactorGraph gfg;
+  gfg.add(X(0), I_2x2, Vector2(1, 2));
+  gfg.add(X(0), I_2x2, L(0), (Matrix2() << 1, 0, 0, 0).finished(),
+          Vector2(0, 0));
+  Ordering ordering;
+  ordering += X(0), L(0);
+
+  SparseCholeskySolver solver;
+  CHECK_EXCEPTION(solver.optimize(gfg, ordering),
+                  IndeterminantLinearSystemException);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
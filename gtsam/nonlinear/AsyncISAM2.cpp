@@ -0,0 +1,212 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    AsyncISAM2.cpp
+ * @brief   ISAM2 that relinearizes on a background thread
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/nonlinear/AsyncISAM2.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+namespace {
+// Copies of the factors for one of the instances, so that factors that cache their
+// linearization, such as smart factors, are never linearized on two threads at once.
+// Factors that do not implement clone() are shared.
+NonlinearFactorGraph CloneFactors(const NonlinearFactorGraph& factors) {
+  NonlinearFactorGraph clones;
+  clones.reserve(factors.size());
+  for (const NonlinearFactor::shared_ptr& factor : factors) {
+    if (!factor) {
+      clones.push_back(factor);
+      continue;
+    }
+    try {
+      clones.push_back(factor->clone());
+    } catch (const runtime_error&) {
+      clones.push_back(factor);  // NonlinearFactor::clone() is not implemented
+    }
+  }
+  return clones;
+}
+}  // namespace
+
+/* ************************************************************************* */
+AsyncISAM2::AsyncISAM2(const ISAM2Params& params) : params_(params) {
+  // Both instances only relinearize and reorder when the worker asks for it
+  ISAM2Params instanceParams = params;
+  instanceParams.enableRelinearization = false;
+  instanceParams.reorderThreshold = 0.0;
+  front_.reset(new ISAM2(instanceParams));
+  back_.reset(new ISAM2(instanceParams));
+  worker_ = thread(&AsyncISAM2::relinearizeLoop, this);
+}
+
+/* ************************************************************************* */
+AsyncISAM2::~AsyncISAM2() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  workAvailable_.notify_one();
+  worker_.join();
+}
+
+/* ************************************************************************* */
+ISAM2Result AsyncISAM2::update(const NonlinearFactorGraph& newFactors,
+                               const Values& newTheta,
+                               const FactorIndices& removeFactorIndices) {
+  ISAM2UpdateParams updateParams;
+  updateParams.removeFactorIndices = removeFactorIndices;
+  return update(newFactors, newTheta, updateParams);
+}
+
+/* ************************************************************************* */
+ISAM2Result AsyncISAM2::update(const NonlinearFactorGraph& newFactors,
+                               const Values& newTheta,
+                               const ISAM2UpdateParams& updateParams) {
+  ISAM2UpdateParams params = updateParams;
+  params.force_relinearize = false;
+
+  // A requested reordering only happens on the worker
+  ISAM2UpdateParams frontParams = params;
+  frontParams.forceReorder = false;
+
+  lock_guard<mutex> lock(mutex_);
+  checkError();
+  ISAM2Result result = front_->update(CloneFactors(newFactors), newTheta, frontParams);
+  const NonlinearFactorGraph backFactors = CloneFactors(newFactors);
+  enqueue([backFactors, newTheta, params](ISAM2& isam) {
+    isam.update(backFactors, newTheta, params);
+  });
+  return result;
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::marginalizeLeaves(const FastList<Key>& leafKeys) {
+  lock_guard<mutex> lock(mutex_);
+  checkError();
+  front_->marginalizeLeaves(leafKeys);
+  enqueue([leafKeys](ISAM2& isam) { isam.marginalizeLeaves(leafKeys); });
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::waitForRelinearization() {
+  unique_lock<mutex> lock(mutex_);
+  swapped_.wait(lock, [this] { return error_ || relinearized_ == submitted_; });
+  checkError();
+}
+
+/* ************************************************************************* */
+Values AsyncISAM2::calculateEstimate() const {
+  lock_guard<mutex> lock(mutex_);
+  return front_->calculateEstimate();
+}
+
+/* ************************************************************************* */
+Matrix AsyncISAM2::marginalCovariance(Key key) const {
+  lock_guard<mutex> lock(mutex_);
+  return front_->marginalCovariance(key);
+}
+
+/* ************************************************************************* */
+Values AsyncISAM2::getLinearizationPoint() const {
+  lock_guard<mutex> lock(mutex_);
+  return front_->getLinearizationPoint();
+}
+
+/* ************************************************************************* */
+ISAM2 AsyncISAM2::isam2() const {
+  lock_guard<mutex> lock(mutex_);
+  return *front_;
+}
+
+/* ************************************************************************* */
+ISAM2Snapshot::shared_ptr AsyncISAM2::snapshot() const {
+  lock_guard<mutex> lock(mutex_);
+  return front_->snapshot();
+}
+
+/* ************************************************************************* */
+size_t AsyncISAM2::relinearizations() const {
+  lock_guard<mutex> lock(mutex_);
+  return swaps_;
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::enqueue(Operation operation) {
+  pending_.push_back(move(operation));
+  ++submitted_;
+  workAvailable_.notify_one();
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::checkError() const {
+  if (error_) rethrow_exception(error_);
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::relinearizeLoop() {
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    workAvailable_.wait(lock, [this] { return stop_ || dirty_ || !pending_.empty(); });
+    if (stop_) return;
+    try {
+      // Catch up with the operations queued so far, and relinearize
+      vector<Operation> operations;
+      operations.swap(pending_);
+      const size_t applied = submitted_;
+      dirty_ = false;
+      lock.unlock();
+      for (const Operation& operation : operations) operation(*back_);
+      ISAM2UpdateParams relinearize;
+      relinearize.force_relinearize = params_.enableRelinearization;
+      relinearize.forceReorder = params_.reorderThreshold > 0.0 &&
+                                 back_->fillRatio() > params_.reorderThreshold;
+      if (relinearize.force_relinearize || relinearize.forceReorder)
+        back_->update(NonlinearFactorGraph(), Values(), relinearize);
+      lock.lock();
+
+      // Catch up with the operations queued meanwhile, without relinearizing
+      // again, as that might never end when updates arrive at a high rate
+      while (!pending_.empty() && !stop_) {
+        operations.clear();
+        operations.swap(pending_);
+        lock.unlock();
+        for (const Operation& operation : operations) operation(*back_);
+        lock.lock();
+      }
+      if (stop_) return;
+
+      // Both instances have all operations now. If some arrived during the
+      // relinearization, go on with the instance swapped out.
+      front_.swap(back_);
+      dirty_ = submitted_ != applied;
+      relinearized_ = applied;
+      ++swaps_;
+      swapped_.notify_all();
+    } catch (...) {
+      if (!lock.owns_lock()) lock.lock();
+      error_ = current_exception();
+      swapped_.notify_all();
+      return;
+    }
+  }
+}
+
+}  // namespace gtsam
@@ -0,0 +1,161 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    AsyncISAM2.h
+ * @brief   ISAM2 that relinearizes on a background thread
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * ISAM2 whose update() never relinearizes, so that its latency does not depend
+ * on how many variables cross the relinearization threshold at once, e.g. after
+ * a loop closure.
+ *
+ * Two ISAM2 instances are kept over the same factors.  update() and
+ * marginalizeLeaves() are applied to the front instance, which answers all
+ * queries, and queued for a worker thread.  The worker replays the queued
+ * operations on the back instance, relinearizes it as ISAM2::update does with
+ * force_relinearize, replays the operations that arrived meanwhile, and swaps
+ * it with the front instance.  The front instance is then relinearized the next
+ * time it becomes the back instance.  The calling thread only waits for the
+ * worker while it exchanges the queue or swaps the instances, which does not
+ * depend on the size of the problem.
+ *
+ * Each instance linearizes its own copies of the new factors, made with
+ * NonlinearFactor::clone(), as factors such as smart factors change cached
+ * state when linearized.  The factors passed to update() are not used by either
+ * instance, so they do not reflect that state.  Factors that do not implement
+ * clone() are shared by both instances and must not change when linearized.
+ *
+ * Factor indices are assigned identically in both instances, so the indices
+ * returned by update() stay valid across swaps.  The worker relinearizes only
+ * if ISAM2Params::enableRelinearization is set; relinearizeSkip is not used, as
+ * relinearization runs whenever the worker is done with the previous one.  The
+ * worker also does the full reorderings triggered by
+ * ISAM2Params::reorderThreshold or ISAM2UpdateParams::forceReorder, so that
+ * they do not stall update() either.  The memory use is twice that of ISAM2.
+ */
+class GTSAM_EXPORT AsyncISAM2 {
+ public:
+  typedef std::function<void(ISAM2&)> Operation;
+
+ private:
+  ISAM2Params params_;  ///< Parameters as given, relinearization enabled or not
+
+  std::unique_ptr<ISAM2> front_;  ///< Answers queries, guarded by mutex_
+  std::unique_ptr<ISAM2> back_;   ///< Owned by the worker between swaps
+
+  mutable std::mutex mutex_;
+  std::condition_variable workAvailable_;  ///< Signals pending_, dirty_ or stop_
+  std::condition_variable swapped_;        ///< Signals a swap or an error
+
+  std::vector<Operation> pending_;  ///< Operations not yet applied to back_
+  size_t submitted_ = 0;            ///< Number of operations applied to front_
+  size_t relinearized_ = 0;         ///< Operations applied before the last relinearization
+  size_t swaps_ = 0;                ///< Number of relinearized instances swapped in
+  bool dirty_ = false;              ///< Operations swapped in without relinearization
+  bool stop_ = false;
+  std::exception_ptr error_;  ///< Exception thrown on the worker thread
+
+  std::thread worker_;
+
+ public:
+  /// @name Standard Constructors
+  /// @{
+
+  /// Start the worker thread
+  explicit AsyncISAM2(const ISAM2Params& params = ISAM2Params());
+
+  /// Stop the worker thread once it is done with the operation in progress
+  ~AsyncISAM2();
+
+  AsyncISAM2(const AsyncISAM2&) = delete;
+  AsyncISAM2& operator=(const AsyncISAM2&) = delete;
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// Add new factors without relinearizing, see ISAM2::update.  Rethrows an
+  /// exception thrown by the worker thread.
+  ISAM2Result update(const NonlinearFactorGraph& newFactors = NonlinearFactorGraph(),
+                     const Values& newTheta = Values(),
+                     const FactorIndices& removeFactorIndices = FactorIndices());
+
+  /// Add new factors without relinearizing, see ISAM2::update.  Relinearization
+  /// requested by force_relinearize is left to the worker.
+  ISAM2Result update(const NonlinearFactorGraph& newFactors, const Values& newTheta,
+                     const ISAM2UpdateParams& updateParams);
+
+  /// Marginalize out leaves of the Bayes tree, see ISAM2::marginalizeLeaves
+  void marginalizeLeaves(const FastList<Key>& leafKeys);
+
+  /// Block until every update so far is relinearized and swapped in.  Rethrows
+  /// an exception thrown by the worker thread.
+  void waitForRelinearization();
+
+  /// Current estimate, see ISAM2::calculateEstimate
+  Values calculateEstimate() const;
+
+  /// Current estimate of a single variable, see ISAM2::calculateEstimate
+  template <class VALUE>
+  VALUE calculateEstimate(Key key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return front_->calculateEstimate<VALUE>(key);
+  }
+
+  /// Marginal covariance of a variable, see ISAM2::marginalCovariance
+  Matrix marginalCovariance(Key key) const;
+
+  /// A copy of the current linearization point
+  Values getLinearizationPoint() const;
+
+  /// A copy of the ISAM2 instance answering queries
+  ISAM2 isam2() const;
+
+  /// An immutable snapshot of the current state, see ISAM2::snapshot
+  ISAM2Snapshot::shared_ptr snapshot() const;
+
+  /// Number of relinearized ISAM2 instances swapped in so far
+  size_t relinearizations() const;
+
+  /// Parameters as given to the constructor
+  const ISAM2Params& params() const { return params_; }
+
+  /// @}
+
+ private:
+  /// Queue an operation already applied to the front instance, with mutex_ locked
+  void enqueue(Operation operation);
+
+  /// Rethrow an exception of the worker thread, with mutex_ locked
+  void checkError() const;
+
+  /// The worker thread
+  void relinearizeLoop();
+};
+
+}  // namespace gtsam
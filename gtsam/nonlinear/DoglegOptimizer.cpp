@@ -22,9 +22,11 @@
 #include <gtsam/linear/GaussianBayesTree.h>
 #include <gtsam/linear/GaussianBayesNet.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/MultifrontalSolver.h>
 #include <gtsam/linear/VectorValues.h>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 
 namespace gtsam {
 
@@ -66,7 +68,8 @@ DoglegOptimizer::DoglegOptimizer(const NonlinearFactorGraph& graph, const Values
                                  const DoglegParams& params)
     : NonlinearOptimizer(
           graph, std::unique_ptr<State>(
-                     new State(initialValues, graph.error(initialValues), params.deltaInitial))),
+                     new State(initialValues, graph.error(initialValues, params.parallel),
+                               params.deltaInitial))),
       params_(ensureHasOrdering(params, graph)) {}
 
 DoglegOptimizer::DoglegOptimizer(const NonlinearFactorGraph& graph, const Values& initialValues,
@@ -84,7 +87,7 @@ double DoglegOptimizer::getDelta() const {
 GaussianFactorGraph::shared_ptr DoglegOptimizer::iterate(void) {
 
   // Linearize graph
-  GaussianFactorGraph::shared_ptr linear = graph_.linearize(state_->values);
+  GaussianFactorGraph::shared_ptr linear = graph_.linearize(state_->values, params_.parallel);
 
   // Pull out parameters we'll use
   const bool dlVerbose = (params_.verbosityDL > DoglegParams::SILENT);
@@ -93,11 +96,14 @@ GaussianFactorGraph::shared_ptr DoglegOptimizer::iterate(void) {
   DoglegOptimizerImpl::IterationResult result;
 
   if ( params_.isMultifrontal() ) {
-    GaussianBayesTree bt = *linear->eliminateMultifrontal(*params_.ordering, params_.getEliminationFunction());
-    VectorValues dx_u = bt.optimizeGradientSearch();
-    VectorValues dx_n = bt.optimize();
+    if (!multifrontalSolver_)
+      multifrontalSolver_ = boost::make_shared<MultifrontalSolver>();
+    GaussianBayesTree::shared_ptr bt = multifrontalSolver_->eliminate(
+        *linear, *params_.ordering, params_.getEliminationFunction());
+    VectorValues dx_u = bt->optimizeGradientSearch();
+    VectorValues dx_n = bt->optimize();
     result = DoglegOptimizerImpl::Iterate(getDelta(), DoglegOptimizerImpl::ONE_STEP_PER_ITERATION,
-      dx_u, dx_n, bt, graph_, state_->values, state_->error, dlVerbose);
+      dx_u, dx_n, *bt, graph_, state_->values, state_->error, dlVerbose);
   }
   else if ( params_.isSequential() ) {
     GaussianBayesNet bn = *linear->eliminateSequential(*params_.ordering, params_.getEliminationFunction());
@@ -117,8 +123,8 @@ GaussianFactorGraph::shared_ptr DoglegOptimizer::iterate(void) {
   if(params_.verbosity >= NonlinearOptimizerParams::DELTA) result.dx_d.print("delta");
 
   // Create new state with new values and new error
-  state_.reset(new State(state_->values.retract(result.dx_d), result.f_error, result.delta,
-                         state_->iterations + 1));
+  state_.reset(new State(state_->values.retract(result.dx_d, params_.parallel), result.f_error,
+                         result.delta, state_->iterations + 1));
   return linear;
 }
 
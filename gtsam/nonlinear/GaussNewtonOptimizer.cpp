@@ -25,18 +25,38 @@ namespace gtsam {
 
 typedef internal::NonlinearOptimizerState State;
 
+namespace {
+/* ************************************************************************* */
+// Whether the error of every factor is half its squared whitened error, i.e. every factor is
+// a NoiseModelFactor with no noise model or a Gaussian, unconstrained one
+bool hasGaussianErrors(const NonlinearFactorGraph& graph) {
+  for (const auto& factor : graph) {
+    if (!factor) continue;
+    const auto noiseModelFactor = boost::dynamic_pointer_cast<NoiseModelFactor>(factor);
+    if (!noiseModelFactor) return false;
+    const SharedNoiseModel& model = noiseModelFactor->noiseModel();
+    if (model && (!boost::dynamic_pointer_cast<noiseModel::Gaussian>(model) ||
+                  model->isConstrained()))
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
 /* ************************************************************************* */
 GaussNewtonOptimizer::GaussNewtonOptimizer(const NonlinearFactorGraph& graph,
                                            const Values& initialValues,
                                            const GaussNewtonParams& params)
-    : NonlinearOptimizer(
-          graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues)))),
-      params_(ensureHasOrdering(params, graph)) {}
+    : NonlinearOptimizer(graph, std::unique_ptr<State>(new State(
+                                    initialValues, graph.error(initialValues, params.parallel)))),
+      params_(ensureHasOrdering(params, graph)),
+      stackErrors_(hasGaussianErrors(graph)) {}
 
 GaussNewtonOptimizer::GaussNewtonOptimizer(const NonlinearFactorGraph& graph,
                                            const Values& initialValues, const Ordering& ordering)
     : NonlinearOptimizer(
-          graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues)))) {
+          graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues)))),
+      stackErrors_(hasGaussianErrors(graph)) {
   params_.ordering = ordering;
 }
 
@@ -46,7 +66,7 @@ GaussianFactorGraph::shared_ptr GaussNewtonOptimizer::iterate() {
 
   // Linearize graph
   gttic(GaussNewtonOptimizer_Linearize);
-  GaussianFactorGraph::shared_ptr linear = graph_.linearize(state_->values);
+  GaussianFactorGraph::shared_ptr linear = graph_.linearize(state_->values, params_.parallel);
   gttoc(GaussNewtonOptimizer_Linearize);
 
   // Solve Factor Graph
@@ -58,13 +78,27 @@ GaussianFactorGraph::shared_ptr GaussNewtonOptimizer::iterate() {
   if (params_.verbosity >= NonlinearOptimizerParams::DELTA)
     delta.print("delta");
 
-  // Create new state with new values and new error
-  Values newValues = state_->values.retract(delta);
-  state_.reset(new State(std::move(newValues), graph_.error(newValues), state_->iterations + 1));
+  // Create new state with new values and new error.  The values are retracted in place in a
+  // copy, which reuses the storage of the values replaced in the previous iteration.
+  trialValues_ = state_->values;
+  trialValues_.retractInPlace(delta, params_.parallel);
+  const double newError = graphError(trialValues_);
+  std::unique_ptr<State> newState(
+      new State(std::move(trialValues_), newError, state_->iterations + 1));
+  trialValues_ = std::move(state_->values);
+  state_ = std::move(newState);
 
   return linear;
 }
 
+/* ************************************************************************* */
+double GaussNewtonOptimizer::graphError(const Values& values) {
+  if (!stackErrors_) return graph_.error(values, params_.parallel);
+  // Evaluate the factors in parallel into the buffer kept from the last iteration
+  graph_.whitenedErrors(values, whitenedErrors_, params_.parallel);
+  return 0.5 * whitenedErrors_.squaredNorm();
+}
+
 /* ************************************************************************* */
 GaussNewtonParams GaussNewtonOptimizer::ensureHasOrdering(
     GaussNewtonParams params, const NonlinearFactorGraph& graph) const {
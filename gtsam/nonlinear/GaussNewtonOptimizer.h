@@ -37,6 +37,9 @@ class GTSAM_EXPORT GaussNewtonOptimizer : public NonlinearOptimizer {
 
 protected:
   GaussNewtonParams params_;
+  Values trialValues_; ///< Storage for the retracted values, reused across iterations
+  Vector whitenedErrors_; ///< Storage for the stacked whitened errors, reused across iterations
+  bool stackErrors_ = false; ///< Whether the error is 0.5 |whitenedErrors_|^2, see graphError()
 
 public:
   /// @name Standard interface
@@ -85,6 +88,9 @@ protected:
   /** Access the parameters (base class version) */
   const NonlinearOptimizerParams& _params() const override { return params_; }
 
+  /** The error of the graph at values, from the stacked whitened errors if stackErrors_ */
+  double graphError(const Values& values);
+
   /** Internal function for computing a COLAMD ordering if no ordering is specified */
   GaussNewtonParams ensureHasOrdering(GaussNewtonParams params, const NonlinearFactorGraph& graph) const;
 
@@ -17,12 +17,14 @@
  * @author  Richard Roberts
  */
 
+#include <gtsam/base/ThreadPool.h>
 #include <gtsam/base/debug.h>
 #include <gtsam/config.h>            // for GTSAM_USE_TBB
 #include <gtsam/inference/Symbol.h>  // for selective linearization thresholds
 #include <gtsam/nonlinear/ISAM2-impl.h>
 
 #include <boost/range/adaptors.hpp>
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <string>
@@ -33,14 +35,97 @@ namespace gtsam {
 
 /* ************************************************************************* */
 namespace internal {
-inline static void optimizeInPlace(const ISAM2::sharedClique& clique,
-                                   VectorValues* result) {
-  // parents are assumed to already be solved and available in result
-  result->update(clique->conditional()->solve(*result));
+/**
+ * Depth-first traversal of the trees below the roots, that only descends into
+ * the children of a clique if visit(clique, parentData, &data) returns true,
+ * passing them the data it filled in.  Subtrees of different children do not
+ * depend on each other, so when a clique has several children, all but the
+ * first may be traversed in tasks of their own.  How much of a subtree will be
+ * visited is not known in advance, so leaves are never given a task and the
+ * number of outstanding tasks is bounded.
+ */
+template <typename DATA, typename VISIT>
+class PrunedTraversal {
+  typedef std::vector<std::pair<ISAM2::sharedClique, DATA> > Stack;
+
+  const VISIT& visit_;
+  const size_t maxTasks_;
+  std::atomic<size_t> tasks_;
+
+ public:
+  PrunedTraversal(const VISIT& visit, size_t nrThreads)
+      : visit_(visit), maxTasks_(8 * nrThreads), tasks_(0) {}
+
+  void run(const ISAM2::Roots& roots, const DATA& rootData,
+           const ParallelOptions& options) {
+    Stack stack;
+    for (auto root = roots.rbegin(); root != roots.rend(); ++root)
+      stack.emplace_back(*root, rootData);
+    if (options.threads() <= 1) {
+      traverse(std::move(stack), nullptr);
+      return;
+    }
+    runWithThreads(options, [&] {
+      TaskGroup tasks;
+      try {
+        traverse(std::move(stack), &tasks);
+      } catch (...) {
+        tasks.cancel();
+        tasks.wait();
+        throw;
+      }
+      tasks.wait();
+    });
+  }
+
+ private:
+  void traverse(Stack stack, TaskGroup* tasks) {
+    while (!stack.empty()) {
+      const ISAM2::sharedClique clique = std::move(stack.back().first);
+      const DATA parentData = std::move(stack.back().second);
+      stack.pop_back();
+      DATA data;
+      if (!visit_(*clique, parentData, &data)) continue;
+
+      const auto& children = clique->children;
+      for (size_t i = children.size(); i-- > 0;) {
+        const ISAM2::sharedClique& child = children[i];
+        if (tasks && i > 0 && !child->children.empty() && reserveTask()) {
+          tasks->run([this, tasks, child, data]() {
+            traverse(Stack{{child, data}}, tasks);
+            tasks_.fetch_sub(1);
+          });
+        } else {
+          stack.emplace_back(child, data);
+        }
+      }
+    }
+  }
+
+  bool reserveTask() {
+    if (tasks_.fetch_add(1) < maxTasks_) return true;
+    tasks_.fetch_sub(1);
+    return false;
+  }
+};
 
-  // starting from the root, call optimize on each conditional
-  for (const ISAM2::sharedClique& child : clique->children)
-    optimizeInPlace(child, result);
+template <typename DATA, typename VISIT>
+void TraversePruned(const ISAM2::Roots& roots, const DATA& rootData,
+                    const VISIT& visit, const ParallelOptions& options) {
+  PrunedTraversal<DATA, VISIT>(visit, options.threads())
+      .run(roots, rootData, options);
+}
+
+/// Nothing passed from a clique to its children
+struct NoData {};
+
+/// Back-substitute a conditional, writing its frontal variables in place so
+/// that cliques of other subtrees may be solved concurrently
+inline static void solveInPlace(const GaussianConditional& conditional,
+                                VectorValues* result) {
+  // parents are assumed to already be solved and available in result
+  for (const auto& frontal : conditional.solve(*result))
+    result->at(frontal.first) = frontal.second;
 }
 }  // namespace internal
 
@@ -48,21 +133,43 @@ inline static void optimizeInPlace(const ISAM2::sharedClique& clique,
 size_t DeltaImpl::UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
                                            const KeySet& replacedKeys,
                                            double wildfireThreshold,
-                                           VectorValues* delta) {
+                                           VectorValues* delta,
+                                           const ParallelOptions& parallel) {
   size_t lastBacksubVariableCount;
 
   if (wildfireThreshold <= 0.0) {
     // Threshold is zero or less, so do a full recalculation
-    for (const ISAM2::sharedClique& root : roots)
-      internal::optimizeInPlace(root, delta);
+    internal::TraversePruned(
+        roots, internal::NoData(),
+        [delta](const ISAM2Clique& clique, const internal::NoData&,
+                internal::NoData*) {
+          internal::solveInPlace(*clique.conditional(), delta);
+          return true;
+        },
+        parallel);
     lastBacksubVariableCount = delta->size();
 
   } else {
-    // Optimize with wildfire
-    lastBacksubVariableCount = 0;
-    for (const ISAM2::sharedClique& root : roots)
-      lastBacksubVariableCount += optimizeWildfireNonRecursive(
-          root, wildfireThreshold, replacedKeys, delta);  // modifies delta
+    // Optimize with wildfire. Instead of one set of changed variables for the
+    // whole tree, every clique passes the changed variables among its own to
+    // its children: by the running intersection property, the separator of a
+    // clique only contains variables of its parent, so this gives the same
+    // result as the serial traversal in optimizeWildfireNonRecursive.
+    std::atomic<size_t> count(0);
+    internal::TraversePruned(
+        roots, KeySet(),
+        [&](const ISAM2Clique& clique, const KeySet& parentChanged,
+            KeySet* changed) {
+          for (Key parent : clique.conditional()->parents())
+            if (parentChanged.exists(parent)) changed->insert(parent);
+          size_t solved = 0;
+          const bool dirty = clique.optimizeWildfireNode(
+              replacedKeys, wildfireThreshold, changed, delta, &solved);
+          count += solved;
+          return dirty;
+        },
+        parallel);
+    lastBacksubVariableCount = count;
 
 #if !defined(NDEBUG) && defined(GTSAM_EXTRA_CONSISTENCY_CHECKS)
     for (VectorValues::const_iterator key_delta = delta->begin();
@@ -77,14 +184,14 @@ size_t DeltaImpl::UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
 
 /* ************************************************************************* */
 namespace internal {
-void updateRgProd(const ISAM2::sharedClique& clique, const KeySet& replacedKeys,
+bool updateRgProd(const ISAM2Clique& clique, const KeySet& replacedKeys,
                   const VectorValues& grad, VectorValues* RgProd,
-                  size_t* varsUpdated) {
+                  std::atomic<size_t>* varsUpdated) {
   // Check if any frontal or separator keys were recalculated, if so, we need
   // update deltas and recurse to children, but if not, we do not need to
   // recurse further because of the running separator property.
   bool anyReplaced = false;
-  for (Key j : *clique->conditional()) {
+  for (Key j : *clique.conditional()) {
     if (replacedKeys.exists(j)) {
       anyReplaced = true;
       break;
@@ -95,20 +202,20 @@ void updateRgProd(const ISAM2::sharedClique& clique, const KeySet& replacedKeys,
     // Update the current variable
     // Get VectorValues slice corresponding to current variables
     Vector gR =
-        grad.vector(KeyVector(clique->conditional()->beginFrontals(),
-                                    clique->conditional()->endFrontals()));
+        grad.vector(KeyVector(clique.conditional()->beginFrontals(),
+                                    clique.conditional()->endFrontals()));
     Vector gS =
-        grad.vector(KeyVector(clique->conditional()->beginParents(),
-                                    clique->conditional()->endParents()));
+        grad.vector(KeyVector(clique.conditional()->beginParents(),
+                                    clique.conditional()->endParents()));
 
     // Compute R*g and S*g for this clique
-    Vector RSgProd = clique->conditional()->R() * gR +
-                     clique->conditional()->S() * gS;
+    Vector RSgProd = clique.conditional()->R() * gR +
+                     clique.conditional()->S() * gS;
 
     // Write into RgProd vector
     DenseIndex vectorPosition = 0;
-    for (Key frontal : clique->conditional()->frontals()) {
-      Vector& RgProdValue = (*RgProd)[frontal];
+    for (Key frontal : clique.conditional()->frontals()) {
+      Vector& RgProdValue = RgProd->at(frontal);
       RgProdValue = RSgProd.segment(vectorPosition, RgProdValue.size());
       vectorPosition += RgProdValue.size();
     }
@@ -117,13 +224,11 @@ void updateRgProd(const ISAM2::sharedClique& clique, const KeySet& replacedKeys,
     // (back-substitution)
     // (*clique)->solveInPlace(deltaNewton);
 
-    *varsUpdated += clique->conditional()->nrFrontals();
-
-    // Recurse to children
-    for (const ISAM2::sharedClique& child : clique->children) {
-      updateRgProd(child, replacedKeys, grad, RgProd, varsUpdated);
-    }
+    *varsUpdated += clique.conditional()->nrFrontals();
   }
+
+  // Recurse to children only if this clique was updated
+  return anyReplaced;
 }
 }  // namespace internal
 
@@ -131,13 +236,18 @@ void updateRgProd(const ISAM2::sharedClique& clique, const KeySet& replacedKeys,
 size_t DeltaImpl::UpdateRgProd(const ISAM2::Roots& roots,
                                  const KeySet& replacedKeys,
                                  const VectorValues& gradAtZero,
-                                 VectorValues* RgProd) {
+                                 VectorValues* RgProd,
+                                 const ParallelOptions& parallel) {
   // Update variables
-  size_t varsUpdated = 0;
-  for (const ISAM2::sharedClique& root : roots) {
-    internal::updateRgProd(root, replacedKeys, gradAtZero, RgProd,
-                           &varsUpdated);
-  }
+  std::atomic<size_t> varsUpdated(0);
+  internal::TraversePruned(
+      roots, internal::NoData(),
+      [&](const ISAM2Clique& clique, const internal::NoData&,
+          internal::NoData*) {
+        return internal::updateRgProd(clique, replacedKeys, gradAtZero, RgProd,
+                                      &varsUpdated);
+      },
+      parallel);
 
   return varsUpdated;
 }
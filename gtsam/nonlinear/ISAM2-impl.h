@@ -82,21 +82,23 @@ struct GTSAM_EXPORT DeltaImpl {
   };
 
   /**
-   * Update the Newton's method step point, using wildfire
+   * Update the Newton's method step point, using wildfire.  Subtrees are
+   * solved in parallel with the given options.
    */
-  static size_t UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
-                                       const KeySet& replacedKeys,
-                                       double wildfireThreshold,
-                                       VectorValues* delta);
+  static size_t UpdateGaussNewtonDelta(
+      const ISAM2::Roots& roots, const KeySet& replacedKeys,
+      double wildfireThreshold, VectorValues* delta,
+      const ParallelOptions& parallel = ParallelOptions());
 
   /**
    * Update the RgProd (R*g) incrementally taking into account which variables
    * have been recalculated in \c replacedKeys.  Only used in Dogleg.
+   * Subtrees are updated in parallel with the given options.
    */
-  static size_t UpdateRgProd(const ISAM2::Roots& roots,
-                             const KeySet& replacedKeys,
-                             const VectorValues& gradAtZero,
-                             VectorValues* RgProd);
+  static size_t UpdateRgProd(
+      const ISAM2::Roots& roots, const KeySet& replacedKeys,
+      const VectorValues& gradAtZero, VectorValues* RgProd,
+      const ParallelOptions& parallel = ParallelOptions());
 
   /**
    * Compute the gradient-search point.  Only used in Dogleg.
@@ -458,11 +460,7 @@ struct GTSAM_EXPORT UpdateImpl {
       Key var = key_value->key;
       assert(static_cast<size_t>(delta[var].size()) == key_value->value.dim());
       assert(delta[var].allFinite());
-      if (mask.exists(var)) {
-        Value* retracted = key_value->value.retract_(delta[var]);
-        key_value->value = *retracted;
-        retracted->deallocate_();
-      }
+      if (mask.exists(var)) key_value->value.retractInPlace_(delta[var]);
     }
   }
 
@@ -472,7 +470,7 @@ struct GTSAM_EXPORT UpdateImpl {
                            const FactorIndices& newFactorsIndices,
                            GaussianFactorGraph* linearFactors) const {
     gttic(linearizeNewFactors);
-    auto linearized = newFactors.linearize(theta);
+    auto linearized = newFactors.linearize(theta, params_.parallel);
     if (params_.findUnusedFactorSlots) {
       linearFactors->resize(numNonlinearFactors);
       for (size_t i = 0; i < newFactors.size(); ++i)
@@ -23,10 +23,15 @@
 #include <gtsam/base/debug.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/inference/BayesTree-inst.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/nonlinear/LinearContainerFactor.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <map>
+#include <stdexcept>
 #include <utility>
 
 using namespace std;
@@ -36,6 +41,70 @@ namespace gtsam {
 // Instantiate base class
 template class BayesTree<ISAM2Clique>;
 
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+// Seconds elapsed since *start, which is then set to now
+double lap(Clock::time_point* start) {
+  const Clock::time_point now = Clock::now();
+  const double seconds = std::chrono::duration<double>(now - *start).count();
+  *start = now;
+  return seconds;
+}
+
+// Nonzero entries of a conditional, as counted by ISAM2Clique::calculate_nnz
+size_t Nonzeros(const GaussianConditional& conditional) {
+  const size_t dimR = conditional.rows();
+  const size_t dimSep = conditional.S().cols();
+  return ((dimR + 1) * dimR) / 2 + dimSep * dimR;
+}
+
+// Nonzero entries of the cliques eliminated into a Bayes tree, not counting
+// the orphans attached to them
+size_t Nonzeros(const ISAM2BayesTree& bayesTree) {
+  size_t nonzeros = 0;
+  for (const auto& key_clique : bayesTree.nodes())
+    if (key_clique.second->conditional()->front() == key_clique.first)
+      nonzeros += Nonzeros(*key_clique.second->conditional());
+  return nonzeros;
+}
+
+// Fill-reducing ordering of the variables in variableIndex, which graph
+// involves, eliminating the constraint groups in increasing order
+template <class FACTOR_GRAPH>
+Ordering ConstrainedOrdering(Ordering::OrderingType orderingType,
+                             const FACTOR_GRAPH& graph,
+                             const VariableIndex& variableIndex,
+                             const FastMap<Key, int>& groups) {
+  if (orderingType == Ordering::COLAMD)
+    return Ordering::ColamdConstrained(variableIndex, groups);
+  if (orderingType != Ordering::METIS)
+    throw std::invalid_argument(
+        "ISAM2 only supports the COLAMD and METIS orderings");
+
+  // METIS has no constraints, so keep its order within every group
+  auto group = [&groups](Key key) {
+    const auto it = groups.find(key);
+    return it == groups.end() ? 0 : it->second;
+  };
+  std::map<int, KeyVector> keysByGroup;
+  KeySet ordered;
+  for (const Key key : Ordering::Metis(graph))
+    if (variableIndex.find(key) != variableIndex.end() &&
+        ordered.insert(key).second)
+      keysByGroup[group(key)].push_back(key);
+  for (const auto& key_factors : variableIndex)
+    if (!ordered.exists(key_factors.first))
+      keysByGroup[group(key_factors.first)].push_back(key_factors.first);
+
+  Ordering ordering;
+  for (const auto& group_keys : keysByGroup)
+    ordering.insert(ordering.end(), group_keys.second.begin(),
+                    group_keys.second.end());
+  return ordering;
+}
+}  // namespace
+
 /* ************************************************************************* */
 ISAM2::ISAM2(const ISAM2Params& params) : params_(params), update_count_(0) {
   if (params_.optimizationParams.type() == typeid(ISAM2DoglegParams))
@@ -61,10 +130,12 @@ bool ISAM2::equals(const ISAM2& other, double tol) const {
 /* ************************************************************************* */
 GaussianFactorGraph ISAM2::relinearizeAffectedFactors(
     const ISAM2UpdateParams& updateParams, const FastList<Key>& affectedKeys,
-    const KeySet& relinKeys) {
+    const KeySet& relinKeys, ISAM2Result* result) {
   gttic(relinearizeAffectedFactors);
-  FactorIndexSet candidates =
+  Clock::time_point start = Clock::now();
+  FactorIndexSet candidateSet =
       UpdateImpl::GetAffectedFactors(affectedKeys, variableIndex_);
+  const FactorIndices candidates(candidateSet.begin(), candidateSet.end());
 
   gttic(affectedKeysSet);
   // for fast lookup below
@@ -72,40 +143,62 @@ GaussianFactorGraph ISAM2::relinearizeAffectedFactors(
   affectedKeysSet.insert(affectedKeys.begin(), affectedKeys.end());
   gttoc(affectedKeysSet);
 
-  gttic(check_candidates_and_linearize);
-  GaussianFactorGraph linearized;
-  for (const FactorIndex idx : candidates) {
-    bool inside = true;
-    bool useCachedLinear = params_.cacheLinearizedFactors;
-    for (Key key : nonlinearFactors_[idx]->keys()) {
-      if (affectedKeysSet.find(key) == affectedKeysSet.end()) {
-        inside = false;
-        break;
+  // Mark the candidates only involving affected keys, and whether their cached
+  // linear factor can be used
+  gttic(check_candidates);
+  enum { kOutside, kCached, kRelinearize };
+  std::vector<char> status(candidates.size());
+  parallelFor(0, candidates.size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      status[i] = params_.cacheLinearizedFactors ? kCached : kRelinearize;
+      for (Key key : nonlinearFactors_[candidates[i]]->keys()) {
+        if (affectedKeysSet.find(key) == affectedKeysSet.end()) {
+          status[i] = kOutside;
+          break;
+        }
+        if (status[i] == kCached && relinKeys.find(key) != relinKeys.end())
+          status[i] = kRelinearize;
       }
-      if (useCachedLinear && relinKeys.find(key) != relinKeys.end())
-        useCachedLinear = false;
     }
-    if (inside) {
-      if (useCachedLinear) {
+  }, params_.parallel.resolved(candidates.size(), 64));  // checks are cheap
+  gttoc(check_candidates);
+  result->affectedFactorsTime = lap(&start);
+
+  // Linearize the factors that need it.  Every candidate only writes its own
+  // slots, so the cached linear factors are updated without locking.
+  gttic(linearize);
+  std::vector<GaussianFactor::shared_ptr> linearFactors(candidates.size());
+  parallelFor(0, candidates.size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const FactorIndex idx = candidates[i];
+      if (status[i] == kCached) {
 #ifdef GTSAM_EXTRA_CONSISTENCY_CHECKS
         assert(linearFactors_[idx]);
         assert(linearFactors_[idx]->keys() == nonlinearFactors_[idx]->keys());
 #endif
-        linearized.push_back(linearFactors_[idx]);
-      } else {
-        auto linearFactor = nonlinearFactors_[idx]->linearize(theta_);
-        linearized.push_back(linearFactor);
+        linearFactors[i] = linearFactors_[idx];
+      } else if (status[i] == kRelinearize) {
+        linearFactors[i] = nonlinearFactors_[idx]->linearize(theta_);
         if (params_.cacheLinearizedFactors) {
 #ifdef GTSAM_EXTRA_CONSISTENCY_CHECKS
-          assert(linearFactors_[idx]->keys() == linearFactor->keys());
+          assert(linearFactors_[idx]->keys() == linearFactors[i]->keys());
 #endif
-          linearFactors_[idx] = linearFactor;
+          linearFactors_[idx] = linearFactors[i];
         }
       }
     }
-  }
-  gttoc(check_candidates_and_linearize);
+  }, params_.parallel);
+  gttoc(linearize);
+
+  // Gather the linear factors in the order of the candidates
+  GaussianFactorGraph linearized;
+  linearized.reserve(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i)
+    if (status[i] != kOutside) linearized.push_back(linearFactors[i]);
 
+  result->relinearizeTime = lap(&start);
+  result->timing.linearize +=
+      result->affectedFactorsTime + result->relinearizeTime;
   return linearized;
 }
 
@@ -115,7 +208,15 @@ void ISAM2::recalculate(const ISAM2UpdateParams& updateParams,
   gttic(recalculate);
   UpdateImpl::LogRecalculateKeys(*result);
 
-  if (!result->markedKeys.empty() || !result->observedKeys.empty()) {
+  // Reorder all variables if the ordering degraded too much since the last
+  // time, so that the fill of the Bayes tree does not drift
+  const bool reorder =
+      updateParams.forceReorder ||
+      (params_.reorderThreshold > 0.0 &&
+       fillRatio() > params_.reorderThreshold);
+
+  if (!result->markedKeys.empty() || !result->observedKeys.empty() ||
+      reorder) {
     // Remove top of Bayes tree and convert to a factor graph:
     // (a) For each affected variable, remove the corresponding clique and all
     // parents up to the root. (b) Store orphaned sub-trees \BayesTree_{O} of
@@ -147,10 +248,12 @@ void ISAM2::recalculate(const ISAM2UpdateParams& updateParams,
       affectedKeys.insert(affectedKeys.end(), conditional->beginFrontals(),
                           conditional->endFrontals());
     gttoc(affectedKeys);
+    for (const auto& conditional : affectedBayesNet)
+      nonzeros_ -= Nonzeros(*conditional);
 
     KeySet affectedKeysSet;
     static const double kBatchThreshold = 0.65;
-    if (affectedKeys.size() >= theta_.size() * kBatchThreshold) {
+    if (reorder || affectedKeys.size() >= theta_.size() * kBatchThreshold) {
       // Do a batch step - reorder and relinearize all variables
       recalculateBatch(updateParams, &affectedKeysSet, result);
     } else {
@@ -190,28 +293,27 @@ void ISAM2::recalculateBatch(const ISAM2UpdateParams& updateParams,
   }
   gttoc(add_keys);
 
+  Clock::time_point start = Clock::now();
   gttic(ordering);
-  Ordering order;
+  FastMap<Key, int> constraintGroups;
   if (updateParams.constrainedKeys) {
-    order = Ordering::ColamdConstrained(affectedFactorsVarIndex,
-                                        *updateParams.constrainedKeys);
-  } else {
-    if (theta_.size() > result->observedKeys.size()) {
-      // Only if some variables are unconstrained
-      FastMap<Key, int> constraintGroups;
-      for (Key var : result->observedKeys) constraintGroups[var] = 1;
-      order = Ordering::ColamdConstrained(affectedFactorsVarIndex,
-                                          constraintGroups);
-    } else {
-      order = Ordering::Colamd(affectedFactorsVarIndex);
-    }
+    constraintGroups = *updateParams.constrainedKeys;
+    for (const Key key : result->unusedKeys) constraintGroups.erase(key);
+  } else if (theta_.size() > result->observedKeys.size()) {
+    // Only if some variables are unconstrained
+    for (Key var : result->observedKeys) constraintGroups[var] = 1;
   }
+  const Ordering order =
+      ConstrainedOrdering(params_.orderingType, nonlinearFactors_,
+                          affectedFactorsVarIndex, constraintGroups);
   gttoc(ordering);
+  result->timing.ordering += lap(&start);
 
   gttic(linearize);
-  auto linearized = nonlinearFactors_.linearize(theta_);
+  auto linearized = nonlinearFactors_.linearize(theta_, params_.parallel);
   if (params_.cacheLinearizedFactors) linearFactors_ = *linearized;
   gttoc(linearize);
+  result->timing.linearize += lap(&start);
 
   gttic(eliminate);
   ISAM2BayesTree::shared_ptr bayesTree =
@@ -229,6 +331,11 @@ void ISAM2::recalculateBatch(const ISAM2UpdateParams& updateParams,
   nodes_.insert(bayesTree->nodes().begin(), bayesTree->nodes().end());
   gttoc(insert);
 
+  // The fill after this reordering is the reference for fillRatio()
+  nonzeros_ = reorderedNonzeros_ = Nonzeros(*bayesTree);
+  reorderedVariables_ = affectedKeysSet->size();
+  result->reordered = true;
+
   result->variablesReeliminated = affectedKeysSet->size();
   result->factorsRecalculated = nonlinearFactors_.size();
 
@@ -257,7 +364,8 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
                             result->observedKeys.begin(),
                             result->observedKeys.end());
   GaussianFactorGraph factors =
-      relinearizeAffectedFactors(updateParams, affectedAndNewKeys, relinKeys);
+      relinearizeAffectedFactors(updateParams, affectedAndNewKeys, relinKeys,
+                                 result);
 
   if (debug) {
     factors.print("Relinearized factors: ");
@@ -307,6 +415,7 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   affectedKeysSet->insert(affectedKeys.begin(), affectedKeys.end());
   gttoc(list_to_set);
 
+  Clock::time_point start = Clock::now();
   VariableIndex affectedFactorsVarIndex(factors);
 
   gttic(ordering_constraints);
@@ -337,8 +446,10 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   // Generate ordering
   gttic(Ordering);
   const Ordering ordering =
-      Ordering::ColamdConstrained(affectedFactorsVarIndex, constraintGroups);
+      ConstrainedOrdering(params_.orderingType, factors,
+                          affectedFactorsVarIndex, constraintGroups);
   gttoc(Ordering);
+  result->timing.ordering += lap(&start);
 
   // Do elimination
   GaussianEliminationTree etree(factors, affectedFactorsVarIndex, ordering);
@@ -351,6 +462,7 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   roots_.insert(roots_.end(), bayesTree->roots().begin(),
                 bayesTree->roots().end());
   nodes_.insert(bayesTree->nodes().begin(), bayesTree->nodes().end());
+  nonzeros_ += Nonzeros(*bayesTree);
   gttoc(reassemble);
 
   // 4. The orphans have already been inserted during elimination
@@ -389,7 +501,196 @@ void ISAM2::removeVariables(const KeySet& unusedKeys) {
     Base::nodes_.unsafe_erase(key);
     theta_.erase(key);
     fixedVariables_.erase(key);
+    const auto age = variableAges_.find(key);
+    if (age != variableAges_.end()) {
+      variablesByAge_.erase(age->second);
+      variableAges_.erase(age);
+    }
+  }
+}
+
+/* ************************************************************************* */
+void ISAM2::updateVariableAges(const Values& newTheta,
+                               const ISAM2UpdateParams& updateParams) {
+  if (updateParams.timestamps) {
+    for (const auto& key_timestamp : *updateParams.timestamps)
+      latestTimestamp_ = std::max(latestTimestamp_, key_timestamp.second);
+  }
+  auto setAge = [this](Key key, const VariableAge& age) {
+    auto it = variableAges_.find(key);
+    if (it != variableAges_.end()) {
+      variablesByAge_.erase(it->second);
+      it->second = age;
+    } else {
+      variableAges_.emplace(key, age);
+    }
+    variablesByAge_.emplace(age, key);
+  };
+
+  // Variables without a timestamp are as old as the latest timestamp
+  for (const Key key : newTheta.keys()) {
+    double timestamp = latestTimestamp_;
+    if (updateParams.timestamps) {
+      const auto it = updateParams.timestamps->find(key);
+      if (it != updateParams.timestamps->end()) timestamp = it->second;
+    }
+    setAge(key, VariableAge(timestamp, variablesAdded_++));
+  }
+  if (updateParams.timestamps) {
+    for (const auto& key_timestamp : *updateParams.timestamps) {
+      const auto it = variableAges_.find(key_timestamp.first);
+      if (it != variableAges_.end() && !newTheta.exists(key_timestamp.first))
+        setAge(key_timestamp.first,
+               VariableAge(key_timestamp.second, it->second.second));
+    }
+  }
+}
+
+/* ************************************************************************* */
+KeyVector ISAM2::variablesToMarginalize(const Values& newTheta) const {
+  const ISAM2CompactionParams& limits = params_.compaction;
+  const size_t nrVariables = theta_.size() + newTheta.size();
+  KeyVector keys;
+
+  // Oldest first, skipping new variables with old timestamps
+  auto oldest = variablesByAge_.begin();
+  auto take = [&]() {
+    for (; oldest != variablesByAge_.end(); ++oldest) {
+      if (!newTheta.exists(oldest->second)) {
+        keys.push_back((oldest++)->second);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (limits.timeHorizon > 0.0 && !std::isinf(latestTimestamp_)) {
+    const double horizon = latestTimestamp_ - limits.timeHorizon;
+    while (oldest != variablesByAge_.end() && oldest->first.first < horizon &&
+           take()) {
+    }
+  }
+  if (limits.maxVariables > 0) {
+    while (nrVariables - keys.size() > limits.maxVariables && take()) {
+    }
+  }
+  if (limits.maxBytes > 0 && !theta_.empty()) {
+    const double perVariable =
+        static_cast<double>(memoryFootprint()) / theta_.size();
+    while ((nrVariables - keys.size()) * perVariable > limits.maxBytes &&
+           take()) {
+    }
+  }
+  return keys;
+}
+
+/* ************************************************************************* */
+void ISAM2::orderFirst(const KeyVector& keys, const Values& newTheta,
+                       ISAM2UpdateParams* updateParams) const {
+  // Put the requested groups after the variables to marginalize, variables
+  // missing from the groups would be in group 0
+  FastMap<Key, int> groups;
+  for (const Key key : theta_.keys()) groups.emplace(key, 1);
+  for (const Key key : newTheta.keys()) groups.emplace(key, 1);
+  if (updateParams->constrainedKeys) {
+    for (const auto& key_group : *updateParams->constrainedKeys)
+      groups[key_group.first] = key_group.second + 1;
+  }
+  for (const Key key : keys) groups[key] = 0;
+  updateParams->constrainedKeys = groups;
+
+  // Re-eliminate the cliques with a variable to marginalize in their
+  // separator, so that none is left above a variable to keep.  The clique of
+  // a variable to marginalize itself only needs to be re-eliminated if a
+  // variable to keep comes first in it.
+  const KeySet marginalized(keys.begin(), keys.end());
+  KeySet reelim;
+  for (const Key key : keys) {
+    const sharedClique& clique = nodes_.at(key);
+    for (const Key frontal : clique->conditional()->frontals()) {
+      if (frontal == key) break;
+      if (!marginalized.exists(frontal)) {
+        reelim.insert(key);
+        break;
+      }
+    }
+    std::vector<sharedClique> stack(clique->children.begin(),
+                                    clique->children.end());
+    while (!stack.empty()) {
+      const sharedClique child = stack.back();
+      stack.pop_back();
+      const auto& parents = child->conditional()->parents();
+      if (std::find(parents.begin(), parents.end(), key) == parents.end())
+        continue;
+      reelim.insert(child->conditional()->beginFrontals(),
+                    child->conditional()->endFrontals());
+      stack.insert(stack.end(), child->children.begin(), child->children.end());
+    }
   }
+  FastList<Key> extraReelimKeys;
+  if (updateParams->extraReelimKeys)
+    extraReelimKeys = *updateParams->extraReelimKeys;
+  extraReelimKeys.insert(extraReelimKeys.end(), reelim.begin(), reelim.end());
+  updateParams->extraReelimKeys = extraReelimKeys;
+}
+
+/* ************************************************************************* */
+namespace {
+// Rough size of a map entry or heap allocation, besides its contents
+const size_t kEntryBytes = 64;
+
+size_t GaussianFactorBytes(const GaussianFactor::shared_ptr& factor) {
+  if (!factor) return 0;
+  size_t bytes = kEntryBytes + factor->size() * sizeof(Key);
+  if (auto jacobian = boost::dynamic_pointer_cast<JacobianFactor>(factor)) {
+    bytes += (jacobian->matrixObject().matrix().size() + jacobian->rows()) *
+             sizeof(double);
+  } else if (auto hessian = boost::dynamic_pointer_cast<HessianFactor>(factor)) {
+    const size_t n = hessian->info().rows();
+    bytes += n * n * sizeof(double);
+  }
+  return bytes;
+}
+
+size_t VectorValuesBytes(const VectorValues& values) {
+  size_t bytes = values.size() * kEntryBytes;
+  for (const auto& key_value : values)
+    bytes += key_value.second.size() * sizeof(double);
+  return bytes;
+}
+}  // namespace
+
+/* ************************************************************************* */
+double ISAM2::fillRatio() const {
+  if (reorderedNonzeros_ == 0 || theta_.empty()) return 1.0;
+  return (static_cast<double>(nonzeros_) / theta_.size()) /
+         (static_cast<double>(reorderedNonzeros_) / reorderedVariables_);
+}
+
+/* ************************************************************************* */
+size_t ISAM2::memoryFootprint() const {
+  size_t bytes = theta_.size() * kEntryBytes + theta_.dim() * sizeof(double);
+  bytes += VectorValuesBytes(delta_) + VectorValuesBytes(deltaNewton_) +
+           VectorValuesBytes(RgProd_);
+  bytes += variableIndex_.size() * kEntryBytes +
+           variableIndex_.nEntries() * sizeof(FactorIndex);
+
+  bytes += nonlinearFactors_.size() * sizeof(NonlinearFactor::shared_ptr);
+  for (const auto& factor : nonlinearFactors_)
+    if (factor) bytes += kEntryBytes + factor->size() * sizeof(Key);
+  bytes += linearFactors_.size() * sizeof(GaussianFactor::shared_ptr);
+  for (const auto& factor : linearFactors_) bytes += GaussianFactorBytes(factor);
+
+  // Every clique is the node of its frontal variables
+  for (const auto& key_clique : nodes_) {
+    const sharedClique& clique = key_clique.second;
+    bytes += kEntryBytes;
+    if (clique->conditional()->front() != key_clique.first) continue;
+    bytes += GaussianFactorBytes(clique->conditional()) +
+             GaussianFactorBytes(clique->cachedFactor()) +
+             clique->gradientContribution().size() * sizeof(double);
+  }
+  return bytes;
 }
 
 /* ************************************************************************* */
@@ -415,14 +716,33 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
                           const Values& newTheta,
                           const ISAM2UpdateParams& updateParams) {
   gttic(ISAM2_update);
+  const Clock::time_point updateStart = Clock::now();
+  Clock::time_point start = updateStart;
   this->update_count_ += 1;
   UpdateImpl::LogStartingUpdate(newFactors, *this);
   ISAM2Result result(params_.enableDetailedResults);
-  UpdateImpl update(params_, updateParams);
+
+  // 0. Find the variables beyond the limits of params_.compaction, and order
+  // them first in the part of the Bayes tree this update re-eliminates
+  ISAM2UpdateParams compactingParams;
+  if (params_.compaction.enabled()) {
+    gttic(select_marginalized);
+    updateVariableAges(newTheta, updateParams);
+    result.marginalizedKeys = variablesToMarginalize(newTheta);
+    if (!result.marginalizedKeys.empty()) {
+      compactingParams = updateParams;
+      orderFirst(result.marginalizedKeys, newTheta, &compactingParams);
+    }
+  }
+  const ISAM2UpdateParams& effectiveParams =
+      result.marginalizedKeys.empty() ? updateParams : compactingParams;
+  result.timing.marginalize = lap(&start);
+  UpdateImpl update(params_, effectiveParams);
 
   // Update delta if we need it to check relinearization later
   if (update.relinarizationNeeded(update_count_))
-    updateDelta(updateParams.forceFullSolve);
+    updateDelta(effectiveParams.forceFullSolve);
+  result.timing.updateDelta = lap(&start);
 
   // 1. Add any new factors \Factors:=\Factors\cup\Factors'.
   update.pushBackFactors(newFactors, &nonlinearFactors_, &linearFactors_,
@@ -434,8 +754,10 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
   // 2. Initialize any new variables \Theta_{new} and add
   // \Theta:=\Theta\cup\Theta_{new}.
   addVariables(newTheta, result.details());
+  result.timing.addVariables = lap(&start);
   if (params_.evaluateNonlinearError)
     update.error(nonlinearFactors_, calculateEstimate(), &result.errorBefore);
+  result.timing.estimate = lap(&start);
 
   // 3. Mark linear update
   update.gatherInvolvedKeys(newFactors, nonlinearFactors_,
@@ -458,23 +780,130 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
     }
     result.variablesRelinearized = result.markedKeys.size();
   }
+  result.timing.relinearizeCheck = lap(&start);
 
   // 7. Linearize new factors
   update.linearizeNewFactors(newFactors, theta_, nonlinearFactors_.size(),
                              result.newFactorsIndices, &linearFactors_);
   update.augmentVariableIndex(newFactors, result.newFactorsIndices,
                               &variableIndex_);
+  result.timing.linearize = lap(&start);
 
   // 8. Redo top of Bayes tree and update data structures
-  recalculate(updateParams, relinKeys, &result);
+  const ISAM2Result::Timing before = result.timing;
+  recalculate(effectiveParams, relinKeys, &result);
+  // recalculate records ordering and relinearization, the rest is elimination
+  result.timing.eliminate = lap(&start) -
+                            (result.timing.ordering - before.ordering) -
+                            (result.timing.linearize - before.linearize);
   if (!result.unusedKeys.empty()) removeVariables(result.unusedKeys);
+  result.timing.removeVariables = lap(&start);
+
+  // 9. Marginalize the variables now at the leaves
+  if (!result.marginalizedKeys.empty()) {
+    gttic(marginalize);
+    marginalizeLeaves(FastList<Key>(result.marginalizedKeys.begin(),
+                                    result.marginalizedKeys.end()));
+  }
+  if (params_.compaction.enabled()) result.memoryFootprint = memoryFootprint();
   result.cliques = this->nodes().size();
+  result.timing.marginalize += lap(&start);
 
   if (params_.evaluateNonlinearError)
     update.error(nonlinearFactors_, calculateEstimate(), &result.errorAfter);
+  result.timing.estimate += lap(&start);
+
+  result.timing.total =
+      std::chrono::duration<double>(Clock::now() - updateStart).count();
+  latency_.record(result.timing);
   return result;
 }
 
+/* ************************************************************************* */
+std::vector<ISAM2Result> ISAM2::updateBatch(
+    const std::vector<ISAM2UpdateStep>& steps) {
+  if (steps.empty()) return std::vector<ISAM2Result>();
+  gttic(ISAM2_updateBatch);
+
+  // Merge the steps into the arguments of a single update
+  const size_t nrSlots = nonlinearFactors_.size();
+  NonlinearFactorGraph newFactors;
+  Values newTheta;
+  ISAM2UpdateParams params;
+  for (const ISAM2UpdateStep& step : steps) {
+    newFactors.push_back(step.newFactors);
+    newTheta.insert(step.newTheta);
+    const ISAM2UpdateParams& stepParams = step.updateParams;
+
+    // Factors of earlier steps are dropped instead, leaving their slots empty
+    for (const FactorIndex index : stepParams.removeFactorIndices) {
+      if (index < nrSlots)
+        params.removeFactorIndices.push_back(index);
+      else
+        newFactors.at(index - nrSlots).reset();
+    }
+    if (stepParams.constrainedKeys) {
+      if (!params.constrainedKeys) params.constrainedKeys = FastMap<Key, int>();
+      for (const auto& key_group : *stepParams.constrainedKeys)
+        (*params.constrainedKeys)[key_group.first] = key_group.second;
+    }
+    if (stepParams.noRelinKeys) {
+      if (!params.noRelinKeys) params.noRelinKeys = FastList<Key>();
+      params.noRelinKeys->insert(params.noRelinKeys->end(),
+                                 stepParams.noRelinKeys->begin(),
+                                 stepParams.noRelinKeys->end());
+    }
+    if (stepParams.extraReelimKeys) {
+      if (!params.extraReelimKeys) params.extraReelimKeys = FastList<Key>();
+      params.extraReelimKeys->insert(params.extraReelimKeys->end(),
+                                     stepParams.extraReelimKeys->begin(),
+                                     stepParams.extraReelimKeys->end());
+    }
+    // New factors are indexed with all their keys anyway
+    if (stepParams.newAffectedKeys) {
+      if (!params.newAffectedKeys)
+        params.newAffectedKeys = FastMap<FactorIndex, KeySet>();
+      for (const auto& index_keys : *stepParams.newAffectedKeys) {
+        if (index_keys.first >= nrSlots) continue;
+        KeySet& keys = (*params.newAffectedKeys)[index_keys.first];
+        keys.insert(index_keys.second.begin(), index_keys.second.end());
+      }
+    }
+    if (stepParams.timestamps) {
+      if (!params.timestamps) params.timestamps = FastMap<Key, double>();
+      for (const auto& key_timestamp : *stepParams.timestamps)
+        (*params.timestamps)[key_timestamp.first] = key_timestamp.second;
+    }
+    params.force_relinearize |= stepParams.force_relinearize;
+    params.forceFullSolve |= stepParams.forceFullSolve;
+    params.forceReorder |= stepParams.forceReorder;
+  }
+  if (params.newAffectedKeys) {
+    for (const FactorIndex index : params.removeFactorIndices)
+      params.newAffectedKeys->erase(index);
+  }
+
+  // Count every step as an update, relinearizing if any of them would have
+  if (params_.enableRelinearization) {
+    for (size_t i = 1; i < steps.size(); ++i)
+      if ((update_count_ + i) % params_.relinearizeSkip == 0)
+        params.force_relinearize = true;
+  }
+  update_count_ += steps.size() - 1;
+
+  const ISAM2Result result = update(newFactors, newTheta, params);
+
+  // Split the indices of the new factors among the steps
+  std::vector<ISAM2Result> results(steps.size(), result);
+  auto begin = result.newFactorsIndices.begin();
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const auto end = begin + steps[i].newFactors.size();
+    results[i].newFactorsIndices.assign(begin, end);
+    begin = end;
+  }
+  return results;
+}
+
 /* ************************************************************************* */
 void ISAM2::marginalizeLeaves(
     const FastList<Key>& leafKeysList,
@@ -499,6 +928,7 @@ void ISAM2::marginalizeLeaves(
     const Cliques removedCliques = this->removeSubtree(subtreeRoot);
     for (const sharedClique& removedClique : removedCliques) {
       auto cg = removedClique->conditional();
+      nonzeros_ -= Nonzeros(*cg);
       marginalFactors.erase(cg->front());
       leafKeysRemoved.insert(cg->beginFrontals(), cg->endFrontals());
       for (Key frontal : cg->frontals()) {
@@ -631,6 +1061,7 @@ void ISAM2::marginalizeLeaves(
         while (leafKeys.exists(cg->keys()[nToRemove])) ++nToRemove;
 
         // Make the clique's matrix appear as a subset
+        nonzeros_ -= Nonzeros(*cg);
         const DenseIndex dimToRemove = cg->matrixObject().offset(nToRemove);
         cg->matrixObject().firstBlock() = nToRemove;
         cg->matrixObject().rowStart() = dimToRemove;
@@ -640,6 +1071,7 @@ void ISAM2::marginalizeLeaves(
         originalKeys.swap(cg->keys());
         cg->keys().assign(originalKeys.begin() + nToRemove, originalKeys.end());
         cg->nrFrontals() -= nToRemove;
+        nonzeros_ += Nonzeros(*cg);
 
         // Add to factorIndicesToRemove any factors involved in frontals of
         // current clique
@@ -708,7 +1140,8 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
         forceFullSolve ? 0.0 : gaussNewtonParams.wildfireThreshold;
     gttic(Wildfire_update);
     DeltaImpl::UpdateGaussNewtonDelta(roots_, deltaReplacedMask_,
-                                      effectiveWildfireThreshold, &delta_);
+                                      effectiveWildfireThreshold, &delta_,
+                                      params_.parallel);
     deltaReplacedMask_.clear();
     gttoc(Wildfire_update);
 
@@ -724,14 +1157,15 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
 
     // Compute Newton's method step
     gttic(Wildfire_update);
-    DeltaImpl::UpdateGaussNewtonDelta(
-        roots_, deltaReplacedMask_, effectiveWildfireThreshold, &deltaNewton_);
+    DeltaImpl::UpdateGaussNewtonDelta(roots_, deltaReplacedMask_,
+                                      effectiveWildfireThreshold, &deltaNewton_,
+                                      params_.parallel);
     gttoc(Wildfire_update);
 
     // Compute steepest descent step
     const VectorValues gradAtZero = this->gradientAtZero();  // Compute gradient
-    DeltaImpl::UpdateRgProd(roots_, deltaReplacedMask_, gradAtZero,
-                            &RgProd_);  // Update RgProd
+    DeltaImpl::UpdateRgProd(roots_, deltaReplacedMask_, gradAtZero, &RgProd_,
+                            params_.parallel);  // Update RgProd
     const VectorValues dx_u = DeltaImpl::ComputeGradientSearch(
         gradAtZero, RgProd_);  // Compute gradient search point
 
@@ -782,9 +1216,21 @@ Values ISAM2::calculateBestEstimate() const {
 
 /* ************************************************************************* */
 Matrix ISAM2::marginalCovariance(Key key) const {
-  return marginalFactor(key, params_.getEliminationFunction())
-      ->information()
-      .inverse();
+  gttic(ISAM2_marginalCovariance);
+  return covarianceCache_.marginalCovariance(*this, key);
+}
+
+/* ************************************************************************* */
+FastMap<Key, Matrix> ISAM2::marginalCovariances(const KeyVector& keys) const {
+  gttic(ISAM2_marginalCovariances);
+  return covarianceCache_.marginalCovariances(*this, keys);
+}
+
+/* ************************************************************************* */
+ISAM2Snapshot::shared_ptr ISAM2::snapshot() const {
+  gttic(ISAM2_snapshot);
+  const VectorValues& delta = getDelta();
+  return boost::make_shared<ISAM2Snapshot>(*this, theta_, delta);
 }
 
 /* ************************************************************************* */
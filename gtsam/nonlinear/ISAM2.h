@@ -21,16 +21,31 @@
 #pragma once
 
 #include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/MarginalCovarianceCache.h>
 #include <gtsam/nonlinear/ISAM2Clique.h>
 #include <gtsam/nonlinear/ISAM2Params.h>
 #include <gtsam/nonlinear/ISAM2Result.h>
+#include <gtsam/nonlinear/ISAM2Snapshot.h>
 #include <gtsam/nonlinear/ISAM2UpdateParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 
+#include <limits>
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace gtsam {
 
+/**
+ * @addtogroup ISAM2
+ * The arguments of one ISAM2::update(), for ISAM2::updateBatch()
+ */
+struct ISAM2UpdateStep {
+  NonlinearFactorGraph newFactors;  ///< The new factors of this step
+  Values newTheta;                  ///< The new variables of this step
+  ISAM2UpdateParams updateParams;   ///< The parameters of this step
+};
+
 /**
  * @addtogroup ISAM2
  * Implementation of the full ISAM2 algorithm for incremental nonlinear
@@ -74,7 +89,8 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
    * until it is needed.
    */
   mutable KeySet deltaReplacedMask_;  // TODO(dellaert): Make sure accessed in
-                                      // the right way
+                                      // the right way. Use snapshot() to
+                                      // read from other threads.
 
   /** All original nonlinear factors are stored here to use during
    * relinearization */
@@ -96,6 +112,30 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   int update_count_;  ///< Counter incremented every update(), used to determine
                       ///< periodic relinearization
 
+  /** Covariances of the cliques visited by marginalCovariance, recomputed
+   * below the cliques an update changed */
+  mutable MarginalCovarianceCache<ISAM2Clique> covarianceCache_;
+
+  /** Time spent in every phase of update(), accumulated over all updates */
+  ISAM2LatencyHistograms latency_;
+
+  /** The timestamp and insertion number of every variable, by which
+   * ISAM2Params::compaction orders variables by age.  Only tracked if
+   * compaction is enabled. */
+  typedef std::pair<double, size_t> VariableAge;
+  FastMap<Key, VariableAge> variableAges_;
+  std::map<VariableAge, Key> variablesByAge_;
+  size_t variablesAdded_ = 0;
+  double latestTimestamp_ = -std::numeric_limits<double>::infinity();
+
+  /** Nonzero entries of the conditionals in the Bayes tree, now and after
+   * the last full reordering, with the number of variables then */
+  size_t nonzeros_ = 0;
+  size_t reorderedNonzeros_ = 0;
+  size_t reorderedVariables_ = 0;
+
+  friend class ISAM2Checkpoint;
+
  public:
   using This = ISAM2;                       ///< This class
   using Base = BayesTree<ISAM2Clique>;      ///< The BayesTree base class
@@ -179,6 +219,28 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
                              const Values& newTheta,
                              const ISAM2UpdateParams& updateParams);
 
+  /**
+   * Apply several updates that arrived together, e.g. after the front end
+   * stalled, with the work of a single update(): their factors and variables
+   * are added, relinearized and re-eliminated at once, and the solution is
+   * updated once.  The linear system solved is that of the updates applied
+   * in sequence, but relinearization happens once for the batch, if any of
+   * the updates would have relinearized.
+   *
+   * The parameters of the steps are merged: the factors to remove, the keys
+   * not to relinearize or to re-eliminate and the new affected keys are
+   * joined, the flags are or-ed, and for constrained keys and timestamps
+   * later steps override earlier ones.  A step can remove a factor added by
+   * an earlier step of the batch by the index that factor gets without
+   * ISAM2Params::findUnusedFactorSlots: the number of factor slots before the
+   * batch plus its position among the new factors of the batch.
+   *
+   * @param steps The arguments of the updates, in the order they arrived
+   * @return One result per step, holding the indices of the factors of that
+   * step in newFactorsIndices.  The other fields describe the whole batch.
+   */
+  std::vector<ISAM2Result> updateBatch(const std::vector<ISAM2UpdateStep>& steps);
+
   /** Marginalize out variables listed in leafKeys.  These keys must be leaves
    * in the BayesTree.  Throws MarginalizeNonleafException if non-leaves are
    * requested to be marginalized.  Marginalization leaves a linear
@@ -201,6 +263,12 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
       boost::optional<FactorIndices&> marginalFactorsIndices = boost::none,
       boost::optional<FactorIndices&> deletedFactorsIndices = boost::none);
 
+  /** Estimate the memory used by the variables, factors and Bayes tree in
+   * bytes: the dense matrices and vectors they store, plus a fixed overhead
+   * per variable, factor and clique.  Takes time linear in the size of the
+   * problem. */
+  size_t memoryFootprint() const;
+
   /// Access the current linearization point
   const Values& getLinearizationPoint() const { return theta_; }
 
@@ -236,9 +304,25 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
    */
   const Value& calculateEstimate(Key key) const;
 
-  /** Return marginal on any variable as a covariance matrix */
+  /** Return marginal on any variable as a covariance matrix. The covariances
+   * of the cliques from the root to the variable are cached until an update
+   * changes them. */
   Matrix marginalCovariance(Key key) const;
 
+  /** Return the marginal covariances of several variables, sharing the work
+   * on the cliques they have in common */
+  FastMap<Key, Matrix> marginalCovariances(const KeyVector& keys) const;
+
+  /** Copy the Bayes tree, linearization point and complete delta into an
+   * immutable snapshot, which other threads can query while update() runs.
+   * Call this from the thread calling update(), e.g. right after it.
+   * This takes time and memory linear in the number of variables, as every
+   * clique, the linearization point and the delta are copied; only the
+   * conditionals and cached factors are shared.  Take a snapshot when readers
+   * need a new one rather than after every update.
+   */
+  ISAM2Snapshot::shared_ptr snapshot() const;
+
   /// @name Public members for non-typical usage
   /// @{
 
@@ -266,6 +350,20 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
 
   const ISAM2Params& params() const { return params_; }
 
+  /// Number of nonzero entries of the conditionals in the Bayes tree
+  size_t nonzeros() const { return nonzeros_; }
+
+  /** Quality of the ordering: the nonzeros per variable of the Bayes tree,
+   * relative to those right after the last full reordering, see
+   * ISAM2Params::reorderThreshold */
+  double fillRatio() const;
+
+  /// Histograms of the time spent in every phase of update()
+  const ISAM2LatencyHistograms& latencyHistograms() const { return latency_; }
+
+  /// Forget the times recorded in the latency histograms
+  void resetLatencyHistograms() { latency_.reset(); }
+
   /** prints out clique statistics */
   void printStats() const { getCliqueData().getStats().print(); }
 
@@ -291,9 +389,11 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
 
   // retrieve all factors that ONLY contain the affected variables
   // (note that the remaining stuff is summarized in the cached factors)
+  // The factors are filtered and linearized in parallel, the time spent is
+  // recorded in result.
   GaussianFactorGraph relinearizeAffectedFactors(
       const ISAM2UpdateParams& updateParams, const FastList<Key>& affectedKeys,
-      const KeySet& relinKeys);
+      const KeySet& relinKeys, ISAM2Result* result);
 
   void recalculateIncremental(const ISAM2UpdateParams& updateParams,
                               const KeySet& relinKeys,
@@ -315,6 +415,18 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   void removeVariables(const KeySet& unusedKeys);
 
   void updateDelta(bool forceFullSolve = false) const;
+
+  /// Record the age of new variables, and the new timestamps of existing ones
+  void updateVariableAges(const Values& newTheta,
+                          const ISAM2UpdateParams& updateParams);
+
+  /// The oldest existing variables beyond the limits of ISAM2Params::compaction
+  KeyVector variablesToMarginalize(const Values& newTheta) const;
+
+  /// Constrain the given variables to be eliminated before all others, and
+  /// re-eliminate the cliques that involve them, so that they become leaves
+  void orderFirst(const KeyVector& keys, const Values& newTheta,
+                  ISAM2UpdateParams* updateParams) const;
 };  // ISAM2
 
 /// traits
@@ -0,0 +1,816 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ISAM2Checkpoint.cpp
+ * @brief   Incremental binary checkpoints of ISAM2
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/nonlinear/ISAM2Checkpoint.h>
+#include <gtsam/base/serialization.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/nonlinear/LinearContainerFactor.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+// File layout, every field is a native 8-byte word, double or padded blob:
+//   kFileTag kByteOrder version
+//   segment*: kSegmentTag length record* kEnd length
+const uint64_t kFileTag = 0x3143504b324d4153;  // "SAM2KPC1"
+const uint64_t kByteOrder = 0x0102030405060708;
+const uint64_t kSegmentTag = 0x544e454d47455331;  // "1SEGMENT"
+
+enum Record : uint64_t {
+  kEnd,
+  kScalars,        // update count, Dogleg delta, compaction and fill counters
+  kNonlinear,      // serialized removed keys, changed values and factors,
+                   // then the linear factors of changed LinearContainerFactors
+  kLinearFactors,  // number of slots, then changed slots
+  kDelta,          // which, removed keys, changed entries
+  kKeySet,         // which, all keys
+  kAges,           // removed keys, changed ages
+  kCliques         // clique, relink and remove entries, then kEnd
+};
+enum FactorType : uint64_t { kNull, kJacobian, kHessian, kSerialized };
+enum ModelType : uint64_t { kNoModel, kDiagonal, kConstrained };
+enum CliqueEntry : uint64_t { kCliquesEnd, kClique, kRelink, kRemove };
+enum DeltaType : uint64_t { kDeltaGaussNewton, kDeltaNewton, kRgProd };
+enum KeySetType : uint64_t { kFixedVariables, kDeltaReplacedMask };
+
+// Appends words to a buffer
+class Output {
+ public:
+  string buffer;
+
+  void word(uint64_t value) { bytes(&value, sizeof(value)); }
+  void real(double value) { bytes(&value, sizeof(value)); }
+
+  void vector(const Vector& v) {
+    word(v.size());
+    bytes(v.data(), v.size() * sizeof(double));
+  }
+
+  // Column-major, the dimensions are written by the caller
+  template <class MATRIX>
+  void matrix(const MATRIX& m) {
+    const Matrix dense = m;
+    bytes(dense.data(), dense.size() * sizeof(double));
+  }
+
+  template <class KEYS>
+  void keys(const KEYS& keys) {
+    word(keys.size());
+    for (const Key key : keys) word(key);
+  }
+
+  void blob(const string& data) {
+    word(data.size());
+    buffer.append(data);
+    buffer.append((8 - data.size() % 8) % 8, '\0');
+  }
+
+ private:
+  void bytes(const void* data, size_t size) {
+    buffer.append(static_cast<const char*>(data), size);
+  }
+};
+
+// Reads words from a buffer, throwing if it ends early
+class Input {
+  const char* data_;
+  const char* end_;
+
+ public:
+  Input(const char* data, size_t size) : data_(data), end_(data + size) {}
+
+  size_t remaining() const { return end_ - data_; }
+  const char* data() const { return data_; }
+
+  uint64_t word() {
+    uint64_t value;
+    bytes(&value, sizeof(value));
+    return value;
+  }
+
+  double real() {
+    double value;
+    bytes(&value, sizeof(value));
+    return value;
+  }
+
+  Vector vector() {
+    Vector v(word());
+    bytes(v.data(), v.size() * sizeof(double));
+    return v;
+  }
+
+  Matrix matrix(size_t rows, size_t cols) {
+    Matrix m(rows, cols);
+    bytes(m.data(), m.size() * sizeof(double));
+    return m;
+  }
+
+  KeyVector keys() {
+    KeyVector keys(word());
+    for (Key& key : keys) key = word();
+    return keys;
+  }
+
+  string blob() {
+    const size_t size = word();
+    const size_t padded = size + (8 - size % 8) % 8;
+    need(padded);
+    string data(data_, size);
+    data_ += padded;
+    return data;
+  }
+
+  Input sub(size_t size) {
+    need(size);
+    Input input(data_, size);
+    data_ += size;
+    return input;
+  }
+
+ private:
+  void need(size_t size) const {
+    if (size > remaining())
+      throw runtime_error("ISAM2Checkpoint: record ends past its segment");
+  }
+
+  void bytes(void* out, size_t size) {
+    need(size);
+    memcpy(out, data_, size);
+    data_ += size;
+  }
+};
+
+/* ************************************************************************* */
+void WriteModel(const SharedDiagonal& model, Output* out) {
+  if (!model) {
+    out->word(kNoModel);
+  } else if (auto constrained =
+                 boost::dynamic_pointer_cast<noiseModel::Constrained>(model)) {
+    out->word(kConstrained);
+    out->vector(constrained->sigmas());
+    out->vector(constrained->mu());
+  } else {
+    out->word(kDiagonal);
+    out->vector(model->sigmas());
+  }
+}
+
+SharedDiagonal ReadModel(Input* in) {
+  switch (in->word()) {
+    case kNoModel:
+      return SharedDiagonal();
+    case kDiagonal:
+      return noiseModel::Diagonal::Sigmas(in->vector());
+    case kConstrained: {
+      const Vector sigmas = in->vector();
+      return noiseModel::Constrained::MixedSigmas(in->vector(), sigmas);
+    }
+    default:
+      throw runtime_error("ISAM2Checkpoint: unknown noise model type");
+  }
+}
+
+// Keys and dimensions of the blocks of a factor or conditional, with the
+// augmented matrix of their rows
+template <class FACTOR>
+void WriteBlocks(const FACTOR& factor, const VerticalBlockMatrix& Ab,
+                 Output* out) {
+  out->keys(factor.keys());
+  for (size_t j = 0; j < factor.size(); ++j) out->word(Ab(j).cols());
+  out->word(Ab.rows());
+  out->matrix(Ab.full());
+}
+
+VerticalBlockMatrix ReadBlocks(size_t nrKeys, Input* in) {
+  vector<size_t> dims(nrKeys);
+  for (size_t& dim : dims) dim = in->word();
+  dims.push_back(1);
+  const size_t rows = in->word();
+  VerticalBlockMatrix Ab(dims, rows);
+  Ab.matrix() = in->matrix(rows, Ab.cols());
+  return Ab;
+}
+
+void WriteFactor(const GaussianFactor::shared_ptr& factor, Output* out) {
+  if (!factor) {
+    out->word(kNull);
+  } else if (typeid(*factor) == typeid(JacobianFactor)) {
+    const auto& jacobian = static_cast<const JacobianFactor&>(*factor);
+    out->word(kJacobian);
+    WriteBlocks(jacobian, jacobian.matrixObject(), out);
+    WriteModel(jacobian.get_model(), out);
+  } else if (typeid(*factor) == typeid(HessianFactor)) {
+    const auto& hessian = static_cast<const HessianFactor&>(*factor);
+    out->word(kHessian);
+    out->keys(hessian.keys());
+    for (size_t j = 0; j < hessian.size(); ++j)
+      out->word(hessian.info().getDim(j));
+    out->matrix(hessian.info().selfadjointView());
+  } else {
+    out->word(kSerialized);
+    out->blob(serializeToBinaryString(factor));
+  }
+}
+
+GaussianFactor::shared_ptr ReadFactor(Input* in) {
+  switch (in->word()) {
+    case kNull:
+      return GaussianFactor::shared_ptr();
+    case kJacobian: {
+      const KeyVector keys = in->keys();
+      const VerticalBlockMatrix Ab = ReadBlocks(keys.size(), in);
+      return boost::make_shared<JacobianFactor>(keys, Ab, ReadModel(in));
+    }
+    case kHessian: {
+      const KeyVector keys = in->keys();
+      vector<size_t> dims(keys.size());
+      size_t n = 1;
+      for (size_t& dim : dims) n += (dim = in->word());
+      dims.push_back(1);
+      return boost::make_shared<HessianFactor>(
+          keys, SymmetricBlockMatrix(dims, in->matrix(n, n)));
+    }
+    case kSerialized: {
+      GaussianFactor::shared_ptr factor;
+      deserializeFromBinaryString(in->blob(), factor);
+      return factor;
+    }
+    default:
+      throw runtime_error("ISAM2Checkpoint: unknown factor type");
+  }
+}
+
+void WriteConditional(const GaussianConditional& conditional, Output* out) {
+  out->word(conditional.nrFrontals());
+  WriteBlocks(conditional, conditional.matrixObject(), out);
+  WriteModel(conditional.get_model(), out);
+}
+
+GaussianConditional::shared_ptr ReadConditional(Input* in) {
+  const size_t nrFrontals = in->word();
+  const KeyVector keys = in->keys();
+  const VerticalBlockMatrix Ab = ReadBlocks(keys.size(), in);
+  return boost::make_shared<GaussianConditional>(keys, nrFrontals, Ab,
+                                                 ReadModel(in));
+}
+
+// Write the entries of current that differ from written, and update written
+void WriteDelta(DeltaType which, const VectorValues& current,
+                VectorValues* written, Output* out) {
+  KeyVector removed;
+  for (const auto& key_value : *written)
+    if (!current.exists(key_value.first)) removed.push_back(key_value.first);
+  for (const Key key : removed) written->erase(key);
+
+  Output changed;
+  size_t nrChanged = 0;
+  for (const auto& key_value : current) {
+    auto it = written->find(key_value.first);
+    if (it != written->end() && it->second.size() == key_value.second.size() &&
+        it->second == key_value.second)
+      continue;
+    changed.word(key_value.first);
+    changed.vector(key_value.second);
+    ++nrChanged;
+    if (it == written->end())
+      written->insert(key_value.first, key_value.second);
+    else
+      it->second = key_value.second;
+  }
+
+  if (removed.empty() && nrChanged == 0) return;
+  out->word(kDelta);
+  out->word(which);
+  out->keys(removed);
+  out->word(nrChanged);
+  out->buffer.append(changed.buffer);
+}
+
+void ReadDelta(Input* in, VectorValues* delta) {
+  for (const Key key : in->keys()) delta->erase(key);
+  const size_t nrChanged = in->word();
+  for (size_t i = 0; i < nrChanged; ++i) {
+    const Key key = in->word();
+    Vector value = in->vector();
+    auto it = delta->find(key);
+    if (it == delta->end())
+      delta->insert(key, value);
+    else
+      it->second = value;
+  }
+}
+
+// Erase the removed keys and write the changed values, assigning the values that keep their
+// type in place
+void ApplyValueChanges(const KeyVector& removedKeys, const Values& changedValues,
+                       Values* values) {
+  for (const Key key : removedKeys) values->erase(key);
+  Values insertedValues;
+  for (const auto key_value : changedValues) {
+    const Values& current = *values;
+    const auto existing = current.find(key_value.key);
+    if (existing != current.end() && typeid(existing->value) == typeid(key_value.value)) {
+      values->update(key_value.key, key_value.value);
+    } else {
+      if (existing != current.end()) values->erase(key_value.key);
+      insertedValues.insert(key_value.key, key_value.value);
+    }
+  }
+  values->insert(insertedValues);
+}
+
+// A clique as read so far, the cliques are linked once all segments are read
+struct ReadClique {
+  GaussianConditional::shared_ptr conditional;
+  GaussianFactor::shared_ptr cachedFactor;
+  Vector gradientContribution;
+  int problemSize = 1;
+  uint64_t parent = 0;
+};
+}  // namespace
+
+/* ************************************************************************* */
+ISAM2Checkpoint::ISAM2Checkpoint(const string& filename)
+    : filename_(filename) {}
+
+/* ************************************************************************* */
+void ISAM2Checkpoint::reset() {
+  theta_.clear();
+  factors_.clear();
+  linearFactors_.clear();
+  delta_ = VectorValues();
+  deltaNewton_ = VectorValues();
+  RgProd_ = VectorValues();
+  ages_.clear();
+  cliques_.clear();
+  nextCliqueId_ = 1;
+}
+
+/* ************************************************************************* */
+size_t ISAM2Checkpoint::append(const ISAM2& isam) {
+  if (segments_ == 0) {
+    rewrite(isam);
+    return fileSize_;
+  }
+
+  // segment() already records the state as written.  If the write fails, cut off what was
+  // written of the segment and start over with a full rewrite on the next append.
+  const string data = segment(isam);
+  ofstream file(filename_.c_str(), ios::binary | ios::app);
+  file.write(data.data(), data.size());
+  file.flush();
+  if (!file) {
+    file.close();
+    boost::system::error_code error;
+    boost::filesystem::resize_file(filename_, fileSize_, error);
+    reset();
+    segments_ = 0;
+    throw runtime_error("ISAM2Checkpoint: cannot append to " + filename_);
+  }
+  fileSize_ += data.size();
+  ++segments_;
+  return data.size();
+}
+
+/* ************************************************************************* */
+void ISAM2Checkpoint::rewrite(const ISAM2& isam) {
+  reset();
+  Output header;
+  header.word(kFileTag);
+  header.word(kByteOrder);
+  header.word(kVersion);
+  const string data = header.buffer + segment(isam);
+
+  const string temporary = filename_ + ".tmp";
+  {
+    ofstream file(temporary.c_str(), ios::binary | ios::trunc);
+    file.write(data.data(), data.size());
+    file.flush();
+    if (!file) {
+      file.close();
+      std::remove(temporary.c_str());
+      segments_ = 0;
+      throw runtime_error("ISAM2Checkpoint: cannot write " + temporary);
+    }
+  }
+  // rename does not replace existing files on all platforms
+  if (std::rename(temporary.c_str(), filename_.c_str()) != 0) {
+    std::remove(filename_.c_str());
+    if (std::rename(temporary.c_str(), filename_.c_str()) != 0) {
+      segments_ = 0;
+      throw runtime_error("ISAM2Checkpoint: cannot replace " + filename_);
+    }
+  }
+  fileSize_ = data.size();
+  segments_ = 1;
+}
+
+/* ************************************************************************* */
+string ISAM2Checkpoint::segment(const ISAM2& isam) {
+  Output out;
+
+  out.word(kScalars);
+  out.word(isam.update_count_);
+  out.word(isam.doglegDelta_ ? 1 : 0);
+  out.real(isam.doglegDelta_ ? *isam.doglegDelta_ : 0.0);
+  out.word(isam.variablesAdded_);
+  out.real(isam.latestTimestamp_);
+  out.word(isam.nonzeros_);
+  out.word(isam.reorderedNonzeros_);
+  out.word(isam.reorderedVariables_);
+
+  // Values and nonlinear factors, which need boost::serialization
+  // Compare with the written values in a single pass, as both are sorted by key
+  KeyVector removedKeys;
+  Values changedValues;
+  // Some equals() test the difference with < tol, so tol = 0 never holds
+  const double kExact = std::numeric_limits<double>::denorm_min();
+  const Values& written = theta_;
+  auto previous = written.begin();
+  for (const auto key_value : isam.theta_) {
+    for (; previous != written.end() && previous->key < key_value.key; ++previous)
+      removedKeys.push_back(previous->key);
+    if (previous != written.end() && previous->key == key_value.key) {
+      const Value& value = previous->value;
+      ++previous;
+      if (typeid(value) == typeid(key_value.value) && value.equals_(key_value.value, kExact))
+        continue;
+    }
+    changedValues.insert(key_value.key, key_value.value);
+  }
+  for (; previous != written.end(); ++previous) removedKeys.push_back(previous->key);
+  ApplyValueChanges(removedKeys, changedValues, &theta_);
+
+  // The marginals of marginalized variables only need their linear factor
+  // and linearization point to be serialized
+  const NonlinearFactorGraph& factors = isam.nonlinearFactors_;
+  vector<pair<uint64_t, NonlinearFactor::shared_ptr> > changedFactors;
+  vector<pair<uint64_t, Values> > linearizationPoints;
+  Output containers;
+  size_t nrContainers = 0;
+  const bool nrFactorsChanged = factors_.size() != factors.size();
+  factors_.resize(factors.size());
+  for (size_t i = 0; i < factors.size(); ++i) {
+    if (factors[i] == factors_[i]) continue;
+    factors_[i] = factors[i];
+    if (factors[i] && typeid(*factors[i]) == typeid(LinearContainerFactor)) {
+      const auto& container = static_cast<const LinearContainerFactor&>(*factors[i]);
+      containers.word(i);
+      containers.word(container.linearizationPoint() ? 1 : 0);
+      WriteFactor(container.factor(), &containers);
+      if (container.linearizationPoint())
+        linearizationPoints.emplace_back(i, *container.linearizationPoint());
+      ++nrContainers;
+    } else {
+      changedFactors.emplace_back(i, factors[i]);
+    }
+  }
+
+  if (nrFactorsChanged || !removedKeys.empty() || !changedValues.empty() ||
+      !changedFactors.empty() || nrContainers > 0) {
+    ostringstream stream;
+    {
+      boost::archive::binary_oarchive archive(stream);
+      const uint64_t nrFactors = factors.size();
+      archive << removedKeys << changedValues << nrFactors << changedFactors
+              << linearizationPoints;
+    }
+    out.word(kNonlinear);
+    out.blob(stream.str());
+    out.word(nrContainers);
+    out.buffer.append(containers.buffer);
+  }
+
+  // Cached linear factors, which only change when relinearized
+  const GaussianFactorGraph& linearFactors = isam.linearFactors_;
+  Output changedLinear;
+  size_t nrChangedLinear = 0;
+  const bool nrLinearChanged = linearFactors_.size() != linearFactors.size();
+  linearFactors_.resize(linearFactors.size());
+  for (size_t i = 0; i < linearFactors.size(); ++i) {
+    if (linearFactors[i] == linearFactors_[i]) continue;
+    changedLinear.word(i);
+    WriteFactor(linearFactors[i], &changedLinear);
+    linearFactors_[i] = linearFactors[i];
+    ++nrChangedLinear;
+  }
+  if (nrLinearChanged || nrChangedLinear > 0) {
+    out.word(kLinearFactors);
+    out.word(linearFactors.size());
+    out.word(nrChangedLinear);
+    out.buffer.append(changedLinear.buffer);
+  }
+
+  WriteDelta(kDeltaGaussNewton, isam.delta_, &delta_, &out);
+  WriteDelta(kDeltaNewton, isam.deltaNewton_, &deltaNewton_, &out);
+  WriteDelta(kRgProd, isam.RgProd_, &RgProd_, &out);
+
+  // Small sets are written whole
+  out.word(kKeySet);
+  out.word(kFixedVariables);
+  out.keys(isam.fixedVariables_);
+  out.word(kKeySet);
+  out.word(kDeltaReplacedMask);
+  out.keys(isam.deltaReplacedMask_);
+
+  // Variable ages, only tracked with compaction
+  KeyVector removedAges;
+  for (const auto& key_age : ages_)
+    if (!isam.variableAges_.count(key_age.first))
+      removedAges.push_back(key_age.first);
+  for (const Key key : removedAges) ages_.erase(key);
+  Output changedAges;
+  size_t nrChangedAges = 0;
+  for (const auto& key_age : isam.variableAges_) {
+    const auto inserted = ages_.emplace(key_age.first, key_age.second);
+    if (!inserted.second) {
+      if (inserted.first->second == key_age.second) continue;
+      inserted.first->second = key_age.second;
+    }
+    changedAges.word(key_age.first);
+    changedAges.real(key_age.second.first);
+    changedAges.word(key_age.second.second);
+    ++nrChangedAges;
+  }
+  if (!removedAges.empty() || nrChangedAges > 0) {
+    out.word(kAges);
+    out.keys(removedAges);
+    out.word(nrChangedAges);
+    out.buffer.append(changedAges.buffer);
+  }
+
+  // Cliques that are new or changed, or moved to another parent.  ISAM2
+  // creates new cliques for everything it re-eliminates, and only modifies
+  // the conditional of a clique it keeps when marginalizing.
+  out.word(kCliques);
+  const size_t visit = segments_ + 1;
+  vector<pair<ISAM2::sharedClique, uint64_t> > stack;
+  for (const auto& root : isam.roots()) stack.emplace_back(root, 0);
+  while (!stack.empty()) {
+    const ISAM2::sharedClique clique = stack.back().first;
+    const uint64_t parent = stack.back().second;
+    stack.pop_back();
+
+    const GaussianConditional& conditional = *clique->conditional();
+    WrittenClique& written = cliques_[clique.get()];
+    const bool known = written.clique.lock() == clique;
+    if (!known || written.conditional != &conditional ||
+        written.front != conditional.front() ||
+        written.nrFrontals != conditional.nrFrontals() ||
+        written.size != conditional.size()) {
+      if (!known) {
+        written.clique = clique;
+        written.id = nextCliqueId_++;
+      }
+      written.parent = parent;
+      written.conditional = &conditional;
+      written.front = conditional.front();
+      written.nrFrontals = conditional.nrFrontals();
+      written.size = conditional.size();
+      out.word(kClique);
+      out.word(written.id);
+      out.word(parent);
+      out.word(clique->problemSize_);
+      WriteConditional(conditional, &out);
+      WriteFactor(clique->cachedFactor_, &out);
+      out.vector(clique->gradientContribution_);
+    } else if (written.parent != parent) {
+      written.parent = parent;
+      out.word(kRelink);
+      out.word(written.id);
+      out.word(parent);
+    }
+    written.visited = visit;
+    for (const auto& child : clique->children) stack.emplace_back(child, written.id);
+  }
+  for (auto it = cliques_.begin(); it != cliques_.end();) {
+    if (it->second.visited == visit) {
+      ++it;
+      continue;
+    }
+    out.word(kRemove);
+    out.word(it->second.id);
+    it = cliques_.erase(it);
+  }
+  out.word(kCliquesEnd);
+  out.word(kEnd);
+
+  Output segment;
+  segment.word(kSegmentTag);
+  segment.word(out.buffer.size());
+  segment.buffer.append(out.buffer);
+  segment.word(out.buffer.size());
+  return segment.buffer;
+}
+
+/* ************************************************************************* */
+ISAM2 ISAM2Checkpoint::Restore(const string& filename,
+                               const ISAM2Params& params) {
+  ifstream file(filename.c_str(), ios::binary | ios::ate);
+  if (!file) throw runtime_error("ISAM2Checkpoint: cannot open " + filename);
+  const size_t size = file.tellg();
+  // Read into doubles, so that the data is aligned
+  vector<double> data((size + 7) / 8);
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(data.data()), size);
+  if (!file) throw runtime_error("ISAM2Checkpoint: cannot read " + filename);
+  return Restore(reinterpret_cast<const char*>(data.data()), size, params);
+}
+
+/* ************************************************************************* */
+ISAM2 ISAM2Checkpoint::Restore(const char* data, size_t size,
+                               const ISAM2Params& params) {
+  Input file(data, size);
+  if (file.remaining() < 24 || file.word() != kFileTag)
+    throw runtime_error("ISAM2Checkpoint: not a checkpoint file");
+  if (file.word() != kByteOrder)
+    throw runtime_error("ISAM2Checkpoint: written with another byte order");
+  if (file.word() != kVersion)
+    throw runtime_error("ISAM2Checkpoint: unsupported version");
+
+  ISAM2 isam(params);
+  map<uint64_t, ReadClique> cliques;
+  size_t segments = 0;
+  while (file.remaining() >= 16) {
+    // Stop at a segment cut short, the rest of the file is not valid
+    Input framing = file;
+    if (framing.word() != kSegmentTag) break;
+    const uint64_t length = framing.word();
+    if (length > framing.remaining() || framing.remaining() - length < 8) break;
+    Input in = framing.sub(length);
+    if (framing.word() != length) break;
+    file = framing;
+    ++segments;
+
+    for (uint64_t record = in.word(); record != kEnd; record = in.word()) {
+      switch (record) {
+        case kScalars: {
+          isam.update_count_ = static_cast<int>(in.word());
+          const bool dogleg = in.word() != 0;
+          const double doglegDelta = in.real();
+          if (dogleg)
+            isam.doglegDelta_ = doglegDelta;
+          else
+            isam.doglegDelta_ = boost::none;
+          isam.variablesAdded_ = in.word();
+          isam.latestTimestamp_ = in.real();
+          isam.nonzeros_ = in.word();
+          isam.reorderedNonzeros_ = in.word();
+          isam.reorderedVariables_ = in.word();
+          break;
+        }
+        case kNonlinear: {
+          KeyVector removedKeys;
+          Values changedValues;
+          uint64_t nrFactors;
+          vector<pair<uint64_t, NonlinearFactor::shared_ptr> > changedFactors;
+          vector<pair<uint64_t, Values> > linearizationPoints;
+          istringstream stream(in.blob());
+          {
+            boost::archive::binary_iarchive archive(stream);
+            archive >> removedKeys >> changedValues >> nrFactors >>
+                changedFactors >> linearizationPoints;
+          }
+          ApplyValueChanges(removedKeys, changedValues, &isam.theta_);
+          isam.nonlinearFactors_.resize(nrFactors);
+          for (const auto& slot_factor : changedFactors)
+            isam.nonlinearFactors_.at(slot_factor.first) = slot_factor.second;
+
+          const map<uint64_t, Values> points(linearizationPoints.begin(),
+                                             linearizationPoints.end());
+          const size_t nrContainers = in.word();
+          for (size_t i = 0; i < nrContainers; ++i) {
+            const size_t slot = in.word();
+            const bool hasPoint = in.word() != 0;
+            const GaussianFactor::shared_ptr factor = ReadFactor(&in);
+            isam.nonlinearFactors_.at(slot) = boost::make_shared<LinearContainerFactor>(
+                factor, hasPoint ? points.at(slot) : Values());
+          }
+          break;
+        }
+        case kLinearFactors: {
+          isam.linearFactors_.resize(in.word());
+          const size_t nrChanged = in.word();
+          for (size_t i = 0; i < nrChanged; ++i) {
+            const size_t slot = in.word();
+            isam.linearFactors_.at(slot) = ReadFactor(&in);
+          }
+          break;
+        }
+        case kDelta: {
+          const uint64_t which = in.word();
+          ReadDelta(&in, which == kDeltaGaussNewton ? &isam.delta_
+                         : which == kDeltaNewton    ? &isam.deltaNewton_
+                                                    : &isam.RgProd_);
+          break;
+        }
+        case kKeySet: {
+          const uint64_t which = in.word();
+          const KeyVector keys = in.keys();
+          KeySet& set = which == kFixedVariables ? isam.fixedVariables_
+                                                 : isam.deltaReplacedMask_;
+          set = KeySet(keys.begin(), keys.end());
+          break;
+        }
+        case kAges: {
+          for (const Key key : in.keys()) isam.variableAges_.erase(key);
+          const size_t nrChanged = in.word();
+          for (size_t i = 0; i < nrChanged; ++i) {
+            const Key key = in.word();
+            const double timestamp = in.real();
+            isam.variableAges_[key] = make_pair(timestamp, in.word());
+          }
+          break;
+        }
+        case kCliques: {
+          for (uint64_t entry = in.word(); entry != kCliquesEnd;
+               entry = in.word()) {
+            const uint64_t id = in.word();
+            if (entry == kRemove) {
+              cliques.erase(id);
+            } else if (entry == kRelink) {
+              cliques.at(id).parent = in.word();
+            } else if (entry == kClique) {
+              ReadClique& clique = cliques[id];
+              clique.parent = in.word();
+              clique.problemSize = static_cast<int>(in.word());
+              clique.conditional = ReadConditional(&in);
+              clique.cachedFactor = ReadFactor(&in);
+              clique.gradientContribution = in.vector();
+            } else {
+              throw runtime_error("ISAM2Checkpoint: unknown clique entry");
+            }
+          }
+          break;
+        }
+        default:
+          throw runtime_error("ISAM2Checkpoint: unknown record");
+      }
+    }
+  }
+  if (segments == 0)
+    throw runtime_error("ISAM2Checkpoint: no complete segment");
+
+  // Derived state
+  isam.variableIndex_ = VariableIndex(isam.nonlinearFactors_);
+  for (const auto& key_age : isam.variableAges_)
+    isam.variablesByAge_.emplace(key_age.second, key_age.first);
+
+  // Link the cliques, parents have lower ids than their children only if
+  // they were written first, so create all cliques before linking them
+  map<uint64_t, ISAM2::sharedClique> created;
+  for (const auto& id_clique : cliques) {
+    auto clique = boost::make_shared<ISAM2Clique>();
+    clique->conditional_ = id_clique.second.conditional;
+    clique->cachedFactor_ = id_clique.second.cachedFactor;
+    clique->gradientContribution_ = id_clique.second.gradientContribution;
+    clique->problemSize_ = id_clique.second.problemSize;
+    for (const Key key : clique->conditional()->frontals())
+      isam.nodes_[key] = clique;
+    created.emplace(id_clique.first, clique);
+  }
+  for (const auto& id_clique : cliques) {
+    const ISAM2::sharedClique& clique = created.at(id_clique.first);
+    if (id_clique.second.parent == 0) {
+      clique->is_root = true;
+      isam.roots_.push_back(clique);
+    } else {
+      const ISAM2::sharedClique& parent = created.at(id_clique.second.parent);
+      clique->parent_ = parent;
+      parent->children.push_back(clique);
+    }
+  }
+  return isam;
+}
+
+}  // namespace gtsam
@@ -0,0 +1,129 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ISAM2Checkpoint.h
+ * @brief   Incremental binary checkpoints of ISAM2
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <boost/weak_ptr.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * @addtogroup ISAM2
+ * Writes the state of an ISAM2 instance to a binary file, so that it can be
+ * restored after a restart without replaying its factors: the linearization
+ * point, the nonlinear and cached linear factors, the Bayes tree with the
+ * cached factors of its cliques, and the deltas.
+ *
+ * The file is a header followed by segments.  The first append() writes all
+ * of the state, every later one only what changed since: new or relinearized
+ * variables and factors, the cliques ISAM2 re-eliminated or split, and the
+ * changed delta entries, which for a typical update is a small part of the
+ * state.  Each segment ends with its length, so a segment cut short by a
+ * crash is ignored and Restore() returns the state of the last complete one.
+ * As the file keeps all segments, rewrite() starts it over with the current
+ * state when it grew too large.
+ *
+ * Linear data, i.e. conditionals, Jacobian and Hessian factors and deltas, is
+ * stored as 8-byte aligned native doubles and keys, read with a single pass
+ * over the file or over memory the caller mapped it into.  Nonlinear factors
+ * and values are polymorphic and stored with boost::serialization binary
+ * archives, so their types need to be exported as for serialize(), except for
+ * the LinearContainerFactors that marginalization adds, whose linear factors
+ * are stored as linear data.  Gaussian factors of other types than Jacobian
+ * and Hessian factors are stored with boost::serialization too.
+ *
+ * ISAM2Params are not stored, as they hold functions, and are passed to
+ * Restore().  The covariance cache and latency histograms are not stored.
+ *
+ * To find what changed, the writer keeps a full copy of the linearization
+ * point and of the three deltas it wrote, which doubles the memory they take,
+ * as well as pointers to the written factors and a few words per written
+ * clique.
+ */
+class GTSAM_EXPORT ISAM2Checkpoint {
+ public:
+  /// Version of the file format written, Restore() reads this version only
+  static const uint64_t kVersion = 1;
+
+ private:
+  /// What was last written about a clique
+  struct WrittenClique {
+    boost::weak_ptr<ISAM2Clique> clique;
+    uint64_t id = 0, parent = 0;
+    const GaussianConditional* conditional = nullptr;
+    Key front = 0;
+    size_t nrFrontals = 0, size = 0;
+    size_t visited = 0;
+  };
+
+  std::string filename_;
+  uint64_t fileSize_ = 0;
+  size_t segments_ = 0;
+
+  // The state as written so far, compared with ISAM2 on every append
+  Values theta_;
+  std::vector<NonlinearFactor::shared_ptr> factors_;
+  std::vector<GaussianFactor::shared_ptr> linearFactors_;
+  VectorValues delta_, deltaNewton_, RgProd_;
+  FastMap<Key, std::pair<double, size_t> > ages_;
+  std::unordered_map<const ISAM2Clique*, WrittenClique> cliques_;
+  uint64_t nextCliqueId_ = 1;
+
+ public:
+  /// Checkpoint to the given file.  The file is left alone until the first
+  /// append(), which replaces it with the full state.
+  explicit ISAM2Checkpoint(const std::string& filename);
+
+  /// Append the changes of isam since the last append() or rewrite(), and
+  /// flush them to the file.  Returns the number of bytes appended.  If the
+  /// write fails, the partial segment is cut off, a std::runtime_error is
+  /// thrown and the next append() rewrites the whole state.
+  size_t append(const ISAM2& isam);
+
+  /// Replace the file with one holding only the current state of isam.  The
+  /// new file is written next to it and renamed over it when complete.
+  void rewrite(const ISAM2& isam);
+
+  /// Size of the file in bytes
+  uint64_t fileSize() const { return fileSize_; }
+
+  /// Number of segments in the file
+  size_t segments() const { return segments_; }
+
+  /// Restore the state of the last complete segment of a checkpoint file
+  static ISAM2 Restore(const std::string& filename,
+                       const ISAM2Params& params = ISAM2Params());
+
+  /// Restore from the contents of a checkpoint file, e.g. mapped into memory.
+  /// data needs to be 8-byte aligned.
+  static ISAM2 Restore(const char* data, size_t size,
+                       const ISAM2Params& params = ISAM2Params());
+
+ private:
+  void reset();
+  std::string segment(const ISAM2& isam);
+};
+
+}  // namespace gtsam
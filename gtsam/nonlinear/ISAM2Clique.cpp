@@ -163,7 +163,9 @@ void ISAM2Clique::fastBackSubstitute(VectorValues* delta) const {
     delta->update(conditional_->solve(*delta));
   }
 #else
-  delta->update(conditional_->solve(*delta));
+  // Write the frontals in place, as ISAM2 may solve other subtrees concurrently
+  for (const auto& frontal : conditional_->solve(*delta))
+    delta->at(frontal.first) = frontal.second;
 #endif
 }
 
@@ -208,7 +210,7 @@ void ISAM2Clique::optimizeWildfire(const KeySet& replaced, double threshold,
 
     // Back-substitute
     fastBackSubstitute(delta);
-    count += conditional_->nrFrontals();
+    *count += conditional_->nrFrontals();
 
     if (valuesChanged(replaced, originalValues, *delta, threshold)) {
       markFrontalsAsChanged(changed);
@@ -245,7 +247,7 @@ bool ISAM2Clique::optimizeWildfireNode(const KeySet& replaced, double threshold,
 
     // Back-substitute
     fastBackSubstitute(delta);
-    count += conditional_->nrFrontals();
+    *count += conditional_->nrFrontals();
 
     if (valuesChanged(replaced, originalValues, *delta, threshold)) {
       markFrontalsAsChanged(changed);
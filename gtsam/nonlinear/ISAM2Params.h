@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <gtsam/base/ThreadPool.h>
+#include <gtsam/inference/Ordering.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/nonlinear/DoglegOptimizerImpl.h>
 #include <boost/variant.hpp>
@@ -125,6 +127,44 @@ struct GTSAM_EXPORT ISAM2DoglegParams {
       const std::string& adaptationMode) const;
 };
 
+/**
+ * @addtogroup ISAM2
+ * Limits on the size of ISAM2, to run it for an unbounded time in bounded
+ * memory.  At every update, the oldest variables beyond any of the limits are
+ * ordered first in the re-eliminated part of the Bayes tree, so that they are
+ * leaves, and then marginalized as in ISAM2::marginalizeLeaves, leaving linear
+ * marginal factors on the variables they were connected to.  A limit of zero
+ * is disabled, which is the default for all of them.
+ *
+ * Variables are marginalized by age: their timestamp from
+ * ISAM2UpdateParams::timestamps, or otherwise the latest timestamp passed
+ * before they were added, and the order in which they were added among those
+ * of equal timestamps.  New factors must not involve marginalized variables.
+ */
+struct GTSAM_EXPORT ISAM2CompactionParams {
+  /// Keep at most this many variables
+  size_t maxVariables = 0;
+
+  /// Keep the estimated footprint, see ISAM2::memoryFootprint, below this many
+  /// bytes, assuming that every variable takes the average footprint
+  size_t maxBytes = 0;
+
+  /// Only keep variables whose timestamp is within this time of the latest
+  /// timestamp
+  double timeHorizon = 0.0;
+
+  /// Whether any limit is set
+  bool enabled() const {
+    return maxVariables > 0 || maxBytes > 0 || timeHorizon > 0.0;
+  }
+
+  void print(const std::string& str = "") const {
+    std::cout << str << "maxVariables: " << maxVariables
+              << ", maxBytes: " << maxBytes << ", timeHorizon: " << timeHorizon
+              << "\n";
+  }
+};
+
 /**
  * @addtogroup ISAM2
  * Parameters for the ISAM2 algorithm.  Default parameter values are listed
@@ -223,6 +263,31 @@ struct GTSAM_EXPORT ISAM2Params {
   /// cost of having to search for slots every time a factor is added.
   bool findUnusedFactorSlots;
 
+  /// Threads used to linearize factors, in a batch update and when
+  /// relinearizing the factors affected by an update, and to back-substitute
+  /// subtrees of the Bayes tree (default: all threads)
+  ParallelOptions parallel;
+
+  /// Limits beyond which update() marginalizes the oldest variables (default:
+  /// none)
+  ISAM2CompactionParams compaction;
+
+  /** Fill-reducing ordering of the variables re-eliminated by an update,
+   * either Ordering::COLAMD, constrained to eliminate the observed variables
+   * last (default), or Ordering::METIS, which is unconstrained and then only
+   * reordered by constraint group.  METIS needs GTSAM to be built with
+   * GTSAM_SUPPORT_NESTED_DISSECTION.
+   */
+  Ordering::OrderingType orderingType;
+
+  /** Reorder and re-eliminate all variables when ISAM2::fillRatio exceeds
+   * this ratio, i.e. when the Bayes tree has this many times the nonzeros per
+   * variable it had after the last full reordering.  Incremental updates only
+   * order the top of the tree, so the global ordering drifts from a
+   * fill-reducing one.  Zero disables it (default: 0).
+   */
+  double reorderThreshold;
+
   /**
    * Specify parameters as constructor arguments
    * See the documentation of member variables above.
@@ -246,7 +311,9 @@ struct GTSAM_EXPORT ISAM2Params {
         keyFormatter(_keyFormatter),
         enableDetailedResults(_enableDetailedResults),
         enablePartialRelinearizationCheck(false),
-        findUnusedFactorSlots(false) {}
+        findUnusedFactorSlots(false),
+        orderingType(Ordering::COLAMD),
+        reorderThreshold(0.0) {}
 
   /// print iSAM2 parameters
   void print(const std::string& str = "") const {
@@ -288,6 +355,12 @@ struct GTSAM_EXPORT ISAM2Params {
          << enablePartialRelinearizationCheck << "\n";
     cout << "findUnusedFactorSlots:             " << findUnusedFactorSlots
          << "\n";
+    cout << "parallel:                          " << parallel.nrThreads
+         << " threads\n";
+    compaction.print("compaction:                        ");
+    cout << "orderingType:                      "
+         << (orderingType == Ordering::METIS ? "METIS" : "COLAMD") << "\n";
+    cout << "reorderThreshold:                  " << reorderThreshold << "\n";
     cout.flush();
   }
 
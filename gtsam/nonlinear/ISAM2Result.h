@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include <gtsam/base/LatencyHistogram.h>
 #include <gtsam/linear/GaussianBayesTree.h>
 #include <gtsam/nonlinear/DoglegOptimizerImpl.h>
 #include <gtsam/nonlinear/ISAM2Params.h>
@@ -90,6 +91,37 @@ struct ISAM2Result {
   /** The number of cliques in the Bayes' Tree */
   size_t cliques;
 
+  /** Whether all variables were reordered and re-eliminated, because of a
+   * large update, ISAM2Params::reorderThreshold or
+   * ISAM2UpdateParams::forceReorder */
+  bool reordered = false;
+
+  /** Wall-clock time in seconds spent relinearizing the factors affected by
+   * this update, split into finding the factors that only involve affected
+   * variables and linearizing those.  Zero if the Bayes tree was not updated
+   * incrementally in this update. */
+  double affectedFactorsTime = 0.0;
+  double relinearizeTime = 0.0;
+
+  /** Wall-clock time in seconds spent in every phase of this update.  These
+   * are always recorded, unlike the gttic/gttoc timing tree, and each ISAM2
+   * object accumulates them into its ISAM2LatencyHistograms. */
+  struct Timing {
+    double updateDelta = 0.0;   ///< Back-substitution before checking relinearization
+    double addVariables = 0.0;  ///< Adding and removing factors, and adding new variables
+    double relinearizeCheck = 0.0;  ///< Marking keys, relinearized ones and their cliques
+    double linearize = 0.0;     ///< Linearizing new factors and relinearizing affected ones
+    double ordering = 0.0;      ///< Ordering the variables to re-eliminate
+    double eliminate = 0.0;     ///< Eliminating and reassembling the top of the Bayes tree
+    double removeVariables = 0.0;  ///< Removing the variables left without factors
+    double estimate = 0.0;      ///< Evaluating the nonlinear error, if enabled
+    double marginalize = 0.0;   ///< Marginalizing variables, see ISAM2Params::compaction
+    double total = 0.0;         ///< The whole update
+  };
+
+  /// Time spent in every phase of this update
+  Timing timing;
+
   /** The indices of the newly-added factors, in 1-to-1 correspondence with the
    * factors passed as \c newFactors to ISAM2::update().  These indices may be
    * used later to refer to the factors in order to remove them.
@@ -101,6 +133,15 @@ struct ISAM2Result {
    */
   KeySet unusedKeys;
 
+  /** Variables marginalized by this update, to keep ISAM2 within the limits
+   * of ISAM2Params::compaction. */
+  KeyVector marginalizedKeys;
+
+  /** Estimated memory footprint in bytes after this update, see
+   * ISAM2::memoryFootprint.  Only computed if ISAM2Params::compaction is
+   * enabled, zero otherwise. */
+  size_t memoryFootprint = 0;
+
   /** keys for variables that were observed, i.e., not unused. */
   KeyVector observedKeys;
 
@@ -180,4 +221,46 @@ struct ISAM2Result {
   double getErrorAfter() const { return errorAfter ? *errorAfter : std::nan(""); }
 };
 
+/**
+ * @addtogroup ISAM2
+ * Cumulative histograms of the time spent in every phase of ISAM2::update, as
+ * recorded in ISAM2Result::timing, to track e.g. the 99th percentile latency.
+ */
+struct GTSAM_EXPORT ISAM2LatencyHistograms {
+  LatencyHistogram updateDelta, addVariables, relinearizeCheck, linearize,
+      ordering, eliminate, removeVariables, estimate, marginalize, total;
+
+  /// Record the phases of one update
+  void record(const ISAM2Result::Timing& timing) {
+    updateDelta.record(timing.updateDelta);
+    addVariables.record(timing.addVariables);
+    relinearizeCheck.record(timing.relinearizeCheck);
+    linearize.record(timing.linearize);
+    ordering.record(timing.ordering);
+    eliminate.record(timing.eliminate);
+    removeVariables.record(timing.removeVariables);
+    estimate.record(timing.estimate);
+    marginalize.record(timing.marginalize);
+    total.record(timing.total);
+  }
+
+  /// Forget all recorded updates
+  void reset() { *this = ISAM2LatencyHistograms(); }
+
+  /// Print the histogram of every phase
+  void print(const std::string& str = "") const {
+    std::cout << str << "ISAM2 update latency:\n";
+    updateDelta.print("  updateDelta:      ");
+    addVariables.print("  addVariables:     ");
+    relinearizeCheck.print("  relinearizeCheck: ");
+    linearize.print("  linearize:        ");
+    ordering.print("  ordering:         ");
+    eliminate.print("  eliminate:        ");
+    removeVariables.print("  removeVariables:  ");
+    estimate.print("  estimate:         ");
+    marginalize.print("  marginalize:      ");
+    total.print("  total:            ");
+  }
+};
+
 }  // namespace gtsam
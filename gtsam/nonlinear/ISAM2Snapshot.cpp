@@ -0,0 +1,27 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ISAM2Snapshot.cpp
+ * @brief   Immutable view of the state of ISAM2, for readers on other threads
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/nonlinear/ISAM2Snapshot.h>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+Matrix ISAM2Snapshot::marginalCovariance(Key key) const {
+  return covarianceCache_.marginalCovariance(bayesTree_, key);
+}
+
+}  // namespace gtsam
@@ -0,0 +1,93 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ISAM2Snapshot.h
+ * @brief   Immutable view of the state of ISAM2, for readers on other threads
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/ISAM2Clique.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/inference/BayesTree.h>
+#include <gtsam/linear/MarginalCovarianceCache.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace gtsam {
+
+/**
+ * @addtogroup ISAM2
+ * The Bayes tree, linearization point and delta of ISAM2 at the time
+ * ISAM2::snapshot was called.  A snapshot does not change afterwards and does
+ * not refer to the ISAM2 object, so any number of threads may query it while
+ * ISAM2::update runs.
+ *
+ * The cliques are copied, as ISAM2 relinks the cliques it keeps when it
+ * re-eliminates the top of the tree, but the conditionals and cached factors,
+ * which ISAM2 never modifies, are shared with it.  Taking a snapshot is thus
+ * O(n) in the number of variables, not a copy-on-write of the changed cliques
+ * only.  Marginal covariances are cached per clique, as in ISAM2, and the cache
+ * may be queried concurrently.
+ */
+class GTSAM_EXPORT ISAM2Snapshot {
+ public:
+  typedef boost::shared_ptr<const ISAM2Snapshot> shared_ptr;
+
+  /// The copy of the Bayes tree of ISAM2
+  class BayesTreeType : public BayesTree<ISAM2Clique> {
+   public:
+    /// Copy the cliques of other
+    explicit BayesTreeType(const BayesTree<ISAM2Clique>& other)
+        : BayesTree<ISAM2Clique>(other) {}
+  };
+
+ private:
+  BayesTreeType bayesTree_;
+  Values theta_;
+  VectorValues delta_;
+  mutable MarginalCovarianceCache<ISAM2Clique> covarianceCache_;
+
+ public:
+  /// Copy the given state, delta must be up to date
+  ISAM2Snapshot(const BayesTree<ISAM2Clique>& bayesTree, const Values& theta,
+                const VectorValues& delta)
+      : bayesTree_(bayesTree), theta_(theta), delta_(delta) {}
+
+  /// The Bayes tree
+  const BayesTreeType& bayesTree() const { return bayesTree_; }
+
+  /// The linearization point
+  const Values& getLinearizationPoint() const { return theta_; }
+
+  /// The complete linear delta
+  const VectorValues& getDelta() const { return delta_; }
+
+  /// Check whether a variable exists
+  bool valueExists(Key key) const { return theta_.exists(key); }
+
+  /// The estimate, see ISAM2::calculateEstimate
+  Values calculateEstimate() const { return theta_.retract(delta_); }
+
+  /// The estimate of a single variable
+  template <class VALUE>
+  VALUE calculateEstimate(Key key) const {
+    return traits<VALUE>::Retract(theta_.at<VALUE>(key), delta_[key]);
+  }
+
+  /// The marginal covariance of a variable, see ISAM2::marginalCovariance
+  Matrix marginalCovariance(Key key) const;
+};
+
+}  // namespace gtsam
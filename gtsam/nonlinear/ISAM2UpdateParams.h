@@ -69,6 +69,15 @@ struct ISAM2UpdateParams {
    * the deltas become too small down in the tree. This flagg forces a full
    * solve instead. */
   bool forceFullSolve{false};
+
+  /** Reorder and re-eliminate all variables, as when ISAM2::fillRatio exceeds
+   * ISAM2Params::reorderThreshold. */
+  bool forceReorder{false};
+
+  /** An optional map of keys, new or existing, to timestamps, which
+   * ISAM2Params::compaction uses to decide which variables are old enough to
+   * be marginalized. */
+  boost::optional<FastMap<Key, double>> timestamps{boost::none};
 };
 
 }  // namespace gtsam
@@ -29,6 +29,7 @@
 #include <gtsam/base/timing.h>
 
 #include <boost/format.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 #include <boost/range/adaptor/map.hpp>
 
@@ -50,7 +51,8 @@ LevenbergMarquardtOptimizer::LevenbergMarquardtOptimizer(const NonlinearFactorGr
                                                          const Values& initialValues,
                                                          const LevenbergMarquardtParams& params)
     : NonlinearOptimizer(
-          graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues),
+          graph, std::unique_ptr<State>(new State(initialValues,
+                                                  graph.error(initialValues, params.parallel),
                                                   params.lambdaInitial, params.lambdaFactor))),
       params_(LevenbergMarquardtParams::EnsureHasOrdering(params, graph)) {}
 
@@ -59,7 +61,8 @@ LevenbergMarquardtOptimizer::LevenbergMarquardtOptimizer(const NonlinearFactorGr
                                                          const Ordering& ordering,
                                                          const LevenbergMarquardtParams& params)
     : NonlinearOptimizer(
-          graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues),
+          graph, std::unique_ptr<State>(new State(initialValues,
+                                                  graph.error(initialValues, params.parallel),
                                                   params.lambdaInitial, params.lambdaFactor))),
       params_(LevenbergMarquardtParams::ReplaceOrdering(params, ordering)) {}
 
@@ -82,7 +85,12 @@ int LevenbergMarquardtOptimizer::getInnerIterations() const {
 
 /* ************************************************************************* */
 GaussianFactorGraph::shared_ptr LevenbergMarquardtOptimizer::linearize() const {
-  return graph_.linearize(state_->values);
+  // The graph does not change, so relinearize into the factors of the previous iteration,
+  // unless the caller of iterate() still holds on to them
+  if (!linear_ || !linear_.unique())
+    linear_ = boost::make_shared<GaussianFactorGraph>();
+  graph_.linearizeInto(state_->values, *linear_, params_.parallel);
+  return linear_;
 }
 
 /* ************************************************************************* */
@@ -140,7 +148,6 @@ bool LevenbergMarquardtOptimizer::tryLambda(const GaussianFactorGraph& linear,
   bool step_is_successful = false;
   bool stopSearchingLambda = false;
   double newError = numeric_limits<double>::infinity(), costChange;
-  Values newValues;
   VectorValues delta;
 
   bool systemSolvedSuccessfully;
@@ -173,7 +180,9 @@ bool LevenbergMarquardtOptimizer::tryLambda(const GaussianFactorGraph& linear,
       // update values
       gttic(retract);
       // ============ This is where the solution is updated ====================
-      newValues = currentState->values.retract(delta);
+      // Copying into trialValues_ assigns the values in place once it has the right structure
+      trialValues_ = currentState->values;
+      trialValues_.retractInPlace(delta, params_.parallel);
       // =======================================================================
       gttoc(retract);
 
@@ -181,7 +190,7 @@ bool LevenbergMarquardtOptimizer::tryLambda(const GaussianFactorGraph& linear,
       gttic(compute_error);
       if (verbose)
         cout << "calculating error:" << endl;
-      newError = graph_.error(newValues);
+      newError = graph_.error(trialValues_, params_.parallel);
       gttoc(compute_error);
 
       if (verbose)
@@ -231,9 +240,12 @@ bool LevenbergMarquardtOptimizer::tryLambda(const GaussianFactorGraph& linear,
 
   if (step_is_successful) {
     // we have successfully decreased the cost and we have good modelFidelity
-    // NOTE(frank): As we return immediately after this, we move the newValues
-    // TODO(frank): make Values actually support move. Does not seem to happen now.
-    state_ = currentState->decreaseLambda(params_, modelFidelity, std::move(newValues), newError);
+    // The new state takes over the trial values, and the values it replaces become the storage
+    // for the next trials
+    std::unique_ptr<State> newState =
+        currentState->decreaseLambda(params_, modelFidelity, std::move(trialValues_), newError);
+    trialValues_ = std::move(state_->values);
+    state_ = std::move(newState);
     return true;
   } else if (!stopSearchingLambda) {  // we failed to solved the system or had no decrease in cost
     if (verbose)
@@ -37,6 +37,8 @@ class GTSAM_EXPORT LevenbergMarquardtOptimizer: public NonlinearOptimizer {
 protected:
   const LevenbergMarquardtParams params_; ///< LM parameters
   boost::posix_time::ptime startTime_;
+  Values trialValues_; ///< Storage for the values tried by tryLambda, reused across iterations
+  mutable GaussianFactorGraph::shared_ptr linear_; ///< Previous linearization, relinearized in place
 
   void initTime();
 
@@ -127,7 +127,14 @@ Matrix Marginals::marginalInformation(Key variable) const {
 
 /* ************************************************************************* */
 Matrix Marginals::marginalCovariance(Key variable) const {
-  return marginalInformation(variable).inverse();
+  gttic(marginalCovariance);
+  return covarianceCache_.marginalCovariance(bayesTree_, variable);
+}
+
+/* ************************************************************************* */
+FastMap<Key, Matrix> Marginals::marginalCovariances(const KeyVector& variables) const {
+  gttic(marginalCovariances);
+  return covarianceCache_.marginalCovariances(bayesTree_, variables);
 }
 
 /* ************************************************************************* */
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/MarginalCovarianceCache.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/Values.h>
 
@@ -46,6 +47,9 @@ protected:
   Factorization factorization_;
   GaussianBayesTree bayesTree_;
 
+  /// Covariances of the cliques visited by marginalCovariance
+  mutable MarginalCovarianceCache<GaussianBayesTreeClique> covarianceCache_;
+
 public:
 
   /// Default constructor only for wrappers
@@ -110,9 +114,14 @@ public:
     * Use LLt(const Matrix&) or RtR(const Matrix&) to obtain the square-root information matrix. */
   Matrix marginalInformation(Key variable) const;
 
-  /** Compute the marginal covariance of a single variable */
+  /** Compute the marginal covariance of a single variable. The covariances of
+   * the cliques from the root to the variable are cached for later calls. */
   Matrix marginalCovariance(Key variable) const;
 
+  /** Compute the marginal covariances of several variables, sharing the work
+   * on the cliques they have in common */
+  FastMap<Key, Matrix> marginalCovariances(const KeyVector& variables) const;
+
   /** Compute the joint marginal covariance of several variables */
   JointMarginal jointMarginalCovariance(const KeyVector& variables) const;
 
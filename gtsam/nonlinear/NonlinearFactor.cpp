@@ -20,6 +20,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/format.hpp>
 
+#include <typeinfo>
+
 namespace gtsam {
 
 /* ************************************************************************* */
@@ -129,6 +131,27 @@ double NoiseModelFactor::error(const Values& c) const {
   }
 }
 
+/* ************************************************************************* */
+// Create a JacobianFactor from a whitened system, taking over the matrices in A
+static GaussianFactor::shared_ptr createJacobianFactor(const KeyVector& keys,
+    std::vector<Matrix>& A, const Vector& b, const SharedNoiseModel& noiseModel) {
+  // Fill in terms, needed to create JacobianFactor below
+  std::vector<std::pair<Key, Matrix> > terms(keys.size());
+  for (size_t j = 0; j < keys.size(); ++j) {
+    terms[j].first = keys[j];
+    terms[j].second.swap(A[j]);
+  }
+
+  // TODO pass unwhitened + noise model to Gaussian factor
+  using noiseModel::Constrained;
+  if (noiseModel && noiseModel->isConstrained())
+    return GaussianFactor::shared_ptr(
+        new JacobianFactor(terms, b,
+            boost::static_pointer_cast<Constrained>(noiseModel)->unit()));
+  else
+    return GaussianFactor::shared_ptr(new JacobianFactor(terms, b));
+}
+
 /* ************************************************************************* */
 boost::shared_ptr<GaussianFactor> NoiseModelFactor::linearize(
     const Values& x) const {
@@ -146,21 +169,51 @@ boost::shared_ptr<GaussianFactor> NoiseModelFactor::linearize(
   if (noiseModel_)
     noiseModel_->WhitenSystem(A, b);
 
-  // Fill in terms, needed to create JacobianFactor below
-  std::vector<std::pair<Key, Matrix> > terms(size());
-  for (size_t j = 0; j < size(); ++j) {
-    terms[j].first = keys()[j];
-    terms[j].second.swap(A[j]);
+  return createJacobianFactor(keys(), A, b, noiseModel_);
+}
+
+/* ************************************************************************* */
+void NoiseModelFactor::linearizeInto(const Values& x,
+    boost::shared_ptr<GaussianFactor>& linearized) const {
+
+  // Factors that may override linearize() always go through it
+  if (!linearizesInPlace()) {
+    linearized = linearize(x);
+    return;
   }
 
-  // TODO pass unwhitened + noise model to Gaussian factor
-  using noiseModel::Constrained;
-  if (noiseModel_ && noiseModel_->isConstrained())
-    return GaussianFactor::shared_ptr(
-        new JacobianFactor(terms, b,
-            boost::static_pointer_cast<Constrained>(noiseModel_)->unit()));
-  else
-    return GaussianFactor::shared_ptr(new JacobianFactor(terms, b));
+  // Only reuse plain JacobianFactors without a noise model that nobody else refers to
+  JacobianFactor* jacobian = nullptr;
+  if (linearized && linearized.unique() && typeid(*linearized) == typeid(JacobianFactor) &&
+      !(noiseModel_ && noiseModel_->isConstrained()))
+    jacobian = static_cast<JacobianFactor*>(linearized.get());
+  if (!jacobian || jacobian->get_model() || jacobian->keys() != keys() || !active(x)) {
+    linearized = linearize(x);
+    return;
+  }
+
+  // Call evaluate error to get Jacobians and RHS vector b.  The Jacobians go into matrices
+  // kept per thread, which are only reallocated when the dimensions of the factors change.
+  static thread_local std::vector<Matrix> A;
+  A.resize(size());
+  Vector b = -unwhitenedError(x, A);
+  check(noiseModel_, b.size());
+
+  // Whiten the corresponding system now
+  if (noiseModel_)
+    noiseModel_->WhitenSystem(A, b);
+
+  // Write the system into the existing matrix, unless the dimensions changed
+  bool sameShape = jacobian->rows() == static_cast<size_t>(b.size());
+  for (size_t j = 0; sameShape && j < size(); ++j)
+    sameShape = jacobian->getDim(jacobian->begin() + j) == A[j].cols();
+  if (!sameShape) {
+    linearized = createJacobianFactor(keys(), A, b, noiseModel_);
+    return;
+  }
+  for (size_t j = 0; j < size(); ++j)
+    jacobian->getA(jacobian->begin() + j) = A[j];
+  jacobian->getb() = b;
 }
 
 /* ************************************************************************* */
@@ -109,6 +109,16 @@ public:
   virtual boost::shared_ptr<GaussianFactor>
   linearize(const Values& c) const = 0;
 
+  /**
+   * Linearize into \c linearized, which may hold the linearization of this factor at other
+   * values, e.g. from the previous iteration of an optimizer.  Derived classes can reuse its
+   * storage, the default implementation replaces it with linearize(c).
+   */
+  virtual void linearizeInto(const Values& c,
+                             boost::shared_ptr<GaussianFactor>& linearized) const {
+    linearized = linearize(c);
+  }
+
   /**
    * Creates a shared_ptr clone of the factor - needs to be specialized to allow
    * for subclasses
@@ -244,6 +254,23 @@ public:
    */
   boost::shared_ptr<GaussianFactor> linearize(const Values& x) const override;
 
+  /**
+   * Linearize into \c linearized.  If linearizesInPlace(), the whitened system is written into
+   * its matrix if it is a JacobianFactor of the same shape that is not shared with anyone else.
+   * Otherwise, and for constrained noise models, \c linearized is replaced by linearize(x).
+   * Reusing the factor, only the error vector returned by unwhitenedError is allocated.
+   */
+  void linearizeInto(const Values& x,
+                     boost::shared_ptr<GaussianFactor>& linearized) const override;
+
+ protected:
+  /**
+   * Whether linearizeInto may write into the previous linearization instead of calling
+   * linearize().  Only return true from classes whose linearization is the one of
+   * NoiseModelFactor::linearize, i.e., that do not override linearize().
+   */
+  virtual bool linearizesInPlace() const { return false; }
+
  private:
   /** Serialization function */
   friend class boost::serialization::access;
@@ -29,18 +29,22 @@
 #include <gtsam/inference/FactorGraph-inst.h>
 #include <gtsam/config.h> // for GTSAM_USE_TBB
 
-#ifdef GTSAM_USE_TBB
-#  include <tbb/parallel_for.h>
-#endif
-
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <limits>
+#include <memory>
 
 using namespace std;
 
 namespace gtsam {
 
+// Most factors are cheap to evaluate, so loops over factors are not split into tinier chunks
+static const size_t kMinimumGrain = 64;
+
+// Memory for the Hessians of all chunks linearized by linearizeToHessianFactor in parallel
+static const size_t kMaxPartialHessianBytes = size_t(256) << 20;
+
 // Instantiate base classes
 template class FactorGraph<NonlinearFactor>;
 
@@ -268,15 +272,91 @@ void NonlinearFactorGraph::saveGraph(
 }
 
 /* ************************************************************************* */
-double NonlinearFactorGraph::error(const Values& values) const {
+double NonlinearFactorGraph::error(const Values& values,
+                                   const ParallelOptions& parallel) const {
   gttic(NonlinearFactorGraph_error);
-  double total_error = 0.;
-  // iterate over all the factors_ to accumulate the log probabilities
-  for(const sharedFactor& factor: factors_) {
-    if(factor)
-      total_error += factor->error(values);
+  // accumulate the log probabilities of chunks of factors_ in parallel
+  return parallelReduce(0, size(), 0.0,
+      [&](size_t first, size_t last, double total_error) {
+        for (size_t i = first; i < last; ++i)
+          if (factors_[i])
+            total_error += factors_[i]->error(values);
+        return total_error;
+      },
+      std::plus<double>(), parallel.resolved(size(), kMinimumGrain));
+}
+
+/* ************************************************************************* */
+namespace {
+  const NoiseModelFactor& asNoiseModelFactor(const NonlinearFactor& factor) {
+    const NoiseModelFactor* noiseModelFactor = dynamic_cast<const NoiseModelFactor*>(&factor);
+    if (!noiseModelFactor)
+      throw invalid_argument(
+          "NonlinearFactorGraph: per-factor errors require NoiseModelFactors");
+    return *noiseModelFactor;
   }
-  return total_error;
+}
+
+/* ************************************************************************* */
+void NonlinearFactorGraph::stackErrors(const Values& values, Vector& errors,
+                                       const ParallelOptions& parallel,
+                                       bool whiten) const {
+  gttic(NonlinearFactorGraph_stackErrors);
+  // row offsets of the factors, checking their types before evaluating anything
+  std::vector<size_t> offsets(size() + 1, 0);
+  for (size_t i = 0; i < size(); ++i)
+    offsets[i + 1] =
+        offsets[i] + (factors_[i] ? asNoiseModelFactor(*factors_[i]).dim() : 0);
+  if (errors.size() != static_cast<Eigen::Index>(offsets.back()))
+    errors.resize(offsets.back());
+
+  parallelFor(0, size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      if (!factors_[i]) continue;
+      const auto& factor = static_cast<const NoiseModelFactor&>(*factors_[i]);
+      auto rows = errors.segment(offsets[i], offsets[i + 1] - offsets[i]);
+      if (!factor.active(values)) {
+        rows.setZero();
+        continue;
+      }
+      // whiten the error where it was evaluated, so it is only copied once into the stack
+      Vector e = factor.unwhitenedError(values);
+      if (e.size() != rows.size())
+        throw invalid_argument(
+            "NonlinearFactorGraph: a factor's error does not match its dimension");
+      if (whiten && factor.noiseModel()) factor.noiseModel()->whitenInPlace(e);
+      rows = e;
+    }
+  }, parallel.resolved(size(), kMinimumGrain));
+}
+
+/* ************************************************************************* */
+void NonlinearFactorGraph::unwhitenedErrors(const Values& values, Vector& errors,
+                                            const ParallelOptions& parallel) const {
+  stackErrors(values, errors, parallel, false);
+}
+
+/* ************************************************************************* */
+void NonlinearFactorGraph::whitenedErrors(const Values& values, Vector& errors,
+                                          const ParallelOptions& parallel) const {
+  stackErrors(values, errors, parallel, true);
+}
+
+/* ************************************************************************* */
+void NonlinearFactorGraph::weights(const Values& values, Vector& weights,
+                                   const ParallelOptions& parallel) const {
+  gttic(NonlinearFactorGraph_weights);
+  for (const sharedFactor& factor : factors_)
+    if (factor) asNoiseModelFactor(*factor);
+  if (weights.size() != static_cast<Eigen::Index>(size()))
+    weights.resize(size());
+
+  parallelFor(0, size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      weights(i) = factors_[i]
+          ? static_cast<const NoiseModelFactor&>(*factors_[i]).weight(values)
+          : 0.0;
+  }, parallel.resolved(size(), kMinimumGrain));
 }
 
 /* ************************************************************************* */
@@ -309,63 +389,44 @@ SymbolicFactorGraph::shared_ptr NonlinearFactorGraph::symbolic() const
 }
 
 /* ************************************************************************* */
-namespace {
-
-#ifdef GTSAM_USE_TBB
-class _LinearizeOneFactor {
-  const NonlinearFactorGraph& nonlinearGraph_;
-  const Values& linearizationPoint_;
-  GaussianFactorGraph& result_;
-public:
-  // Create functor with constant parameters
-  _LinearizeOneFactor(const NonlinearFactorGraph& graph,
-      const Values& linearizationPoint, GaussianFactorGraph& result) :
-      nonlinearGraph_(graph), linearizationPoint_(linearizationPoint), result_(result) {
-  }
-  // Operator that linearizes a given range of the factors
-  void operator()(const tbb::blocked_range<size_t>& blocked_range) const {
-    for (size_t i = blocked_range.begin(); i != blocked_range.end(); ++i) {
-      if (nonlinearGraph_[i])
-        result_[i] = nonlinearGraph_[i]->linearize(linearizationPoint_);
-      else
-        result_[i] = GaussianFactor::shared_ptr();
-    }
-  }
-};
-#endif
-
-}
-
-/* ************************************************************************* */
-GaussianFactorGraph::shared_ptr NonlinearFactorGraph::linearize(const Values& linearizationPoint) const
+GaussianFactorGraph::shared_ptr NonlinearFactorGraph::linearize(
+    const Values& linearizationPoint, const ParallelOptions& parallel) const
 {
   gttic(NonlinearFactorGraph_linearize);
 
-  // create an empty linear FG
+  // create an empty linear FG, with a slot for every factor
   GaussianFactorGraph::shared_ptr linearFG = boost::make_shared<GaussianFactorGraph>();
-
-#ifdef GTSAM_USE_TBB
-
   linearFG->resize(size());
-  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
-  tbb::parallel_for(tbb::blocked_range<size_t>(0, size()),
-    _LinearizeOneFactor(*this, linearizationPoint, *linearFG));
 
-#else
+  // linearize all factors, null factors stay null
+  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
+  parallelFor(0, size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      if (factors_[i])
+        (*linearFG)[i] = factors_[i]->linearize(linearizationPoint);
+  }, parallel);
 
-  linearFG->reserve(size());
+  return linearFG;
+}
 
-  // linearize all factors
-  for(const sharedFactor& factor: factors_) {
-    if(factor) {
-      (*linearFG) += factor->linearize(linearizationPoint);
-    } else
-    (*linearFG) += GaussianFactor::shared_ptr();
-  }
+/* ************************************************************************* */
+void NonlinearFactorGraph::linearizeInto(const Values& linearizationPoint,
+    GaussianFactorGraph& linearFG, const ParallelOptions& parallel) const
+{
+  gttic(NonlinearFactorGraph_linearizeInto);
 
-#endif
+  // make a slot for every factor, new slots are empty
+  linearFG.resize(size());
 
-  return linearFG;
+  // linearize all factors into their slot, null factors leave the slot empty
+  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
+  parallelFor(0, size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      if (factors_[i])
+        factors_[i]->linearizeInto(linearizationPoint, linearFG[i]);
+      else
+        linearFG[i].reset();
+  }, parallel);
 }
 
 /* ************************************************************************* */
@@ -401,20 +462,55 @@ static Scatter scatterFromValues(const Values& values, const Ordering& ordering)
 
 /* ************************************************************************* */
 HessianFactor::shared_ptr NonlinearFactorGraph::linearizeToHessianFactor(
-    const Values& values, const Scatter& scatter, const Dampen& dampen) const {
+    const Values& values, const Scatter& scatter, const Dampen& dampen,
+    const ParallelOptions& parallel) const {
   // NOTE(frank): we are heavily leaning on friendship below
   HessianFactor::shared_ptr hessianFactor(new HessianFactor(scatter));
 
   // Initialize so we can rank-update below
   hessianFactor->info_.setZero();
 
-  // linearize all factors straight into the Hessian
+  // Every chunk of factors is linearized into a Hessian of its own, so use as few chunks as
+  // there are threads, or a fixed number of chunks if the result has to be deterministic, and
+  // no more than fit in kMaxPartialHessianBytes.
+  const SymmetricBlockMatrix& info = hessianFactor->info_;
+  const size_t infoBytes = sizeof(double) * info.rows() * info.cols();
+  const size_t maxChunks =
+      std::max<size_t>(1, kMaxPartialHessianBytes / std::max<size_t>(infoBytes, 1));
+  const size_t nrChunks = std::min(parallel.deterministic ? 8 : parallel.threads(), maxChunks);
+  const size_t grain = parallel.grainSize > 0
+                           ? parallel.grainSize
+                           : std::max(kMinimumGrain, (size() + nrChunks - 1) / nrChunks);
+  const ParallelOptions chunked(parallel.nrThreads, grain, parallel.deterministic);
+
+  // linearize all factors straight into the Hessian of their chunk, and sum those
   // TODO(frank): this saves on creating the graph, but still mallocs a gaussianFactor!
-  for (const sharedFactor& nonlinearFactor : factors_) {
-    if (nonlinearFactor) {
-      const auto& gaussianFactor = nonlinearFactor->linearize(values);
-      gaussianFactor->updateHessian(hessianFactor->keys_, &hessianFactor->info_);
-    }
+  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
+  if (grain >= size()) {
+    // A single chunk is linearized straight into the result
+    for (const sharedFactor& factor : factors_)
+      if (factor)
+        factor->linearize(values)->updateHessian(hessianFactor->keys_, &hessianFactor->info_);
+  } else {
+    typedef std::shared_ptr<SymmetricBlockMatrix> SharedInfo;
+    const SharedInfo sum = parallelReduce(0, size(), SharedInfo(),
+        [&](size_t first, size_t last, SharedInfo partial) {
+          if (!partial) partial = std::make_shared<SymmetricBlockMatrix>(info);
+          for (size_t i = first; i < last; ++i) {
+            if (factors_[i]) {
+              const auto& gaussianFactor = factors_[i]->linearize(values);
+              gaussianFactor->updateHessian(hessianFactor->keys_, partial.get());
+            }
+          }
+          return partial;
+        },
+        [](const SharedInfo& a, const SharedInfo& b) {
+          if (!a) return b;
+          if (b) a->addFullMatrix(*b);
+          return a;
+        },
+        chunked);
+    if (sum) hessianFactor->info_ = std::move(*sum);
   }
 
   if (dampen) dampen(hessianFactor);
@@ -424,27 +520,29 @@ HessianFactor::shared_ptr NonlinearFactorGraph::linearizeToHessianFactor(
 
 /* ************************************************************************* */
 HessianFactor::shared_ptr NonlinearFactorGraph::linearizeToHessianFactor(
-    const Values& values, const Ordering& order, const Dampen& dampen) const {
+    const Values& values, const Ordering& order, const Dampen& dampen,
+    const ParallelOptions& parallel) const {
   gttic(NonlinearFactorGraph_linearizeToHessianFactor);
 
   Scatter scatter = scatterFromValues(values, order);
-  return linearizeToHessianFactor(values, scatter, dampen);
+  return linearizeToHessianFactor(values, scatter, dampen, parallel);
 }
 
 /* ************************************************************************* */
 HessianFactor::shared_ptr NonlinearFactorGraph::linearizeToHessianFactor(
-    const Values& values, const Dampen& dampen) const {
+    const Values& values, const Dampen& dampen, const ParallelOptions& parallel) const {
   gttic(NonlinearFactorGraph_linearizeToHessianFactor);
 
   Scatter scatter = scatterFromValues(values);
-  return linearizeToHessianFactor(values, scatter, dampen);
+  return linearizeToHessianFactor(values, scatter, dampen, parallel);
 }
 
 /* ************************************************************************* */
 Values NonlinearFactorGraph::updateCholesky(const Values& values,
-                                            const Dampen& dampen) const {
+                                            const Dampen& dampen,
+                                            const ParallelOptions& parallel) const {
   gttic(NonlinearFactorGraph_updateCholesky);
-  auto hessianFactor = linearizeToHessianFactor(values, dampen);
+  auto hessianFactor = linearizeToHessianFactor(values, dampen, parallel);
   VectorValues delta = hessianFactor->solve();
   return values.retract(delta);
 }
@@ -452,9 +550,10 @@ Values NonlinearFactorGraph::updateCholesky(const Values& values,
 /* ************************************************************************* */
 Values NonlinearFactorGraph::updateCholesky(const Values& values,
                                             const Ordering& ordering,
-                                            const Dampen& dampen) const {
+                                            const Dampen& dampen,
+                                            const ParallelOptions& parallel) const {
   gttic(NonlinearFactorGraph_updateCholesky);
-  auto hessianFactor = linearizeToHessianFactor(values, ordering, dampen);
+  auto hessianFactor = linearizeToHessianFactor(values, ordering, dampen, parallel);
   VectorValues delta = hessianFactor->solve();
   return values.retract(delta);
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <gtsam/geometry/Point2.h>
+#include <gtsam/base/ThreadPool.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
 #include <gtsam/inference/FactorGraph.h>
 #include <gtsam/nonlinear/PriorFactor.h>
@@ -126,8 +127,34 @@ namespace gtsam {
       const GraphvizFormatting& graphvizFormatting = GraphvizFormatting(),
       const KeyFormatter& keyFormatter = DefaultKeyFormatter) const;
 
-    /** unnormalized error, \f$ 0.5 \sum_i (h_i(X_i)-z)^2/\sigma^2 \f$ in the most common case */
-    double error(const Values& values) const;
+    /**
+     * unnormalized error, \f$ 0.5 \sum_i (h_i(X_i)-z)^2/\sigma^2 \f$ in the most common case.
+     * Factors are evaluated in parallel as configured by \c parallel.
+     */
+    double error(const Values& values,
+                 const ParallelOptions& parallel = ParallelOptions()) const;
+
+    /**
+     * Unwhitened errors \f$ h_i(X_i)-z_i \f$ of all factors, stacked in factor order into
+     * \c errors, which is only reallocated if its size changes.  Every factor takes dim() rows,
+     * null factors take none and inactive factors are zero.  Factors are evaluated in parallel
+     * as configured by \c parallel.  Throws std::invalid_argument if a factor is not a
+     * NoiseModelFactor.
+     */
+    void unwhitenedErrors(const Values& values, Vector& errors,
+                          const ParallelOptions& parallel = ParallelOptions()) const;
+
+    /// Whitened errors of all factors, stacked as in unwhitenedErrors
+    void whitenedErrors(const Values& values, Vector& errors,
+                        const ParallelOptions& parallel = ParallelOptions()) const;
+
+    /**
+     * Effective weights NoiseModelFactor::weight of all factors, one entry per factor and zero
+     * for null factors, e.g. to recompute the weights of robust noise models.  Evaluated in
+     * parallel and reallocated as in unwhitenedErrors.
+     */
+    void weights(const Values& values, Vector& weights,
+                 const ParallelOptions& parallel = ParallelOptions()) const;
 
     /** Unnormalized probability. O(n) */
     double probPrime(const Values& values) const;
@@ -152,8 +179,19 @@ namespace gtsam {
      */
     Ordering orderingCOLAMDConstrained(const FastMap<Key, int>& constraints) const;
 
-    /// Linearize a nonlinear factor graph
-    boost::shared_ptr<GaussianFactorGraph> linearize(const Values& linearizationPoint) const;
+    /// Linearize a nonlinear factor graph, in parallel as configured by \c parallel
+    boost::shared_ptr<GaussianFactorGraph> linearize(const Values& linearizationPoint,
+        const ParallelOptions& parallel = ParallelOptions()) const;
+
+    /**
+     * Linearize into \c linearFG, typically the linearization of this graph at other values.
+     * Factor i is linearized into slot i with NonlinearFactor::linearizeInto, which reuses the
+     * storage of the previous JacobianFactor if the shape of the factor did not change.  This
+     * avoids allocating a new GaussianFactorGraph in every iteration of an optimizer.
+     * Factors are linearized in parallel as configured by \c parallel.
+     */
+    void linearizeInto(const Values& linearizationPoint, GaussianFactorGraph& linearFG,
+        const ParallelOptions& parallel = ParallelOptions()) const;
 
     /// typdef for dampen functions used below
     typedef std::function<void(const boost::shared_ptr<HessianFactor>& hessianFactor)> Dampen;
@@ -163,10 +201,15 @@ namespace gtsam {
      * into a HessianFactor. Avoids the many mallocs and pointer indirection in constructing
      * a new graph, and hence useful in case a dense solve is appropriate for your problem.
      * An optional lambda function can be used to apply damping on the filled Hessian.
-     * No parallelism is exploited, because all the factors write in the same memory.
+     * As all factors write into the same Hessian, chunks of factors are linearized in parallel
+     * into dense Hessians of their own, which are summed afterwards.  This is off by default,
+     * as every chunk costs a copy of the Hessian, and pays off if the factors are expensive
+     * compared to adding Hessians, e.g. for small dense problems with many factors.  Pass e.g.
+     * ParallelOptions() as \c parallel to use all threads.  The copies are limited to 256 MB.
      */
     boost::shared_ptr<HessianFactor> linearizeToHessianFactor(
-        const Values& values, const Dampen& dampen = nullptr) const;
+        const Values& values, const Dampen& dampen = nullptr,
+        const ParallelOptions& parallel = ParallelOptions::Serial()) const;
 
     /**
      * Instead of producing a GaussianFactorGraph, pre-allocate and linearize directly
@@ -174,20 +217,23 @@ namespace gtsam {
      * a new graph, and hence useful in case a dense solve is appropriate for your problem.
      * An ordering is given that still decides how the Hessian is laid out.
      * An optional lambda function can be used to apply damping on the filled Hessian.
-     * No parallelism is exploited, because all the factors write in the same memory.
+     * Factors are linearized in parallel as in linearizeToHessianFactor(values, dampen, parallel).
      */
     boost::shared_ptr<HessianFactor> linearizeToHessianFactor(
-        const Values& values, const Ordering& ordering, const Dampen& dampen = nullptr) const;
+        const Values& values, const Ordering& ordering, const Dampen& dampen = nullptr,
+        const ParallelOptions& parallel = ParallelOptions::Serial()) const;
 
     /// Linearize and solve in one pass.
     /// Calls linearizeToHessianFactor, densely solves the normal equations, and updates the values.
     Values updateCholesky(const Values& values,
-                          const Dampen& dampen = nullptr) const;
+                          const Dampen& dampen = nullptr,
+                          const ParallelOptions& parallel = ParallelOptions::Serial()) const;
 
     /// Linearize and solve in one pass.
     /// Calls linearizeToHessianFactor, densely solves the normal equations, and updates the values.
     Values updateCholesky(const Values& values, const Ordering& ordering,
-                          const Dampen& dampen = nullptr) const;
+                          const Dampen& dampen = nullptr,
+                          const ParallelOptions& parallel = ParallelOptions::Serial()) const;
 
     /// Clone() performs a deep-copy of the graph, including all of the factors
     NonlinearFactorGraph clone() const;
@@ -249,7 +295,12 @@ namespace gtsam {
      *  it doesn't include gttic.
      */
     boost::shared_ptr<HessianFactor> linearizeToHessianFactor(
-        const Values& values, const Scatter& scatter, const Dampen& dampen = nullptr) const;
+        const Values& values, const Scatter& scatter, const Dampen& dampen,
+        const ParallelOptions& parallel) const;
+
+    /// Implementation of unwhitenedErrors and whitenedErrors
+    void stackErrors(const Values& values, Vector& errors, const ParallelOptions& parallel,
+                     bool whiten) const;
 
     /** Serialization function */
     friend class boost::serialization::access;
@@ -22,12 +22,16 @@
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/linear/SubgraphSolver.h>
 #include <gtsam/linear/PCGSolver.h>
+#include <gtsam/linear/SparseCholeskySolver.h>
+#include <gtsam/linear/SchurComplementSolver.h>
+#include <gtsam/linear/MultifrontalSolver.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/VectorValues.h>
 
 #include <gtsam/inference/Ordering.h>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include <stdexcept>
@@ -139,11 +143,15 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
 
   // Check which solver we are using
   if (params.isMultifrontal()) {
-    // Multifrontal QR or Cholesky (decided by params.getEliminationFunction())
+    // Multifrontal QR or Cholesky (decided by params.getEliminationFunction()), the ordering
+    // and junction tree are cached
+    if (!multifrontalSolver_)
+      multifrontalSolver_ = boost::make_shared<MultifrontalSolver>();
     if (params.ordering)
-      delta = gfg.optimize(*params.ordering, params.getEliminationFunction());
+      delta = multifrontalSolver_->optimize(gfg, *params.ordering, params.getEliminationFunction());
     else
-      delta = gfg.optimize(params.getEliminationFunction());
+      delta = multifrontalSolver_->optimize(gfg, params.orderingType,
+                                            params.getEliminationFunction());
   } else if (params.isSequential()) {
     // Sequential QR or Cholesky (decided by params.getEliminationFunction())
     if (params.ordering)
@@ -152,6 +160,19 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
     else
       delta = gfg.eliminateSequential(params.getEliminationFunction(), boost::none,
                                       params.orderingType)->optimize();
+  } else if (params.isCholmod()) {
+    // Sparse Cholesky on the assembled Hessian, symbolic analysis is cached
+    if (!sparseSolver_)
+      sparseSolver_ = boost::make_shared<SparseCholeskySolver>();
+    if (params.ordering)
+      delta = sparseSolver_->optimize(gfg, *params.ordering);
+    else
+      delta = sparseSolver_->optimize(gfg, params.orderingType);
+  } else if (params.isSchurComplement()) {
+    // Landmarks eliminated in closed form, the reduced camera layout is cached
+    if (!schurSolver_)
+      schurSolver_ = boost::make_shared<SchurComplementSolver>(params.isLandmark, params.parallel);
+    delta = schurSolver_->optimize(gfg);
   } else if (params.isIterative()) {
     // Conjugate Gradient -> needs params.iterativeParams
     if (!params.iterativeParams)
@@ -161,6 +182,10 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
     if (auto pcg = boost::dynamic_pointer_cast<PCGSolverParameters>(
             params.iterativeParams)) {
       delta = PCGSolver(*pcg).optimize(gfg);
+    } else if (auto schur = boost::dynamic_pointer_cast<SchurPCGSolverParameters>(
+                   params.iterativeParams)) {
+      // Matrix-free PCG on the cameras of implicit Schur factors
+      delta = schur->solve(gfg);
     } else if (auto spcg =
                    boost::dynamic_pointer_cast<SubgraphSolverParameters>(
                        params.iterativeParams)) {
@@ -179,6 +204,12 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
   return delta;
 }
 
+/* ************************************************************************* */
+void NonlinearOptimizer::invalidateSymbolicStructure() {
+  sparseSolver_.reset();
+  multifrontalSolver_.reset();
+}
+
 /* ************************************************************************* */
 bool checkConvergence(double relativeErrorTreshold, double absoluteErrorTreshold,
                       double errorThreshold, double currentError, double newError,
@@ -24,6 +24,9 @@
 namespace gtsam {
 
 namespace internal { struct NonlinearOptimizerState; }
+class SparseCholeskySolver;
+class SchurComplementSolver;
+class MultifrontalSolver;
 
 /**
  * This is the abstract interface for classes that can optimize for the
@@ -79,6 +82,15 @@ protected:
 
   std::unique_ptr<internal::NonlinearOptimizerState> state_; ///< PIMPL'd state
 
+  /// Sparse solver used for CHOLMOD, caches the symbolic analysis across iterations
+  mutable boost::shared_ptr<SparseCholeskySolver> sparseSolver_;
+
+  /// Solver used for MULTIFRONTAL_*, caches the ordering and junction tree across iterations
+  mutable boost::shared_ptr<MultifrontalSolver> multifrontalSolver_;
+
+  /// Solver used for SCHUR_COMPLEMENT, caches the reduced camera system layout across iterations
+  mutable boost::shared_ptr<SchurComplementSolver> schurSolver_;
+
 public:
   /** A shared pointer to this class */
   using shared_ptr = boost::shared_ptr<const NonlinearOptimizer>;
@@ -129,6 +141,13 @@ public:
   virtual VectorValues solve(const GaussianFactorGraph &gfg,
       const NonlinearOptimizerParams& params) const;
 
+  /**
+   * Forget the symbolic structure cached by the linear solvers.  The caches check whether the
+   * linearized graph still has the same structure anyway, this only frees them, e.g. before
+   * a derived class modifies the graph.
+   */
+  void invalidateSymbolicStructure();
+
   /** 
    * Perform a single iteration, returning GaussianFactorGraph corresponding to 
    * the linearized factor graph.
@@ -100,6 +100,9 @@ void NonlinearOptimizerParams::print(const std::string& str) const {
   case CHOLMOD:
     std::cout << "         linear solver type: CHOLMOD\n";
     break;
+  case SCHUR_COMPLEMENT:
+    std::cout << "         linear solver type: SCHUR_COMPLEMENT\n";
+    break;
   case Iterative:
     std::cout << "         linear solver type: ITERATIVE\n";
     break;
@@ -139,6 +142,8 @@ std::string NonlinearOptimizerParams::linearSolverTranslator(
     return "ITERATIVE";
   case CHOLMOD:
     return "CHOLMOD";
+  case SCHUR_COMPLEMENT:
+    return "SCHUR_COMPLEMENT";
   default:
     throw std::invalid_argument(
         "Unknown linear solver type in SuccessiveLinearizationOptimizer");
@@ -160,6 +165,8 @@ NonlinearOptimizerParams::LinearSolverType NonlinearOptimizerParams::linearSolve
     return Iterative;
   if (linearSolverType == "CHOLMOD")
     return CHOLMOD;
+  if (linearSolverType == "SCHUR_COMPLEMENT")
+    return SCHUR_COMPLEMENT;
   throw std::invalid_argument(
       "Unknown linear solver type in SuccessiveLinearizationOptimizer");
 }
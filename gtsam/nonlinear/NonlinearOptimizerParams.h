@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <gtsam/base/ThreadPool.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/SubgraphSolver.h>
 #include <boost/optional.hpp>
@@ -100,12 +101,15 @@ public:
     SEQUENTIAL_CHOLESKY,
     SEQUENTIAL_QR,
     Iterative, /* Experimental Flag */
-    CHOLMOD, /* Experimental Flag */
+    CHOLMOD, /* Sparse Cholesky on the assembled Hessian, see SparseCholeskySolver */
+    SCHUR_COMPLEMENT, /* Eliminate landmarks in closed form, see SchurComplementSolver */
   };
 
   LinearSolverType linearSolverType = MULTIFRONTAL_CHOLESKY; ///< The type of linear solver to use in the nonlinear optimizer
   boost::optional<Ordering> ordering; ///< The optional variable elimination ordering, or empty to use COLAMD (default: empty)
   IterativeOptimizationParameters::shared_ptr iterativeParams; ///< The container for iterativeOptimization parameters. used in CG Solvers.
+  ParallelOptions parallel; ///< Threads used to evaluate and linearize the graph, set deterministic for reproducible errors (default: all threads)
+  std::function<bool(Key)> isLandmark; ///< The variables SCHUR_COMPLEMENT eliminates, or empty for all 3-dimensional variables (default: empty)
 
   NonlinearOptimizerParams() = default;
   virtual ~NonlinearOptimizerParams() {
@@ -127,6 +131,10 @@ public:
     return (linearSolverType == CHOLMOD);
   }
 
+  inline bool isSchurComplement() const {
+    return (linearSolverType == SCHUR_COMPLEMENT);
+  }
+
   inline bool isIterative() const {
     return (linearSolverType == Iterative);
   }
@@ -100,6 +100,11 @@ namespace gtsam {
 
     const VALUE & prior() const { return prior_; }
 
+  protected:
+
+    /// Linearized by NoiseModelFactor::linearize, so it can be relinearized in place
+    bool linearizesInPlace() const override { return true; }
+
   private:
 
     /** Serialization function */
@@ -35,21 +35,30 @@
 #endif
 #include <boost/iterator/transform_iterator.hpp>
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 
 namespace gtsam {
 
   /* ************************************************************************* */
-  Values::Values(const Values& other) {
-    this->insert(other);
+  size_t Values::NextVersion() {
+    static std::atomic<size_t> next(1);
+    return next.fetch_add(1, std::memory_order_relaxed);
   }
 
   /* ************************************************************************* */
-  Values::Values(Values&& other) : values_(std::move(other.values_)) {
+  Values::Values(const Values& other) : values_(other.values_), version_(other.version()) {
+  }
+
+  /* ************************************************************************* */
+  Values::Values(Values&& other)
+      : values_(std::move(other.values_)), version_(other.version()) {
+    other.touch();
   }
 
   /* ************************************************************************* */
@@ -59,18 +68,18 @@ namespace gtsam {
   }
 
   /* ************************************************************************* */
-  Values::Values(const Values& other, const VectorValues& delta) {
-    for (const_iterator key_value = other.begin(); key_value != other.end(); ++key_value) {
-      VectorValues::const_iterator it = delta.find(key_value->key);
-      Key key = key_value->key;  // Non-const duplicate to deal with non-const insert argument
-      if (it != delta.end()) {
-        const Vector& v = it->second;
-        Value* retractedValue(key_value->value.retract_(v));  // Retract
-        values_.insert(key, retractedValue);  // Add retracted result directly to result values
-      } else {
-        values_.insert(key, key_value->value.clone_());  // Add original version to result values
-      }
-    }
+  namespace {
+    // Retracting a single value is cheap, so bulk operations are only split into tasks of at
+    // least this many values
+    const size_t kMinimumGrain = 256;
+  }
+
+  /* ************************************************************************* */
+  Values::Values(const Values& other, const VectorValues& delta,
+                 const ParallelOptions& parallel) {
+    // Copy next to each other in key order, then retract the copies in place
+    values_.assignCopies(other.values_, parallel);
+    retractInPlace(delta, parallel);
   }
 
   /* ************************************************************************* */
@@ -106,22 +115,43 @@ namespace gtsam {
   }
 
   /* ************************************************************************* */
-  Values Values::retract(const VectorValues& delta) const {
-    return Values(*this, delta);
+  Values Values::retract(const VectorValues& delta, const ParallelOptions& parallel) const {
+    return Values(*this, delta, parallel);
+  }
+
+  /* ************************************************************************* */
+  void Values::retractInPlace(const VectorValues& delta, const ParallelOptions& parallel) {
+    const std::vector<KeyValueMap::Entry*> entries = values_.entries();
+    parallelFor(0, entries.size(), [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i) {
+        VectorValues::const_iterator it = delta.find(entries[i]->first);
+        if (it != delta.end()) entries[i]->second->retractInPlace_(it->second);
+      }
+    }, parallel.resolved(entries.size(), kMinimumGrain));
+    touch();
   }
 
   /* ************************************************************************* */
-  VectorValues Values::localCoordinates(const Values& cp) const {
+  VectorValues Values::localCoordinates(const Values& cp, const ParallelOptions& parallel) const {
     if(this->size() != cp.size())
       throw DynamicValuesMismatched();
-    VectorValues result;
-    for(const_iterator it1=this->begin(), it2=cp.begin(); it1!=this->end(); ++it1, ++it2) {
-      if(it1->key != it2->key)
+    const std::vector<const KeyValueMap::Entry*> entries = values_.entries(),
+                                                 cpEntries = cp.values_.entries();
+    for (size_t i = 0; i < size(); ++i)
+      if (entries[i]->first != cpEntries[i]->first)
         throw DynamicValuesMismatched(); // If keys do not match
-      // Will throw a dynamic_cast exception if types do not match
-      // NOTE: this is separate from localCoordinates(cp, ordering, result) due to at() vs. insert
-      result.insert(it1->key, it1->value.localCoordinates_(it2->value));
-    }
+
+    // Compute the local coordinates in parallel, then insert them in order
+    // Will throw a dynamic_cast exception if types do not match
+    std::vector<Vector> local(size());
+    parallelFor(0, size(), [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i)
+        local[i] = entries[i]->second->localCoordinates_(*cpEntries[i]->second);
+    }, parallel.resolved(size(), kMinimumGrain));
+
+    VectorValues result;
+    for (size_t i = 0; i < size(); ++i)
+      result.emplace(entries[i]->first, std::move(local[i]));
     return result;
   }
 
@@ -138,22 +168,26 @@ namespace gtsam {
 
   /* ************************************************************************* */
   void Values::insert(Key j, const Value& val) {
-    std::pair<iterator,bool> insertResult = tryInsert(j, val);
-    if(!insertResult.second)
+    if(!values_.insert(j, val).second)
       throw ValuesKeyAlreadyExists(j);
+    touch();
   }
 
   /* ************************************************************************* */
   void Values::insert(const Values& values) {
-    for(const_iterator key_value = values.begin(); key_value != values.end(); ++key_value) {
-      Key key = key_value->key; // Non-const duplicate to deal with non-const insert argument
-      insert(key, key_value->value);
-    }
+    // Merge in a single pass, throwing before anything is inserted if a key exists
+    Key duplicate;
+    if (!values_.insert(values.values_, duplicate))
+      throw ValuesKeyAlreadyExists(duplicate);
+    touch();
   }
 
   /* ************************************************************************* */
   std::pair<Values::iterator, bool> Values::tryInsert(Key j, const Value& value) {
-    std::pair<KeyValueMap::iterator, bool> result = values_.insert(j, value.clone_());
+    std::pair<KeyValueMap::iterator, bool> result = values_.insert(j, value);
+    if (result.second) touch();
+    // The returned iterator gives mutable access to the value
+    expose();
     return std::make_pair(boost::make_transform_iterator(result.first, &make_deref_pair), result.second);
   }
 
@@ -169,7 +203,8 @@ namespace gtsam {
     if (typeid(old_value) != typeid(val))
       throw ValuesIncorrectType(j, typeid(old_value), typeid(val));
 
-    values_.replace(item, val.clone_());
+    values_.assign(item, val);
+    touch();
   }
 
   /* ************************************************************************* */
@@ -185,6 +220,7 @@ namespace gtsam {
     if(item == values_.end())
       throw ValuesKeyDoesNotExist("erase", j);
     values_.erase(item);
+    touch();
   }
 
   /* ************************************************************************* */
@@ -198,8 +234,18 @@ namespace gtsam {
 
   /* ************************************************************************* */
   Values& Values::operator=(const Values& rhs) {
-    this->clear();
-    this->insert(rhs);
+    values_ = rhs.values_;
+    version_ = rhs.version();
+    exposed_ = false;
+    return *this;
+  }
+
+  /* ************************************************************************* */
+  Values& Values::operator=(Values&& rhs) {
+    values_ = std::move(rhs.values_);
+    version_ = rhs.version();
+    exposed_ = false;
+    rhs.touch();
     return *this;
   }
 
@@ -25,8 +25,10 @@
 #pragma once
 
 #include <gtsam/base/GenericValue.h>
+#include <gtsam/base/ThreadPool.h>
 #include <gtsam/base/VectorSpace.h>
 #include <gtsam/inference/Key.h>
+#include <gtsam/nonlinear/internal/ValueStorage.h>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/iterator/filter_iterator.hpp>
 #ifdef __GNUC__
@@ -41,6 +43,7 @@
 #include <boost/ptr_container/serialize_ptr_map.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <string>
 #include <utility>
 
@@ -72,20 +75,21 @@ namespace gtsam {
 
   private:
 
-    // Internally we store a boost ptr_map, with a ValueCloneAllocator (defined
-    // below) to clone and deallocate the Value objects, and a boost
-    // fast_pool_allocator to allocate map nodes.  In this way, all memory is
-    // allocated in a boost memory pool.
-    typedef boost::ptr_map<
-        Key,
-        Value,
-        std::less<Key>,
-        ValueCloneAllocator,
-        boost::fast_pool_allocator<std::pair<const Key, void*> > > KeyValueMap;
+    // Internally the Value objects are stored next to each other in blocks of memory, and a
+    // std::map with pool-allocated nodes indexes them by key (see internal::ValueStorage).
+    // Inserting and erasing take O(log n), and copying, retracting and iterating walk over
+    // contiguous memory.  As for std::map, iterators stay valid until their entry is erased.
+    typedef internal::ValueStorage KeyValueMap;
 
     // The member to store the values, see just above
     KeyValueMap values_;
 
+    // Stamp that changes whenever the values may have been modified, see version()
+    mutable std::atomic<size_t> version_{NextVersion()};
+
+    // Whether a mutable iterator was handed out since version_ was stamped
+    mutable std::atomic<bool> exposed_{false};
+
     // Types obtained by iterating
     typedef KeyValueMap::const_iterator::value_type ConstKeyValuePtrPair;
     typedef KeyValueMap::iterator::value_type KeyValuePtrPair;
@@ -158,7 +162,8 @@ namespace gtsam {
     Values(std::initializer_list<ConstKeyValuePair> init);
 
     /** Construct from a Values and an update vector: identical to other.retract(delta) */
-    Values(const Values& other, const VectorValues& delta);
+    Values(const Values& other, const VectorValues& delta,
+           const ParallelOptions& parallel = ParallelOptions());
 
     /** Constructor from a Filtered view copies out all values */
     template<class ValueType>
@@ -214,20 +219,20 @@ namespace gtsam {
 
     /** Find an element by key, returning an iterator, or end() if the key was
      * not found. */
-    iterator find(Key j) { return boost::make_transform_iterator(values_.find(j), &make_deref_pair); }
+    iterator find(Key j) { expose(); return boost::make_transform_iterator(values_.find(j), &make_deref_pair); }
 
     /** Find an element by key, returning an iterator, or end() if the key was
      * not found. */
     const_iterator find(Key j) const { return boost::make_transform_iterator(values_.find(j), &make_const_deref_pair); }
 
     /** Find the element greater than or equal to the specified key. */
-    iterator lower_bound(Key j) { return boost::make_transform_iterator(values_.lower_bound(j), &make_deref_pair); }
+    iterator lower_bound(Key j) { expose(); return boost::make_transform_iterator(values_.lower_bound(j), &make_deref_pair); }
 
     /** Find the element greater than or equal to the specified key. */
     const_iterator lower_bound(Key j) const { return boost::make_transform_iterator(values_.lower_bound(j), &make_const_deref_pair); }
 
     /** Find the lowest-ordered element greater than the specified key. */
-    iterator upper_bound(Key j) { return boost::make_transform_iterator(values_.upper_bound(j), &make_deref_pair); }
+    iterator upper_bound(Key j) { expose(); return boost::make_transform_iterator(values_.upper_bound(j), &make_deref_pair); }
 
     /** Find the lowest-ordered element greater than the specified key. */
     const_iterator upper_bound(Key j) const { return boost::make_transform_iterator(values_.upper_bound(j), &make_const_deref_pair); }
@@ -240,21 +245,48 @@ namespace gtsam {
 
     const_iterator begin() const { return boost::make_transform_iterator(values_.begin(), &make_const_deref_pair); }
     const_iterator end() const { return boost::make_transform_iterator(values_.end(), &make_const_deref_pair); }
-    iterator begin() { return boost::make_transform_iterator(values_.begin(), &make_deref_pair); }
-    iterator end() { return boost::make_transform_iterator(values_.end(), &make_deref_pair); }
+    iterator begin() { expose(); return boost::make_transform_iterator(values_.begin(), &make_deref_pair); }
+    iterator end() { expose(); return boost::make_transform_iterator(values_.end(), &make_deref_pair); }
     const_reverse_iterator rbegin() const { return boost::make_transform_iterator(values_.rbegin(), &make_const_deref_pair); }
     const_reverse_iterator rend() const { return boost::make_transform_iterator(values_.rend(), &make_const_deref_pair); }
-    reverse_iterator rbegin() { return boost::make_transform_iterator(values_.rbegin(), &make_deref_pair); }
-    reverse_iterator rend() { return boost::make_transform_iterator(values_.rend(), &make_deref_pair); }
+    reverse_iterator rbegin() { expose(); return boost::make_transform_iterator(values_.rbegin(), &make_deref_pair); }
+    reverse_iterator rend() { expose(); return boost::make_transform_iterator(values_.rend(), &make_deref_pair); }
+
+    /**
+     * A stamp that changes whenever this Values may have been modified, so caches can tell
+     * whether they are still valid for it.  Copies share the stamp of their source as long as
+     * neither is modified.  Handing out a mutable iterator, e.g. with the non-const find() or
+     * begin(), counts as a modification at the next call to version(), but writing through
+     * it after that call is not detected.
+     */
+    size_t version() const {
+      // Threads calling this at once may each stamp a new version, which only costs caches
+      // keyed on it a miss
+      if (exposed_.load(std::memory_order_acquire)) {
+        version_.store(NextVersion(), std::memory_order_relaxed);
+        exposed_.store(false, std::memory_order_release);
+      }
+      return version_.load(std::memory_order_relaxed);
+    }
 
     /// @name Manifold Operations
     /// @{
 
-    /** Add a delta config to current config and returns a new config */
-    Values retract(const VectorValues& delta) const;
+    /** Add a delta config to current config and returns a new config.  The values are
+     *  retracted in parallel as configured by \c parallel. */
+    Values retract(const VectorValues& delta,
+                   const ParallelOptions& parallel = ParallelOptions()) const;
+
+    /** Add a delta config to current config in place, in parallel as configured by
+     *  \c parallel.  Unlike retract, no Value is allocated.  Keys missing in delta are left
+     *  unchanged. */
+    void retractInPlace(const VectorValues& delta,
+                        const ParallelOptions& parallel = ParallelOptions());
 
-    /** Get a delta config about a linearization point c0 (*this) */
-    VectorValues localCoordinates(const Values& cp) const;
+    /** Get a delta config about a linearization point c0 (*this), computed in parallel as
+     *  configured by \c parallel */
+    VectorValues localCoordinates(const Values& cp,
+                                  const ParallelOptions& parallel = ParallelOptions()) const;
 
     ///@}
 
@@ -301,14 +333,23 @@ namespace gtsam {
      */
     KeyVector keys() const;
 
-    /** Replace all keys and variables */
+    /** Replace all keys and variables.  If rhs has the same keys and value types, the
+     *  values are assigned in place without allocating. */
     Values& operator=(const Values& rhs);
 
+    /** Replace all keys and variables, taking over the values of rhs without copying */
+    Values& operator=(Values&& rhs);
+
     /** Swap the contents of two Values without copying data */
-    void swap(Values& other) { values_.swap(other.values_); }
+    void swap(Values& other) {
+      values_.swap(other.values_);
+      const size_t version = this->version();
+      version_ = other.version();
+      other.version_ = version;
+    }
 
     /** Remove all variables from the config */
-    void clear() { values_.clear(); }
+    void clear() { values_.clear(); touch(); }
 
     /** Compute the total dimensionality of all values (\f$ O(n) \f$) */
     size_t dim() const;
@@ -405,6 +446,19 @@ namespace gtsam {
     }
 
   private:
+    // A stamp that no Values had before
+    static size_t NextVersion();
+
+    // Mark this Values as modified
+    void touch() {
+      version_.store(NextVersion(), std::memory_order_relaxed);
+      exposed_.store(false, std::memory_order_relaxed);
+    }
+
+    // Mark this Values as possibly modified through a mutable iterator, without the cost of
+    // stamping a new version on every access
+    void expose() { exposed_.store(true, std::memory_order_relaxed); }
+
     // Filters based on ValueType (if not Value) and also based on the user-
     // supplied \c filter function.
     template<class ValueType>
@@ -414,12 +468,38 @@ namespace gtsam {
       return filter(key_value.key) && (dynamic_cast<const GenericValue<ValueType>*>(&key_value.value));
     }
 
+    // Archives store the values as the boost::ptr_map they used to be kept in, so that they
+    // stay readable.  Saving only views the stored values, so that boost tracks their actual
+    // addresses, and loading copies them into the storage.
+    template<class CloneAllocator>
+    using SerializedMap = boost::ptr_map<
+        Key,
+        Value,
+        std::less<Key>,
+        CloneAllocator,
+        boost::fast_pool_allocator<std::pair<const Key, void*> > >;
+
     /** Serialization function */
     friend class boost::serialization::access;
     template<class ARCHIVE>
-    void serialize(ARCHIVE & ar, const unsigned int /*version*/) {
-      ar & BOOST_SERIALIZATION_NVP(values_);
+    void save(ARCHIVE & ar, const unsigned int /*version*/) const {
+      SerializedMap<boost::view_clone_allocator> view;
+      for (const auto& key_value : values_) {
+        Key key = key_value.first;
+        view.insert(key, key_value.second);
+      }
+      ar & boost::serialization::make_nvp("values_", view);
+    }
+    template<class ARCHIVE>
+    void load(ARCHIVE & ar, const unsigned int /*version*/) {
+      SerializedMap<ValueCloneAllocator> loaded;
+      ar & boost::serialization::make_nvp("values_", loaded);
+      values_.clear();
+      for (const auto& key_value : loaded)
+        values_.insert(key_value.first, *key_value.second);
+      touch();
     }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 
     static ConstKeyValuePair make_const_deref_pair(const KeyValueMap::const_iterator::value_type& key_value) {
       return ConstKeyValuePair(key_value.first, *key_value.second); }
@@ -60,7 +60,7 @@ struct LevenbergMarquardtState : public NonlinearOptimizerState {
   // Constructor version that takes ownership of values
   LevenbergMarquardtState(Values&& initialValues, double error, double lambda, double currentFactor,
                           unsigned int iterations = 0, unsigned int totalNumberInnerIterations = 0)
-      : NonlinearOptimizerState(initialValues, error, iterations),
+      : NonlinearOptimizerState(std::move(initialValues), error, iterations),
         lambda(lambda),
         currentFactor(currentFactor),
         totalNumberInnerIterations(totalNumberInnerIterations) {}
@@ -33,8 +33,9 @@ namespace internal {
  */
 struct NonlinearOptimizerState {
  public:
-  /** The current estimate of the variable values. */
-  const Values values;
+  /** The current estimate of the variable values.  Not const, so that optimizers can reuse
+   *  its storage when the state is replaced. */
+  Values values;
 
   /** The factor graph error on the current values. */
   const double error;
@@ -0,0 +1,379 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ValueStorage.h
+ * @brief Private storage of Values: Value objects in contiguous blocks, indexed by key
+ * @date Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/base/ThreadPool.h>
+#include <gtsam/base/Value.h>
+#include <gtsam/inference/Key.h>
+
+#include <boost/pool/pool_alloc.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <typeinfo>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace gtsam {
+namespace internal {
+
+/**
+ * The storage of Values.  The Value objects are constructed one after the other in large
+ * blocks of memory owned by the storage, and a key-sorted std::map with pool-allocated nodes
+ * indexes them, so inserting and erasing a value takes O(log n).  Copying or retracting a
+ * Values places all values of the result next to each other in key order, so iterating over
+ * them walks through contiguous memory.  The slot of an erased value is reused by the next
+ * value of the same size.  Values never move, so references to them and iterators stay valid
+ * until their entry is erased, as for std::map.
+ *
+ * Value types that do not implement Value::cloneInto_ are cloned with Value::clone_ onto the
+ * heap instead.
+ */
+class ValueStorage {
+ public:
+  typedef std::map<Key, Value*, std::less<Key>,
+                   boost::fast_pool_allocator<std::pair<const Key, Value*> > > Index;
+  typedef Index::value_type Entry;
+  typedef Index::iterator iterator;
+  typedef Index::const_iterator const_iterator;
+  typedef Index::reverse_iterator reverse_iterator;
+  typedef Index::const_reverse_iterator const_reverse_iterator;
+
+  ValueStorage() : next_(nullptr), limit_(nullptr), capacity_(0) {}
+
+  /// Copy all values into a single block
+  ValueStorage(const ValueStorage& other) : ValueStorage() {
+    assignCopies(other, ParallelOptions::Serial());
+  }
+
+  ValueStorage(ValueStorage&& other) noexcept : ValueStorage() { swap(other); }
+
+  /// Copy, assigning the existing values in place if both have the same keys and value types,
+  /// e.g. when copying the values of the previous iteration of an optimizer
+  ValueStorage& operator=(const ValueStorage& other) {
+    if (this == &other) return *this;
+    if (sameStructure(other)) {
+      const_iterator jt = other.begin();
+      for (iterator it = begin(); it != end(); ++it, ++jt) *it->second = *jt->second;
+    } else {
+      ValueStorage copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  ValueStorage& operator=(ValueStorage&& other) noexcept {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~ValueStorage() { clear(); }
+
+  size_t size() const { return index_.size(); }
+  bool empty() const { return index_.empty(); }
+
+  iterator begin() { return index_.begin(); }
+  iterator end() { return index_.end(); }
+  const_iterator begin() const { return index_.begin(); }
+  const_iterator end() const { return index_.end(); }
+  reverse_iterator rbegin() { return index_.rbegin(); }
+  reverse_iterator rend() { return index_.rend(); }
+  const_reverse_iterator rbegin() const { return index_.rbegin(); }
+  const_reverse_iterator rend() const { return index_.rend(); }
+
+  iterator find(Key j) { return index_.find(j); }
+  const_iterator find(Key j) const { return index_.find(j); }
+  iterator lower_bound(Key j) { return index_.lower_bound(j); }
+  const_iterator lower_bound(Key j) const { return index_.lower_bound(j); }
+  iterator upper_bound(Key j) { return index_.upper_bound(j); }
+  const_iterator upper_bound(Key j) const { return index_.upper_bound(j); }
+
+  /// The entries in key order, for loops that need random access, e.g. in parallel
+  std::vector<Entry*> entries() {
+    std::vector<Entry*> result;
+    result.reserve(size());
+    for (Entry& entry : index_) result.push_back(&entry);
+    return result;
+  }
+  std::vector<const Entry*> entries() const {
+    std::vector<const Entry*> result;
+    result.reserve(size());
+    for (const Entry& entry : index_) result.push_back(&entry);
+    return result;
+  }
+
+  /// Insert a copy of a value, as std::map::insert does nothing if the key already exists
+  std::pair<iterator, bool> insert(Key j, const Value& value) {
+    iterator it = index_.lower_bound(j);
+    if (it != index_.end() && it->first == j) return std::make_pair(it, false);
+    Value* copy = construct(value);
+    try {
+      it = index_.emplace_hint(it, j, copy);
+    } catch (...) {
+      destroy(copy);
+      throw;
+    }
+    return std::make_pair(it, true);
+  }
+
+  /**
+   * Insert copies of all values of other, in O(m log n).  If other shares a key with this
+   * storage nothing is inserted, and false is returned with the key in \c duplicate.
+   */
+  bool insert(const ValueStorage& other, Key& duplicate) {
+    // Check for duplicates before changing anything
+    for (const Entry& entry : other.index_) {
+      if (index_.count(entry.first)) {
+        duplicate = entry.first;
+        return false;
+      }
+    }
+
+    // Copy next to each other first, then index the copies in key order
+    reserve(other.bytes());
+    std::vector<Value*> copies;
+    copies.reserve(other.size());
+    try {
+      for (const Entry& entry : other.index_) copies.push_back(construct(*entry.second));
+    } catch (...) {
+      for (Value* copy : copies) destroy(copy);
+      throw;
+    }
+    size_t inserted = 0;
+    try {
+      iterator hint = index_.end();
+      for (const Entry& entry : other.index_) {
+        hint = index_.emplace_hint(hint, entry.first, copies[inserted]);
+        ++inserted;
+        ++hint;  // the next key is usually inserted right behind, e.g. new poses of a trajectory
+      }
+    } catch (...) {
+      const_iterator entry = other.index_.begin();
+      for (size_t k = 0; k < inserted; ++k, ++entry) index_.erase(entry->first);
+      for (Value* copy : copies) destroy(copy);
+      throw;
+    }
+    return true;
+  }
+
+  /// Assign a value of the same type to an entry
+  void assign(iterator it, const Value& value) {
+    if (!heapValues_.empty() && heapValues_.count(it->second)) {
+      Value* copy = construct(value);
+      heapValues_.erase(it->second);
+      it->second->deallocate_();
+      it->second = copy;
+    } else {
+      *it->second = value;
+    }
+  }
+
+  /// Erase an entry, its slot is reused by the next value of the same size
+  void erase(iterator it) {
+    destroy(it->second);
+    index_.erase(it);
+  }
+
+  /**
+   * Replace the contents with copies of the values of other.  The copies are placed next to
+   * each other in key order, and are constructed in parallel as configured by \c parallel.
+   */
+  void assignCopies(const ValueStorage& other, const ParallelOptions& parallel) {
+    clear();
+    const std::vector<const Entry*> source = other.entries();
+    const size_t n = source.size();
+
+    // Allocating slots and indexing are serial, only the copies are made in parallel
+    reserve(other.bytes());
+    std::vector<void*> slots(n, nullptr);
+    for (size_t i = 0; i < n; ++i) {
+      const Value& value = *source[i]->second;
+      if (const size_t size = value.sizeOf_()) slots[i] = allocate(size, value.alignOf_());
+    }
+    std::vector<Value*> copies(n, nullptr);
+    try {
+      parallelFor(0, n, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const Value& value = *source[i]->second;
+          copies[i] = slots[i] ? value.cloneInto_(slots[i]) : value.clone_();
+        }
+      }, parallel.resolved(n, kMinimumGrain));
+      for (size_t i = 0; i < n; ++i)
+        if (!slots[i]) heapValues_.insert(copies[i]);
+      for (size_t i = 0; i < n; ++i)
+        index_.emplace_hint(index_.end(), source[i]->first, copies[i]);
+    } catch (...) {
+      index_.clear();
+      for (size_t i = 0; i < n; ++i) {
+        if (copies[i]) {
+          if (slots[i])
+            copies[i]->~Value();
+          else
+            copies[i]->deallocate_();
+        }
+      }
+      heapValues_.clear();
+      releaseBlocks();
+      throw;
+    }
+  }
+
+  void swap(ValueStorage& other) noexcept {
+    index_.swap(other.index_);
+    blocks_.swap(other.blocks_);
+    std::swap(next_, other.next_);
+    std::swap(limit_, other.limit_);
+    std::swap(capacity_, other.capacity_);
+    freeSlots_.swap(other.freeSlots_);
+    heapValues_.swap(other.heapValues_);
+  }
+
+  void clear() {
+    for (const Entry& entry : index_) {
+      if (heapValues_.empty() || !heapValues_.count(entry.second))
+        entry.second->~Value();
+      else
+        entry.second->deallocate_();
+    }
+    index_.clear();
+    heapValues_.clear();
+    releaseBlocks();
+  }
+
+ private:
+  // Loops over values are only split into tasks of at least this many values
+  static const size_t kMinimumGrain = 256;
+
+  // Alignment of blocks, enough for any Eigen type
+  static const size_t kBlockAlignment = 64;
+
+  // Size of the first block
+  static const size_t kMinimumBlockSize = 4096;
+
+  // Size and alignment of the slots that erased values leave behind
+  typedef std::pair<size_t, size_t> SlotShape;
+
+  // Whether other has the same keys with values of the same types, all in blocks
+  bool sameStructure(const ValueStorage& other) const {
+    if (size() != other.size() || !heapValues_.empty() || !other.heapValues_.empty())
+      return false;
+    for (const_iterator it = begin(), jt = other.begin(); it != end(); ++it, ++jt)
+      if (it->first != jt->first || typeid(*it->second) != typeid(*jt->second)) return false;
+    return true;
+  }
+
+  // An upper bound on the memory needed to copy all values into a single block
+  size_t bytes() const {
+    size_t result = 0;
+    for (const Entry& entry : index_)
+      if (const size_t size = entry.second->sizeOf_()) result += size + entry.second->alignOf_();
+    return result;
+  }
+
+  // Make sure the current block has room for n bytes
+  void reserve(size_t n) {
+    if (n == 0 || static_cast<size_t>(limit_ - next_) >= n) return;
+    // Blocks at least double the capacity, so there are only O(log n) of them
+    const size_t size = std::max(std::max(n, capacity_), size_t(kMinimumBlockSize));
+    blocks_.emplace_back(new char[size + kBlockAlignment]);
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(blocks_.back().get());
+    next_ = reinterpret_cast<char*>((start + kBlockAlignment - 1) & ~(kBlockAlignment - 1));
+    limit_ = next_ + size;
+    capacity_ += size;
+  }
+
+  // Memory for a value of the given size and alignment
+  void* allocate(size_t size, size_t alignment) {
+    std::vector<void*>& free = freeSlots_[SlotShape(size, alignment)];
+    if (!free.empty()) {
+      void* slot = free.back();
+      free.pop_back();
+      return slot;
+    }
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      const std::uintptr_t next = reinterpret_cast<std::uintptr_t>(next_);
+      char* slot = reinterpret_cast<char*>((next + alignment - 1) & ~(alignment - 1));
+      if (next_ && slot + size <= limit_) {
+        next_ = slot + size;
+        return slot;
+      }
+      reserve(size + alignment);
+    }
+    throw std::bad_alloc();
+  }
+
+  // A copy of value, in a block if its type supports it
+  Value* construct(const Value& value) {
+    const size_t size = value.sizeOf_();
+    if (size == 0) {
+      Value* copy = value.clone_();
+      try {
+        heapValues_.insert(copy);
+      } catch (...) {
+        copy->deallocate_();
+        throw;
+      }
+      return copy;
+    }
+    const size_t alignment = value.alignOf_();
+    void* slot = allocate(size, alignment);
+    try {
+      return value.cloneInto_(slot);
+    } catch (...) {
+      freeSlots_[SlotShape(size, alignment)].push_back(slot);
+      throw;
+    }
+  }
+
+  // Destroy a value made by construct
+  void destroy(Value* value) {
+    if (!heapValues_.empty() && heapValues_.erase(value)) {
+      value->deallocate_();
+      return;
+    }
+    const SlotShape shape(value->sizeOf_(), value->alignOf_());
+    void* slot = dynamic_cast<void*>(value);
+    value->~Value();
+    freeSlots_[shape].push_back(slot);
+  }
+
+  // Free all blocks, the values in them have to be destroyed already
+  void releaseBlocks() {
+    blocks_.clear();
+    next_ = limit_ = nullptr;
+    capacity_ = 0;
+    freeSlots_.clear();
+  }
+
+  Index index_;                                    ///< The values by key
+  std::vector<std::unique_ptr<char[]> > blocks_;   ///< The memory the values are in
+  char* next_;                                     ///< Free memory in the last block
+  char* limit_;                                    ///< End of the last block
+  size_t capacity_;                                ///< Total size of all blocks
+  std::map<SlotShape, std::vector<void*> > freeSlots_;  ///< Slots of erased values
+  std::unordered_set<const Value*> heapValues_;   ///< Values allocated with clone_
+};
+
+}  // namespace internal
+}  // namespace gtsam
@@ -20,6 +20,7 @@
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/geometry/PinholeCamera.h>
 #include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Rot2.h>
 #include <gtsam/geometry/Cal3_S2.h>
 #include <gtsam/geometry/Cal3DS2.h>
 #include <gtsam/geometry/Cal3Bundler.h>
@@ -37,6 +38,7 @@ GTSAM_VALUE_EXPORT(gtsam::Cal3_S2);
 GTSAM_VALUE_EXPORT(gtsam::Cal3Bundler);
 GTSAM_VALUE_EXPORT(gtsam::Point3);
 GTSAM_VALUE_EXPORT(gtsam::Pose3);
+GTSAM_VALUE_EXPORT(gtsam::Rot2);
 GTSAM_VALUE_EXPORT(gtsam::Rot3);
 GTSAM_VALUE_EXPORT(gtsam::PinholeCamera<Cal3_S2>);
 GTSAM_VALUE_EXPORT(gtsam::PinholeCamera<Cal3DS2>);
@@ -82,6 +84,27 @@ TEST (Serialization, TemplatedValues) {
   EXPECT(equalsBinary(values));
 }
 
+/* ************************************************************************* */
+// Values are archived as the boost::ptr_map they used to be stored in
+TEST (Serialization, ValuesArchiveFormat) {
+  Values expected;
+  expected.insert(1, Rot2(0.5));
+  expected.insert(7, Rot2(-1.0));
+
+  // Written by the ptr_map storage
+  const string archive =
+      "22 serialization::archive 18 0 0 0 0 2 1 2 32 gtsam::GenericValue<gtsam::Rot2> 1 0\n"
+      "0 0 0 0 0 8.77582561890372759e-01 4.79425538604203005e-01 7 2\n"
+      "1 5.40302305868139765e-01 -8.41470984807896505e-01\n";
+  Values actual;
+  deserialize(archive, actual);
+  EXPECT(assert_equal(expected, actual));
+
+  const string xml = serializeXML(expected);
+  EXPECT(xml.find("<first>7</first>") != string::npos);
+  EXPECT(xml.find("<second class_id_reference=\"2\" object_id=\"_1\">") != string::npos);
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
 /* ************************************************************************* */
@@ -154,6 +154,49 @@ TEST( Values, insert_bad )
   CHECK_EXCEPTION(cfg1.insert(cfg2), ValuesKeyAlreadyExists);
 }
 
+/* ************************************************************************* */
+TEST( Values, insert_order )
+{
+  // Values are kept sorted by key whatever the order of insertion
+  Values values;
+  values.insert(X(3), Pose2(3, 0, 0));
+  values.insert(L(1), Point2(1, 1));
+  values.insert(X(1), Pose2(1, 0, 0));
+  values.insert(X(2), Pose2(2, 0, 0));
+  const Point2& landmark = values.at<Point2>(L(1));
+
+  // Merging keeps the order, and references to the existing values stay valid
+  Values more;
+  more.insert(X(0), Pose2(0, 0, 0));
+  more.insert(X(4), Pose2(4, 0, 0));
+  more.insert(L(0), Point2(0, 0));
+  values.insert(more);
+  KeyVector expected{L(0), L(1), X(0), X(1), X(2), X(3), X(4)};
+  EXPECT(expected == values.keys());
+  EXPECT(assert_equal(Point2(1, 1), landmark));
+  EXPECT(values.find(X(5)) == values.end());
+  EXPECT_LONGS_EQUAL(X(3), values.lower_bound(X(3))->key);
+  EXPECT_LONGS_EQUAL(X(4), values.upper_bound(X(3))->key);
+
+  // Nothing is inserted if a key already exists
+  Values duplicate;
+  duplicate.insert(X(9), Pose2());
+  duplicate.insert(X(2), Pose2());
+  CHECK_EXCEPTION(values.insert(duplicate), ValuesKeyAlreadyExists);
+  EXPECT_LONGS_EQUAL(7, values.size());
+  EXPECT(!values.exists(X(9)));
+
+  values.erase(X(1));
+  expected = KeyVector{L(0), L(1), X(0), X(2), X(3), X(4)};
+  EXPECT(expected == values.keys());
+
+  // Erasing and inserting leave the other values where they are
+  values.insert(X(5), Pose2(5, 0, 0));
+  values.erase(L(0));
+  EXPECT(assert_equal(Point2(1, 1), landmark));
+  EXPECT(assert_equal(Pose2(5, 0, 0), values.at<Pose2>(X(5))));
+}
+
 /* ************************************************************************* */
 TEST( Values, update_element )
 {
@@ -233,6 +276,43 @@ TEST(Values, retract_partial)
 
   CHECK(assert_equal(expected, config0.retract(delta)));
   CHECK(assert_equal(expected, Values(config0, delta)));
+
+  config0.retractInPlace(delta);
+  CHECK(assert_equal(expected, config0));
+}
+
+/* ************************************************************************* */
+TEST(Values, retract_parallel)
+{
+  // Many values, retracted and compared in chunks of a few values
+  Values values;
+  VectorValues delta;
+  for (size_t i = 0; i < 100; ++i) {
+    values.insert(X(i), Pose2(0.1 * i, 0.0, 0.01 * i));
+    values.insert(L(i), Point2(0.0, 0.1 * i));
+    if (i % 3) delta.insert(X(i), Vector3(0.1, -0.1, 0.2));
+    delta.insert(L(i), Vector2(0.5, 0.5));
+  }
+
+  const ParallelOptions parallel(4, 7);
+  const Values expected = values.retract(delta, ParallelOptions::Serial());
+  EXPECT(assert_equal(expected, values.retract(delta, parallel)));
+
+  // In place, the values stay at the same addresses
+  Values inPlace = values;
+  const Value* first = &inPlace.at(L(0));
+  inPlace.retractInPlace(delta, parallel);
+  EXPECT(assert_equal(expected, inPlace));
+  EXPECT(first == &inPlace.at(L(0)));
+
+  // Assigning values with the same structure does not reallocate them either
+  inPlace = values;
+  EXPECT(assert_equal(values, inPlace));
+  EXPECT(first == &inPlace.at(L(0)));
+
+  const VectorValues local = values.localCoordinates(expected, parallel);
+  EXPECT(assert_equal(values.localCoordinates(expected, ParallelOptions::Serial()), local));
+  EXPECT(assert_equal(expected, values.retract(local), 1e-9));
 }
 
 /* ************************************************************************* */
@@ -521,16 +601,76 @@ TEST(Values, std_move) {
       EXPECT_LONGS_EQUAL(2, (long)TestValueData::DestructorCount);
       EXPECT_LONGS_EQUAL(2, values.size());
       TestValues moved(std::move(values));   // Move happens here !
-      EXPECT_LONGS_EQUAL(2, values.size());  // Uh oh! Should be 0 !
+      EXPECT_LONGS_EQUAL(0, values.size());
       EXPECT_LONGS_EQUAL(2, moved.size());
-      EXPECT_LONGS_EQUAL(8, (long)TestValueData::ConstructorCount);  // Uh oh! Should be 6 :-(
+      EXPECT_LONGS_EQUAL(6, (long)TestValueData::ConstructorCount);  // no copies
       EXPECT_LONGS_EQUAL(2, (long)TestValueData::DestructorCount);   // extra insert copies
+
+      // Move assignment does not copy either
+      Values assigned;
+      assigned = std::move(moved);
+      EXPECT_LONGS_EQUAL(2, assigned.size());
+      EXPECT_LONGS_EQUAL(6, (long)TestValueData::ConstructorCount);
     }
-    EXPECT_LONGS_EQUAL(8, (long)TestValueData::ConstructorCount);
-    EXPECT_LONGS_EQUAL(8, (long)TestValueData::DestructorCount);
+    EXPECT_LONGS_EQUAL(6, (long)TestValueData::ConstructorCount);
+    EXPECT_LONGS_EQUAL(6, (long)TestValueData::DestructorCount);
   }
 }
 
+/* ************************************************************************* */
+TEST(Values, version)
+{
+  Values values;
+  values.insert(X(0), Pose2(1.0, 2.0, 0.3));
+  values.insert(L(0), Point2(1.0, 1.0));
+
+  // Copies share the version until one of them is modified
+  const Values copy = values;
+  EXPECT_LONGS_EQUAL(values.version(), copy.version());
+  values.update(L(0), Point2(2.0, 1.0));
+  EXPECT(values.version() != copy.version());
+
+  // Every modification gives a new version
+  const size_t updated = values.version();
+  VectorValues delta;
+  delta.insert(L(0), Vector2(0.5, 0.5));
+  values.retractInPlace(delta);
+  EXPECT(values.version() != updated);
+  EXPECT(values.retract(delta).version() != values.version());
+  size_t previous = values.version();
+  values.insert(L(1), Point2(0.0, 0.0));
+  EXPECT(values.version() != previous);
+  previous = values.version();
+  values.erase(L(1));
+  EXPECT(values.version() != previous);
+
+  // ... including handing out a mutable iterator, which is seen by the next call to version()
+  previous = values.version();
+  values.find(L(0))->value = genericValue(Point2(3.0, 1.0));
+  EXPECT(values.version() != previous);
+  previous = values.version();
+  EXPECT_LONGS_EQUAL(previous, values.version());
+
+  // Reading does not change the version
+  const Values& constValues = values;
+  constValues.find(L(0));
+  for (const auto key_value : constValues) key_value.value.dim();
+  EXPECT_LONGS_EQUAL(previous, values.version());
+
+  // Neither does an insert that fails
+  CHECK_EXCEPTION(values.insert(L(0), Point2(0.0, 0.0)), ValuesKeyAlreadyExists);
+  EXPECT_LONGS_EQUAL(previous, values.version());
+
+  // Assignment and moves carry the version along
+  Values assigned;
+  assigned = copy;
+  EXPECT_LONGS_EQUAL(copy.version(), assigned.version());
+  previous = values.version();
+  Values moved(std::move(values));
+  EXPECT_LONGS_EQUAL(previous, moved.version());
+  EXPECT(values.version() != previous);
+}
+
 /* ************************************************************************* */
 TEST(Values, VectorDynamicInsertFixedRead) {
   Values values;
@@ -124,6 +124,11 @@ namespace gtsam {
     }
     /// @}
 
+  protected:
+
+    /// Linearized by NoiseModelFactor::linearize, so it can be relinearized in place
+    bool linearizesInPlace() const override { return true; }
+
   private:
 
     /** Serialization function */
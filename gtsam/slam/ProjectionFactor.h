@@ -174,6 +174,11 @@ namespace gtsam {
     /** return flag for throwing cheirality exceptions */
     inline bool throwCheirality() const { return throwCheirality_; }
 
+  protected:
+
+    /// Linearized by NoiseModelFactor::linearize, so it can be relinearized in place
+    bool linearizesInPlace() const override { return true; }
+
   private:
 
     /// Serialization function
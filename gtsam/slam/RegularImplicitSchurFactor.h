@@ -62,7 +62,7 @@ public:
   virtual ~RegularImplicitSchurFactor() {
   }
 
-  std::vector<MatrixZD, Eigen::aligned_allocator<MatrixZD> >& FBlocks() const {
+  const std::vector<MatrixZD, Eigen::aligned_allocator<MatrixZD> >& FBlocks() const {
     return FBlocks_;
   }
 
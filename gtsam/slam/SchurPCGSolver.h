@@ -0,0 +1,297 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SchurPCGSolver.h
+ * @brief   Matrix-free PCG on the reduced camera system of bundle adjustment
+ * @date    Oct 16, 2026
+ */
+
+#pragma once
+
+#include <gtsam/slam/RegularImplicitSchurFactor.h>
+#include <gtsam/base/ThreadPool.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/PCGSolver.h>
+#include <gtsam/linear/linearExceptions.h>
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Preconditioned conjugate gradient on the reduced camera system of bundle
+ * adjustment, as linearized by smart factors in IMPLICIT_SCHUR mode, i.e.
+ * RegularImplicitSchurFactors, plus other factors on the cameras such as
+ * priors and the damping of Levenberg-Marquardt.
+ *
+ * The system is never assembled, and the cameras are one contiguous vector.
+ * For every camera j of a Schur factor with blocks F_j and E_j the solver
+ * keeps G_j = F_j' E_j, so that the Hessian F'(I - E P E')F of the factor
+ * multiplies a vector x as
+ *   y_j += F_j' F_j x_j - G_j P sum_k G_k' x_k.
+ * The F_j' F_j are summed per camera, with the blocks of the other factors.
+ * A multiplication computes P sum_k G_k' x_k for every factor first, and then
+ * gathers those of its factors for every camera, so that both passes run in
+ * parallel without writing to shared data, and sum in the same order for any
+ * number of threads.  The preconditioner is the block diagonal of the
+ * reduced camera system, i.e. block Jacobi on the Schur complement.
+ *
+ * All variables need to be cameras, of dimension traits<CAMERA>::dimension.
+ * Select the solver in a NonlinearOptimizer with
+ * \code
+ *   params.linearSolverType = NonlinearOptimizerParams::Iterative;
+ *   params.iterativeParams =
+ *       boost::make_shared<SchurPCGSolver<CAMERA>::Parameters>();
+ * \endcode
+ */
+template <class CAMERA>
+class SchurPCGSolver : public IterativeSolver {
+ public:
+  typedef IterativeSolver Base;
+  typedef boost::shared_ptr<SchurPCGSolver> shared_ptr;
+  typedef RegularImplicitSchurFactor<CAMERA> SchurFactor;
+
+  /// Parameters solving with this solver, see SchurPCGSolverParameters
+  struct Parameters : public SchurPCGSolverParameters {
+    VectorValues solve(const GaussianFactorGraph& gfg) const override {
+      return SchurPCGSolver(*this).optimize(gfg);
+    }
+  };
+
+  static const int D = traits<CAMERA>::dimension;  ///< Camera dimension
+  typedef Eigen::Matrix<double, D, 1> VectorD;
+  typedef Eigen::Matrix<double, D, D> MatrixDD;
+  typedef Eigen::Matrix<double, D, 3> MatrixD3;
+
+  /// The reduced camera system of a graph, for preconditionedConjugateGradient
+  class System {
+    template <class T>
+    using AlignedVector = std::vector<T, Eigen::aligned_allocator<T> >;
+    typedef Eigen::Map<VectorD> MapD;
+    typedef Eigen::Map<const VectorD> ConstMapD;
+
+    ParallelOptions parallel_;
+    size_t nrCameras_;
+
+    // The Schur factors, and for each their first observation, P and P E' b
+    std::vector<const SchurFactor*> factors_;
+    std::vector<size_t> factorStart_;
+    AlignedVector<Matrix3> P_;
+    std::vector<Vector3> Pw_;
+
+    // Every observation of a camera by a Schur factor, with its G = F' E
+    std::vector<size_t> obsCamera_, obsFactor_;
+    AlignedVector<MatrixD3> G_;
+
+    // The observations of every camera
+    std::vector<size_t> cameraStart_, cameraObs_;
+
+    // Per camera the sum of F'F and of the diagonal blocks of other factors,
+    // the Cholesky factor of the preconditioner, and the off-diagonal blocks
+    // of other factors
+    AlignedVector<MatrixDD> diagonal_, L_;
+    std::vector<size_t> neighborStart_, neighborCamera_;
+    AlignedVector<MatrixDD> neighborBlock_;
+
+    Vector b_;                         ///< Information vector
+    mutable std::vector<Vector3> d_;  ///< P sum_k G_k' x_k of every factor
+
+   public:
+    System(const GaussianFactorGraph& gfg, const KeyInfo& keyInfo,
+           const ParallelOptions& parallel)
+        : parallel_(parallel), nrCameras_(keyInfo.size()) {
+      for (const auto& key_info : keyInfo) {
+        if (key_info.second.dim != static_cast<size_t>(D))
+          throw std::invalid_argument(
+              "SchurPCGSolver: all variables need to be cameras");
+      }
+      diagonal_.assign(nrCameras_, MatrixDD::Zero());
+      b_ = Vector::Zero(nrCameras_ * D);
+
+      // Other factors are added as their Hessian
+      std::map<std::pair<size_t, size_t>, MatrixDD> offDiagonal;
+      factorStart_.push_back(0);
+      for (const auto& factor : gfg) {
+        if (!factor) continue;
+        if (auto schur = dynamic_cast<const SchurFactor*>(factor.get())) {
+          if (schur->E().cols() != 3)
+            throw std::invalid_argument(
+                "SchurPCGSolver: Schur factors need 3D points");
+          factors_.push_back(schur);
+          for (const Key key : schur->keys()) {
+            obsCamera_.push_back(keyInfo.at(key).index);
+            obsFactor_.push_back(factors_.size() - 1);
+          }
+          factorStart_.push_back(obsCamera_.size());
+          continue;
+        }
+        const Matrix information = factor->augmentedInformation();
+        const size_t n = factor->size();
+        for (size_t i = 0; i < n; ++i) {
+          const size_t ci = keyInfo.at(factor->keys()[i]).index;
+          diagonal_[ci] += information.template block<D, D>(D * i, D * i);
+          b_.segment<D>(D * ci) += information.template block<D, 1>(D * i, D * n);
+          for (size_t j = 0; j < n; ++j) {
+            if (j == i) continue;
+            const size_t cj = keyInfo.at(factor->keys()[j]).index;
+            auto it = offDiagonal.emplace(std::make_pair(ci, cj), MatrixDD::Zero()).first;
+            it->second += information.template block<D, D>(D * i, D * j);
+          }
+        }
+      }
+      neighborStart_.assign(nrCameras_ + 1, 0);
+      for (const auto& block : offDiagonal) {
+        ++neighborStart_[block.first.first + 1];
+        neighborCamera_.push_back(block.first.second);
+        neighborBlock_.push_back(block.second);
+      }
+      for (size_t c = 0; c < nrCameras_; ++c) neighborStart_[c + 1] += neighborStart_[c];
+
+      // Sort the observations by camera
+      cameraStart_.assign(nrCameras_ + 1, 0);
+      for (const size_t c : obsCamera_) ++cameraStart_[c + 1];
+      for (size_t c = 0; c < nrCameras_; ++c) cameraStart_[c + 1] += cameraStart_[c];
+      cameraObs_.resize(obsCamera_.size());
+      std::vector<size_t> next(cameraStart_.begin(), cameraStart_.end() - 1);
+      for (size_t o = 0; o < obsCamera_.size(); ++o) cameraObs_[next[obsCamera_[o]]++] = o;
+
+      // G, P and P E' b of every Schur factor
+      const size_t nrFactors = factors_.size();
+      P_.resize(nrFactors);
+      Pw_.resize(nrFactors);
+      d_.resize(nrFactors);
+      G_.resize(obsCamera_.size());
+      parallelFor(0, nrFactors, [&](size_t first, size_t last) {
+        for (size_t f = first; f < last; ++f) {
+          const SchurFactor& factor = *factors_[f];
+          P_[f] = factor.getPointCovariance();
+          Pw_[f] = P_[f] * (factor.E().transpose() * factor.b());
+          for (size_t k = 0; k < factor.size(); ++k)
+            G_[factorStart_[f] + k] = factor.FBlocks()[k].transpose() *
+                                      factor.E().template block<2, 3>(2 * k, 0);
+        }
+      }, parallel_.resolved(nrFactors, 64));
+
+      // Gather F'F, F'b - G P E'b and the preconditioner for every camera
+      L_.resize(nrCameras_);
+      std::vector<Key> indeterminant(nrCameras_, 0);
+      std::vector<char> failed(nrCameras_, 0);
+      parallelFor(0, nrCameras_, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+          MatrixDD schur = MatrixDD::Zero();
+          for (size_t i = cameraStart_[c]; i < cameraStart_[c + 1]; ++i) {
+            const size_t o = cameraObs_[i], f = obsFactor_[o];
+            const size_t k = o - factorStart_[f];
+            const auto& F = factors_[f]->FBlocks()[k];
+            diagonal_[c] += F.transpose() * F;
+            b_.segment<D>(D * c) += F.transpose() * factors_[f]->b().template segment<2>(2 * k) -
+                                    G_[o] * Pw_[f];
+            schur += G_[o] * P_[f] * G_[o].transpose();
+          }
+          const Eigen::LLT<MatrixDD> llt(diagonal_[c] - schur);
+          if (llt.info() != Eigen::Success)
+            failed[c] = 1;
+          else
+            L_[c] = llt.matrixL();
+        }
+      }, parallel_.resolved(nrCameras_, 8));
+      for (size_t c = 0; c < nrCameras_; ++c)
+        if (failed[c]) throw IndeterminantLinearSystemException(keyInfo.ordering()[c]);
+    }
+
+    /// y = A x
+    void multiply(const Vector& x, Vector& y) const {
+      const size_t nrFactors = factors_.size();
+      parallelFor(0, nrFactors, [&](size_t first, size_t last) {
+        for (size_t f = first; f < last; ++f) {
+          Vector3 d = Vector3::Zero();
+          for (size_t o = factorStart_[f]; o < factorStart_[f + 1]; ++o)
+            d += G_[o].transpose() * ConstMapD(x.data() + D * obsCamera_[o]);
+          d_[f] = P_[f] * d;
+        }
+      }, parallel_.resolved(nrFactors, 64));
+
+      y.resize(x.size());
+      parallelFor(0, nrCameras_, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+          VectorD yc = diagonal_[c] * ConstMapD(x.data() + D * c);
+          for (size_t i = cameraStart_[c]; i < cameraStart_[c + 1]; ++i) {
+            const size_t o = cameraObs_[i];
+            yc -= G_[o] * d_[obsFactor_[o]];
+          }
+          for (size_t i = neighborStart_[c]; i < neighborStart_[c + 1]; ++i)
+            yc += neighborBlock_[i] * ConstMapD(x.data() + D * neighborCamera_[i]);
+          MapD(y.data() + D * c) = yc;
+        }
+      }, parallel_.resolved(nrCameras_, 8));
+    }
+
+    /// r = b - A x
+    void residual(const Vector& x, Vector& r) const {
+      multiply(x, r);
+      r = b_ - r;
+    }
+
+    /// y = L^{-1} x, for the preconditioner L L'
+    void leftPrecondition(const Vector& x, Vector& y) const {
+      y.resize(x.size());
+      for (size_t c = 0; c < nrCameras_; ++c)
+        MapD(y.data() + D * c) = L_[c].template triangularView<Eigen::Lower>().solve(
+            ConstMapD(x.data() + D * c));
+    }
+
+    /// y = L^{-T} x, for the preconditioner L L'
+    void rightPrecondition(const Vector& x, Vector& y) const {
+      y.resize(x.size());
+      for (size_t c = 0; c < nrCameras_; ++c)
+        MapD(y.data() + D * c) =
+            L_[c].transpose().template triangularView<Eigen::Upper>().solve(
+                ConstMapD(x.data() + D * c));
+    }
+
+    void scal(const double alpha, Vector& x) const { x *= alpha; }
+    double dot(const Vector& x, const Vector& y) const { return x.dot(y); }
+    void axpy(const double alpha, const Vector& x, Vector& y) const { y += alpha * x; }
+
+    /// The information vector
+    void getb(Vector& b) const { b = b_; }
+  };
+
+ private:
+  ConjugateGradientParameters parameters_;
+  ParallelOptions parallel_;
+
+ public:
+  explicit SchurPCGSolver(const SchurPCGSolverParameters& parameters)
+      : parameters_(parameters), parallel_(parameters.parallel) {}
+
+  using Base::optimize;
+
+  /// Solve gfg, the extra damping lambda is ignored as in PCGSolver
+  VectorValues optimize(const GaussianFactorGraph& gfg, const KeyInfo& keyInfo,
+                        const std::map<Key, Vector>& /*lambda*/,
+                        const VectorValues& initial) override {
+    const System system(gfg, keyInfo, parallel_);
+    const Vector x0 = initial.vector(keyInfo.ordering());
+    return buildVectorValues(preconditionedConjugateGradient(system, x0, parameters_),
+                             keyInfo);
+  }
+};
+
+template <class CAMERA>
+const int SchurPCGSolver<CAMERA>::D;
+
+}  // namespace gtsam
@@ -205,27 +205,31 @@ protected:
       boost::optional<typename Cameras::FBlocks&> Fs = boost::none,  //
       boost::optional<Matrix&> E = boost::none) const {
     Vector ue = cameras.reprojectionError(point, measured_, Fs, E);
-    if (body_P_sensor_ && Fs) {
-      const Pose3 sensor_P_body = body_P_sensor_->inverse();
-      constexpr int camera_dim = traits<CAMERA>::dimension;
-      constexpr int pose_dim = traits<Pose3>::dimension;
-
-      for (size_t i = 0; i < Fs->size(); i++) {
-        const Pose3 world_P_body = cameras[i].pose() * sensor_P_body;
-        Eigen::Matrix<double, camera_dim, camera_dim> J;
-        J.setZero();
-        Eigen::Matrix<double, pose_dim, pose_dim> H;
-        // Call compose to compute Jacobian for camera extrinsics
-        world_P_body.compose(*body_P_sensor_, H);
-        // Assign extrinsics part of the Jacobian
-        J.template block<pose_dim, pose_dim>(0, 0) = H;
-        Fs->at(i) = Fs->at(i) * J;
-      }
-    }
+    if (body_P_sensor_ && Fs)
+      applyBodyTransform(cameras, *Fs);
     correctForMissingMeasurements(cameras, ue, Fs, E);
     return ue;
   }
 
+  /// Chain the derivatives Fs wrpt the cameras with those of the cameras wrpt the bodies
+  void applyBodyTransform(const Cameras& cameras, FBlocks& Fs) const {
+    const Pose3 sensor_P_body = body_P_sensor_->inverse();
+    constexpr int camera_dim = traits<CAMERA>::dimension;
+    constexpr int pose_dim = traits<Pose3>::dimension;
+
+    for (size_t i = 0; i < Fs.size(); i++) {
+      const Pose3 world_P_body = cameras[i].pose() * sensor_P_body;
+      Eigen::Matrix<double, camera_dim, camera_dim> J;
+      J.setZero();
+      Eigen::Matrix<double, pose_dim, pose_dim> H;
+      // Call compose to compute Jacobian for camera extrinsics
+      world_P_body.compose(*body_P_sensor_, H);
+      // Assign extrinsics part of the Jacobian
+      J.template block<pose_dim, pose_dim>(0, 0) = H;
+      Fs.at(i) = Fs.at(i) * J;
+    }
+  }
+
   /**
    * This corrects the Jacobians for the case in which some pixel measurement is missing (nan)
    * In practice, this does not do anything in the monocular case, but it is implemented in the stereo version
@@ -327,6 +331,54 @@ protected:
     Cameras::UpdateSchurComplement(Fs, E, b, allKeys, keys_, augmentedHessian);
   }
 
+  /**
+   * Linearize at a point into the augmented Hessian of a RegularHessianFactor
+   * on keys_, overwriting its upper triangle. The whitened Jacobians and errors
+   * are computed camera by camera into fixed-size blocks, which are kept per
+   * thread rather than in the factor, so re-linearizing allocates no memory
+   * once the blocks are large enough. As in correctForMissingMeasurements,
+   * measurement components with a nan error, e.g. a missing right pixel of a
+   * stereo point, are dropped.
+   */
+  void fillHessian(const Cameras& cameras, const Point3& point,
+      SymmetricBlockMatrix& augmentedHessian, const double lambda = 0.0,
+      bool diagonalDamping = false) const {
+    static thread_local FBlocks F;
+    static thread_local typename Cameras::template EBlocks<3> E;
+    static thread_local typename Cameras::BBlocks b;
+    size_t m = cameras.size();
+    F.resize(m);
+    E.resize(m);
+    b.resize(m);
+
+    // Project, as unwhitenedError does
+    for (size_t i = 0; i < m; i++) {
+      const Z predicted = cameras[i].project2(point, F[i], E[i]);
+      b[i] = traits<Z>::Local(measured_[i], predicted);
+      for (int k = 0; k < ZDim; k++) {
+        if (std::isnan(b[i](k))) {
+          F[i].row(k).setZero();
+          E[i].row(k).setZero();
+          b[i](k) = 0;
+        }
+      }
+    }
+    if (body_P_sensor_)
+      applyBodyTransform(cameras, F);
+
+    // b = -error, and whiten with the isotropic noise model
+    const double invSigma = 1.0 / noiseModel_->sigma();
+    for (size_t i = 0; i < m; i++) {
+      F[i] *= invSigma;
+      E[i] *= invSigma;
+      b[i] *= -invSigma;
+    }
+
+    Matrix3 P;
+    Cameras::template ComputePointCovariance<3>(P, E, lambda, diagonalDamping);
+    Cameras::template SchurComplement<3>(F, E, P, b, augmentedHessian);
+  }
+
   /// Whiten the Jacobians computed by computeJacobians using noiseModel_
   void whitenJacobians(FBlocks& F, Matrix& E, Vector& b) const {
     noiseModel_->WhitenSystem(E, b);
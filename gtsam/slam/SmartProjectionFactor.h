@@ -28,6 +28,7 @@
 
 #include <boost/optional.hpp>
 #include <boost/make_shared.hpp>
+#include <typeinfo>
 #include <vector>
 
 namespace gtsam {
@@ -62,6 +63,9 @@ protected:
   /// @{
   mutable TriangulationResult result_; ///< result from triangulateSafe
   mutable std::vector<Pose3, Eigen::aligned_allocator<Pose3> > cameraPosesTriangulation_; ///< current triangulation poses
+  mutable size_t cachedVersion_ = 0; ///< Values::version() of cachedCameras_ and result_, 0 if none
+  mutable CameraSet<CAMERA> cachedCameras_; ///< cameras at the Values with cachedVersion_
+  mutable size_t cacheHits_ = 0, cacheMisses_ = 0; ///< lookups in cachedCameras()
   /// @}
 
 public:
@@ -93,6 +97,14 @@ public:
   virtual ~SmartProjectionFactor() {
   }
 
+  /// @return a deep copy of this factor, derived classes that do not override this cannot be
+  /// cloned, so that they are not sliced
+  gtsam::NonlinearFactor::shared_ptr clone() const override {
+    if (typeid(*this) != typeid(This)) return Base::clone();
+    return boost::static_pointer_cast<gtsam::NonlinearFactor>(
+        gtsam::NonlinearFactor::shared_ptr(new This(*this)));
+  }
+
   /**
    * print
    * @param s optional string naming the factor
@@ -159,13 +171,44 @@ public:
     if (m < 2) // if we have a single pose the corresponding factor is uninformative
       return TriangulationResult::Degenerate();
 
+    // the cached cameras have been triangulated already
+    if (&cameras == &cachedCameras_ && cachedVersion_ != 0)
+      return result_;
+
     bool retriangulate = decideIfTriangulate(cameras);
-    if (retriangulate)
+    if (retriangulate) {
+      cachedVersion_ = 0;
       result_ = gtsam::triangulateSafe(cameras, this->measured_,
           params_.triangulation);
+    }
     return result_;
   }
 
+  /**
+   * The cameras at values, with the point triangulated at them in result_.
+   * Both are cached for the Values::version() of values, so that error,
+   * linearize and point share them as long as values is not modified.
+   */
+  const Cameras& cachedCameras(const Values& values) const {
+    if (values.version() == cachedVersion_
+        && cachedCameras_.size() == this->keys_.size()) {
+      ++cacheHits_;
+      return cachedCameras_;
+    }
+    ++cacheMisses_;
+    cachedVersion_ = 0;
+    cachedCameras_ = this->cameras(values);
+    triangulateSafe(cachedCameras_);
+    cachedVersion_ = values.version();
+    return cachedCameras_;
+  }
+
+  /// Number of calls to cachedCameras that reused the cameras and triangulation
+  size_t cacheHits() const { return cacheHits_; }
+
+  /// Number of calls to cachedCameras that had to recompute them
+  size_t cacheMisses() const { return cacheMisses_; }
+
   /// triangulate
   bool triangulateForLinearize(const Cameras& cameras) const {
     triangulateSafe(cameras); // imperative, might reset result_
@@ -199,7 +242,18 @@ public:
           Gs, gs, 0.0);
     }
 
-    // Jacobian could be 3D Point3 OR 2D Unit3, difference is E.cols().
+    // Triangulated point: build the augmented hessian from fixed-size blocks
+    if (result_) {
+      std::vector<DenseIndex> dims(numKeys + 1, Base::Dim); // this also includes the b term
+      dims.back() = 1;
+      size_t M1 = Base::Dim * numKeys + 1;
+      auto factor = boost::make_shared<RegularHessianFactor<Base::Dim> >(
+          this->keys_, SymmetricBlockMatrix(dims, Matrix::Zero(M1, M1)));
+      Base::fillHessian(cameras, *result_, factor->info(), lambda, diagonalDamping);
+      return factor;
+    }
+
+    // Otherwise the Jacobian could still be for a 2D Unit3, difference is E.cols().
     std::vector<typename Base::MatrixZD, Eigen::aligned_allocator<typename Base::MatrixZD> > Fblocks;
     Matrix E;
     Vector b;
@@ -239,7 +293,7 @@ public:
   /// Create a factor, takes values
   boost::shared_ptr<JacobianFactorQ<Base::Dim, 2> > createJacobianQFactor(
       const Values& values, double lambda) const {
-    return createJacobianQFactor(this->cameras(values), lambda);
+    return createJacobianQFactor(cachedCameras(values), lambda);
   }
 
   /// different (faster) way to compute Jacobian factor
@@ -255,19 +309,19 @@ public:
   /// linearize to a Hessianfactor
   virtual boost::shared_ptr<RegularHessianFactor<Base::Dim> > linearizeToHessian(
       const Values& values, double lambda = 0.0) const {
-    return createHessianFactor(this->cameras(values), lambda);
+    return createHessianFactor(cachedCameras(values), lambda);
   }
 
   /// linearize to an Implicit Schur factor
   virtual boost::shared_ptr<RegularImplicitSchurFactor<CAMERA> > linearizeToImplicit(
       const Values& values, double lambda = 0.0) const {
-    return createRegularImplicitSchurFactor(this->cameras(values), lambda);
+    return createRegularImplicitSchurFactor(cachedCameras(values), lambda);
   }
 
   /// linearize to a JacobianfactorQ
   virtual boost::shared_ptr<JacobianFactorQ<Base::Dim, 2> > linearizeToJacobian(
       const Values& values, double lambda = 0.0) const {
-    return createJacobianQFactor(this->cameras(values), lambda);
+    return createJacobianQFactor(cachedCameras(values), lambda);
   }
 
   /**
@@ -300,8 +354,7 @@ public:
   boost::shared_ptr<GaussianFactor> linearizeDamped(const Values& values,
       const double lambda = 0.0) const {
     // depending on flag set on construction we may linearize to different linear factors
-    Cameras cameras = this->cameras(values);
-    return linearizeDamped(cameras, lambda);
+    return linearizeDamped(cachedCameras(values), lambda);
   }
 
   /// linearize
@@ -310,6 +363,30 @@ public:
     return linearizeDamped(values);
   }
 
+  /**
+   * Linearize into \c linearized. In HESSIAN mode, if the point triangulates and
+   * \c linearized is a RegularHessianFactor on the same keys that is not shared,
+   * e.g. from the previous iteration of an optimizer, its augmented information
+   * is overwritten in place. Otherwise \c linearized is replaced by linearize().
+   */
+  void linearizeInto(const Values& values,
+      boost::shared_ptr<GaussianFactor>& linearized) const override {
+    typedef RegularHessianFactor<Base::Dim> HessianFactorD;
+    if (params_.linearizationMode != HESSIAN || !linearized || !linearized.unique()
+        || typeid(*linearized) != typeid(HessianFactorD)
+        || linearized->keys() != this->keys_) {
+      linearized = linearize(values);
+      return;
+    }
+    const Cameras& cameras = cachedCameras(values);
+    if (!triangulateForLinearize(cameras)) {
+      linearized = createHessianFactor(cameras);
+      return;
+    }
+    HessianFactorD& hessian = static_cast<HessianFactorD&>(*linearized);
+    Base::fillHessian(cameras, *result_, hessian.info());
+  }
+
   /**
    * Triangulate and compute derivative of error with respect to point
    * @return whether triangulation worked
@@ -326,8 +403,7 @@ public:
    * @return whether triangulation worked
    */
   bool triangulateAndComputeE(Matrix& E, const Values& values) const {
-    Cameras cameras = this->cameras(values);
-    return triangulateAndComputeE(E, cameras);
+    return triangulateAndComputeE(E, cachedCameras(values));
   }
 
   /// Compute F, E only (called below in both vanilla and SVD versions)
@@ -353,7 +429,7 @@ public:
   bool triangulateAndComputeJacobians(
       std::vector<typename Base::MatrixZD, Eigen::aligned_allocator<typename Base::MatrixZD> >& Fblocks, Matrix& E, Vector& b,
       const Values& values) const {
-    Cameras cameras = this->cameras(values);
+    const Cameras& cameras = cachedCameras(values);
     bool nonDegenerate = triangulateForLinearize(cameras);
     if (nonDegenerate)
       computeJacobiansWithTriangulatedPoint(Fblocks, E, b, cameras);
@@ -364,7 +440,7 @@ public:
   bool triangulateAndComputeJacobiansSVD(
       std::vector<typename Base::MatrixZD, Eigen::aligned_allocator<typename Base::MatrixZD> >& Fblocks, Matrix& Enull, Vector& b,
       const Values& values) const {
-    Cameras cameras = this->cameras(values);
+    const Cameras& cameras = cachedCameras(values);
     bool nonDegenerate = triangulateForLinearize(cameras);
     if (nonDegenerate)
       Base::computeJacobiansSVD(Fblocks, Enull, b, cameras, *result_);
@@ -373,7 +449,7 @@ public:
 
   /// Calculate vector of re-projection errors, before applying noise model
   Vector reprojectionErrorAfterTriangulation(const Values& values) const {
-    Cameras cameras = this->cameras(values);
+    const Cameras& cameras = cachedCameras(values);
     bool nonDegenerate = triangulateForLinearize(cameras);
     if (nonDegenerate)
       return Base::unwhitenedError(cameras, *result_);
@@ -390,9 +466,10 @@ public:
   double totalReprojectionError(const Cameras& cameras,
       boost::optional<Point3> externalPoint = boost::none) const {
 
-    if (externalPoint)
+    if (externalPoint) {
+      cachedVersion_ = 0;
       result_ = TriangulationResult(*externalPoint);
-    else
+    } else
       result_ = triangulateSafe(cameras);
 
     if (result_)
@@ -411,7 +488,7 @@ public:
   /// Calculate total reprojection error
   double error(const Values& values) const override {
     if (this->active(values)) {
-      return totalReprojectionError(Base::cameras(values));
+      return totalReprojectionError(cachedCameras(values));
     } else { // else of active flag
       return 0.0;
     }
@@ -424,8 +501,7 @@ public:
 
   /** COMPUTE the landmark */
   TriangulationResult point(const Values& values) const {
-    Cameras cameras = this->cameras(values);
-    return triangulateSafe(cameras);
+    return triangulateSafe(cachedCameras(values));
   }
 
   /// Is result valid?
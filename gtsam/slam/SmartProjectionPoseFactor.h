@@ -97,6 +97,12 @@ public:
   virtual ~SmartProjectionPoseFactor() {
   }
 
+  /// @return a deep copy of this factor
+  gtsam::NonlinearFactor::shared_ptr clone() const override {
+    return boost::static_pointer_cast<gtsam::NonlinearFactor>(
+        gtsam::NonlinearFactor::shared_ptr(new This(*this)));
+  }
+
   /**
    * print
    * @param s optional string naming the factor
@@ -119,7 +125,7 @@ public:
    */
   double error(const Values& values) const override {
     if (this->active(values)) {
-      return this->totalReprojectionError(cameras(values));
+      return this->totalReprojectionError(this->cachedCameras(values));
     } else { // else of active flag
       return 0.0;
     }
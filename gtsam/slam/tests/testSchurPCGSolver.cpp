@@ -0,0 +1,130 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testSchurPCGSolver.cpp
+ * @brief   Unit tests for the matrix-free Schur PCG solver
+ * @date    Oct 16, 2026
+ */
+
+#include "smartFactorScenarios.h"
+#include <gtsam/slam/SchurPCGSolver.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <CppUnitLite/TestHarness.h>
+
+static const Key c1 = 1, c2 = 2, c3 = 3;
+
+namespace {
+// Five landmarks seen by three cameras, the first two of which have priors
+template <class SMART, class CAMERA, class PRIOR>
+NonlinearFactorGraph graph(const SMART& smart, const CAMERA& cam1, const CAMERA& cam2,
+                           const CAMERA& cam3, const PRIOR& prior1, const PRIOR& prior2) {
+  KeyVector views{c1, c2, c3};
+  NonlinearFactorGraph graph;
+  for (const Point3& landmark : {landmark1, landmark2, landmark3, landmark4, landmark5}) {
+    typename CAMERA::MeasurementVector measurements;
+    projectToMultipleCameras(cam1, cam2, cam3, landmark, measurements);
+    auto factor = boost::make_shared<SMART>(smart);
+    factor->add(measurements, views);
+    graph.push_back(factor);
+  }
+  const auto noisePrior = noiseModel::Isotropic::Sigma(traits<PRIOR>::dimension, 1e-3);
+  graph.addPrior(c1, prior1, noisePrior);
+  graph.addPrior(c2, prior2, noisePrior);
+  return graph;
+}
+
+// The bundler scenario, with the calibration of the cameras unknown
+NonlinearFactorGraph bundlerGraph(LinearizationMode mode) {
+  using namespace bundler;
+  SmartProjectionParams params;
+  params.setLinearizationMode(mode);
+  return graph(SmartFactor(unit2, params), cam1, cam2, cam3, cam1, cam2);
+}
+
+// Its linearization at a perturbed third camera, damped as by LM
+GaussianFactorGraph damped(LinearizationMode mode) {
+  using namespace bundler;
+  Values values;
+  values.insert(c1, cam1);
+  values.insert(c2, cam2);
+  values.insert(c3, perturbCameraPose(cam3));
+  GaussianFactorGraph gfg = *bundlerGraph(mode).linearize(values);
+  for (const Key key : {c1, c2, c3})
+    gfg.emplace_shared<JacobianFactor>(key, I_9x9, Vector9::Zero());
+  return gfg;
+}
+
+template <class CAMERA>
+boost::shared_ptr<typename SchurPCGSolver<CAMERA>::Parameters> tightParameters() {
+  auto parameters = boost::make_shared<typename SchurPCGSolver<CAMERA>::Parameters>();
+  parameters->setEpsilon_rel(1e-14);
+  parameters->setEpsilon_abs(1e-14);
+  return parameters;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(SchurPCGSolver, solve) {
+  const VectorValues expected = damped(HESSIAN).optimize();
+  const VectorValues actual =
+      tightParameters<bundler::Camera>()->solve(damped(IMPLICIT_SCHUR));
+  EXPECT(assert_equal(expected, actual, 1e-6));
+}
+
+/* ************************************************************************* */
+TEST(SchurPCGSolver, threads) {
+  // Sums are in the same order, but Eigen vectorizes depending on alignment
+  const GaussianFactorGraph gfg = damped(IMPLICIT_SCHUR);
+  auto serial = tightParameters<bundler::Camera>();
+  serial->parallel = ParallelOptions::Serial();
+  auto parallel = tightParameters<bundler::Camera>();
+  parallel->parallel = ParallelOptions(4, 1);
+  EXPECT(assert_equal(serial->solve(gfg), parallel->solve(gfg), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(SchurPCGSolver, levenbergMarquardt) {
+  using namespace vanillaPose;
+  SmartProjectionParams params;
+  params.setLinearizationMode(IMPLICIT_SCHUR);
+  const NonlinearFactorGraph graph = ::graph(SmartFactor(unit2, sharedK, params), cam1,
+                                             cam2, cam3, cam1.pose(), cam2.pose());
+  Values values;
+  values.insert(c1, cam1.pose());
+  values.insert(c2, cam2.pose());
+  values.insert(c3, cam3.pose() * Pose3(Rot3::Ypr(-M_PI / 10, 0., -M_PI / 10),
+                                       Point3(0.5, 0.1, 0.3)));
+
+  LevenbergMarquardtParams lmParams;
+  lmParams.relativeErrorTol = 1e-8;
+  lmParams.absoluteErrorTol = 0;
+  lmParams.linearSolverType = NonlinearOptimizerParams::Iterative;
+  lmParams.iterativeParams = tightParameters<Camera>();
+  const Values actual = LevenbergMarquardtOptimizer(graph, values, lmParams).optimize();
+  EXPECT_DOUBLES_EQUAL(0.0, graph.error(actual), 1e-9);
+  EXPECT(assert_equal(cam3.pose(), actual.at<Pose3>(c3), 1e-6));
+}
+
+/* ************************************************************************* */
+TEST(SchurPCGSolver, onlyCameras) {
+  GaussianFactorGraph gfg = damped(IMPLICIT_SCHUR);
+  gfg.emplace_shared<JacobianFactor>(4, I_3x3, Vector3::Zero());
+  CHECK_EXCEPTION(tightParameters<bundler::Camera>()->solve(gfg), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
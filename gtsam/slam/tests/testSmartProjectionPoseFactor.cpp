@@ -1079,6 +1079,94 @@ TEST( SmartProjectionPoseFactor, Hessian ) {
   // check that it is correctly scaled when using noiseProjection = [1/4  0; 0 1/4]
 }
 
+/* *************************************************************************/
+TEST( SmartProjectionPoseFactor, linearizeInto ) {
+
+  using namespace vanillaPose;
+
+  KeyVector views {x1, x2, x3};
+
+  Point2Vector measurements_cam1;
+  projectToMultipleCameras(cam1, cam2, cam3, landmark1, measurements_cam1);
+
+  SmartFactor::shared_ptr smartFactor1(new SmartFactor(model, sharedK));
+  smartFactor1->add(measurements_cam1, views);
+
+  Pose3 noise_pose = Pose3(Rot3::Ypr(-M_PI / 10, 0., -M_PI / 10),
+      Point3(0.5, 0.1, 0.3));
+  Values values;
+  values.insert(x1, cam1.pose());
+  values.insert(x2, cam2.pose());
+  values.insert(x3, cam3.pose() * noise_pose);
+
+  // Relinearizing at other values overwrites the previous factor
+  boost::shared_ptr<GaussianFactor> linearized = smartFactor1->linearize(values);
+  const GaussianFactor* previous = linearized.get();
+  Values values2 = values;
+  values2.update(x3, cam3.pose());
+  smartFactor1->linearizeInto(values2, linearized);
+  EXPECT(linearized.get() == previous);
+  SmartFactor smartFactor2(model, sharedK);
+  smartFactor2.add(measurements_cam1, views);
+  EXPECT(assert_equal(*smartFactor2.linearize(values2), *linearized, 1e-9));
+
+  // ... unless somebody else still refers to it
+  boost::shared_ptr<GaussianFactor> shared = linearized;
+  smartFactor1->linearizeInto(values, linearized);
+  EXPECT(linearized.get() != previous);
+  EXPECT(assert_equal(*smartFactor2.linearize(values), *linearized, 1e-9));
+}
+
+/* *************************************************************************/
+TEST( SmartProjectionPoseFactor, cachedTriangulation ) {
+
+  using namespace vanillaPose;
+
+  KeyVector views {x1, x2, x3};
+
+  Point2Vector measurements_cam1;
+  projectToMultipleCameras(cam1, cam2, cam3, landmark1, measurements_cam1);
+
+  SmartFactor smartFactor1(model, sharedK);
+  smartFactor1.add(measurements_cam1, views);
+
+  Values values;
+  values.insert(x1, cam1.pose());
+  values.insert(x2, cam2.pose());
+  values.insert(x3, cam3.pose() * Pose3(Rot3::Ypr(-M_PI / 10, 0., -M_PI / 10),
+      Point3(0.5, 0.1, 0.3)));
+
+  // error, linearize and point share one triangulation at the same values
+  SmartFactor smartFactor2 = smartFactor1;
+  const double expectedError = smartFactor2.error(values);
+  EXPECT_DOUBLES_EQUAL(expectedError, smartFactor1.error(values), 1e-9);
+  EXPECT(assert_equal(*smartFactor2.linearize(values), *smartFactor1.linearize(values), 1e-9));
+  EXPECT(assert_equal(*smartFactor2.point(values), *smartFactor1.point(values)));
+  EXPECT_LONGS_EQUAL(1, smartFactor1.cacheMisses());
+  EXPECT_LONGS_EQUAL(2, smartFactor1.cacheHits());
+
+  // so does an unmodified copy of the values
+  const Values copy = values;
+  EXPECT_DOUBLES_EQUAL(expectedError, smartFactor1.error(copy), 1e-9);
+  EXPECT_LONGS_EQUAL(3, smartFactor1.cacheHits());
+
+  // modified values are triangulated anew
+  values.update(x3, cam3.pose());
+  EXPECT_DOUBLES_EQUAL(0.0, smartFactor1.error(values), 1e-7);
+  EXPECT_LONGS_EQUAL(2, smartFactor1.cacheMisses());
+  EXPECT(assert_equal(landmark1, *smartFactor1.point(values), 1e-7));
+  EXPECT_LONGS_EQUAL(4, smartFactor1.cacheHits());
+
+  // as are the same values after adding a measurement
+  const Symbol x4('X', 4);
+  values.insert(x4, cam1.pose());
+  EXPECT_DOUBLES_EQUAL(0.0, smartFactor1.error(values), 1e-7);
+  EXPECT_LONGS_EQUAL(3, smartFactor1.cacheMisses());
+  smartFactor1.add(cam1.project(landmark1), x4);
+  EXPECT_DOUBLES_EQUAL(0.0, smartFactor1.error(values), 1e-7);
+  EXPECT_LONGS_EQUAL(4, smartFactor1.cacheMisses());
+}
+
 /* *************************************************************************/
 TEST( SmartProjectionPoseFactor, HessianWithRotation ) {
   // cout << " ************************ SmartProjectionPoseFactor: rotated Hessian **********************" << endl;
@@ -1331,6 +1419,22 @@ TEST( SmartProjectionPoseFactor, Cal3BundlerRotationOnly ) {
           values.at<Pose3>(x3)));
 }
 
+/* *************************************************************************/
+TEST( SmartProjectionPoseFactor, clone ) {
+
+  using namespace vanillaPose;
+
+  SmartFactor::shared_ptr smartFactor(new SmartFactor(model, sharedK));
+  smartFactor->add(cam1.project(landmark1), x1);
+  smartFactor->add(cam2.project(landmark1), x2);
+
+  // A copy of the same type, with its own caches
+  const NonlinearFactor::shared_ptr clone = smartFactor->clone();
+  EXPECT(clone != smartFactor);
+  EXPECT(boost::dynamic_pointer_cast<SmartFactor>(clone));
+  EXPECT(smartFactor->equals(*clone));
+}
+
 /* ************************************************************************* */
 BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Constrained, "gtsam_noiseModel_Constrained");
 BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Diagonal, "gtsam_noiseModel_Diagonal");
@@ -150,6 +150,11 @@ namespace simulated2D {
       return boost::static_pointer_cast<gtsam::NonlinearFactor>(
           gtsam::NonlinearFactor::shared_ptr(new This(*this))); }
 
+  protected:
+
+    /// Linearized by NoiseModelFactor::linearize, so it can be relinearized in place
+    bool linearizesInPlace() const override { return true; }
+
   private:
 
     /// Default constructor
@@ -196,6 +201,11 @@ namespace simulated2D {
       return boost::static_pointer_cast<gtsam::NonlinearFactor>(
           gtsam::NonlinearFactor::shared_ptr(new This(*this))); }
 
+  protected:
+
+    /// Linearized by NoiseModelFactor::linearize, so it can be relinearized in place
+    bool linearizesInPlace() const override { return true; }
+
   private:
 
     /// Default constructor
@@ -243,6 +253,11 @@ namespace simulated2D {
       return boost::static_pointer_cast<gtsam::NonlinearFactor>(
           gtsam::NonlinearFactor::shared_ptr(new This(*this))); }
 
+  protected:
+
+    /// Linearized by NoiseModelFactor::linearize, so it can be relinearized in place
+    bool linearizesInPlace() const override { return true; }
+
   private:
 
     /// Default constructor
@@ -0,0 +1,173 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testAsyncISAM2.cpp
+ * @brief   Unit tests for ISAM2 relinearizing on a background thread
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/nonlinear/AsyncISAM2.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+static const auto priorModel = noiseModel::Isotropic::Sigma(3, 0.01);
+static const auto odoModel = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+
+/* ************************************************************************* */
+// Drive around a square, with a badly initialized loop closure at the end
+TEST(AsyncISAM2, loopClosure) {
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1);
+  AsyncISAM2 isam(params);
+
+  NonlinearFactorGraph graph;
+  Values initial;
+  graph.addPrior(X(0), Pose2(), priorModel);
+  initial.insert(X(0), Pose2());
+  isam.update(graph, initial);
+
+  const Pose2 odometry(1.0, 0.0, M_PI_2 / 4);
+  Pose2 pose;
+  const size_t nrPoses = 16;
+  for (size_t i = 1; i <= nrPoses; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    newFactors.emplace_shared<BetweenFactor<Pose2> >(X(i - 1), X(i), odometry, odoModel);
+    // Dead reckoning with a drift
+    pose = pose.compose(Pose2(1.05, 0.02, M_PI_2 / 4 + 0.03));
+    newValues.insert(X(i), pose);
+    if (i == nrPoses)
+      newFactors.emplace_shared<BetweenFactor<Pose2> >(X(i), X(0), Pose2(), odoModel);
+
+    // The updates themselves never relinearize
+    const ISAM2Result result = isam.update(newFactors, newValues);
+    EXPECT_LONGS_EQUAL(0, result.variablesRelinearized);
+    graph.push_back(newFactors);
+    initial.insert(newValues);
+  }
+
+  // Every wait is one relinearization of all variables, i.e. a Gauss-Newton iteration
+  for (size_t iteration = 0; iteration < 5; ++iteration) {
+    isam.waitForRelinearization();
+    isam.update();
+  }
+  isam.waitForRelinearization();
+  EXPECT(isam.relinearizations() > 0);
+
+  const Values expected = LevenbergMarquardtOptimizer(graph, initial).optimize();
+  EXPECT(assert_equal(expected, isam.calculateEstimate(), 1e-5));
+  EXPECT(assert_equal(expected.at<Pose2>(X(8)), isam.calculateEstimate<Pose2>(X(8)), 1e-5));
+  EXPECT(assert_equal(isam.calculateEstimate(), isam.isam2().calculateEstimate()));
+
+  // The front instance is relinearized: its linearization point moved
+  EXPECT(!isam.getLinearizationPoint().equals(initial, 1e-3));
+}
+
+/* ************************************************************************* */
+TEST(AsyncISAM2, noRelinearization) {
+  // Without relinearization, both instances are the same as a plain ISAM2
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1, false);
+  AsyncISAM2 isam(params);
+  ISAM2 expected(params);
+
+  NonlinearFactorGraph graph;
+  Values initial;
+  graph.addPrior(X(0), Pose2(), priorModel);
+  graph.emplace_shared<BetweenFactor<Pose2> >(X(0), X(1), Pose2(1, 0, 0.1), odoModel);
+  initial.insert(X(0), Pose2(0.1, 0, 0));
+  initial.insert(X(1), Pose2(1.2, 0.1, 0));
+  isam.update(graph, initial);
+  expected.update(graph, initial);
+
+  // Factor indices are the same across swaps
+  const FactorIndices toRemove{1};
+  isam.waitForRelinearization();
+  isam.update(NonlinearFactorGraph(), Values(), toRemove);
+  expected.update(NonlinearFactorGraph(), Values(), toRemove);
+  isam.waitForRelinearization();
+
+  EXPECT(assert_equal(expected.calculateEstimate(), isam.calculateEstimate()));
+  EXPECT(assert_equal(expected.marginalCovariance(X(0)), isam.marginalCovariance(X(0))));
+  EXPECT_LONGS_EQUAL(1, isam.isam2().getFactorsUnsafe().nrFactors());
+}
+
+/* ************************************************************************* */
+TEST(AsyncISAM2, clonedFactors) {
+  // Both instances linearize their own copies of the factors, never the caller's
+  AsyncISAM2 isam(ISAM2Params(ISAM2GaussNewtonParams(), 0.0, 1));
+  NonlinearFactorGraph graph;
+  Values initial;
+  graph.addPrior(X(0), Pose2(), priorModel);
+  graph.emplace_shared<BetweenFactor<Pose2> >(X(0), X(1), Pose2(1, 0, 0), odoModel);
+  initial.insert(X(0), Pose2(0.1, 0, 0));
+  initial.insert(X(1), Pose2(1.2, 0.1, 0));
+  isam.update(graph, initial);
+  const ISAM2 front = isam.isam2();
+  isam.waitForRelinearization();
+  const ISAM2 back = isam.isam2();
+
+  for (size_t i = 0; i < graph.size(); ++i) {
+    EXPECT(front.getFactorsUnsafe()[i] != graph[i]);
+    EXPECT(back.getFactorsUnsafe()[i] != graph[i]);
+    EXPECT(front.getFactorsUnsafe()[i] != back.getFactorsUnsafe()[i]);
+    EXPECT(graph[i]->equals(*back.getFactorsUnsafe()[i]));
+  }
+}
+
+/* ************************************************************************* */
+TEST(AsyncISAM2, backgroundReorder) {
+  // Reorderings only happen on the worker, and keep the fill below the threshold
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1, false);
+  params.reorderThreshold = 1.05;
+  AsyncISAM2 isam(params);
+  ISAM2 expected(ISAM2Params(ISAM2GaussNewtonParams(), 0.0, 1, false));
+
+  NonlinearFactorGraph graph;
+  Values initial;
+  graph.addPrior(X(0), Pose2(), priorModel);
+  initial.insert(X(0), Pose2());
+  isam.update(graph, initial);
+  expected.update(graph, initial);
+
+  for (size_t i = 1; i <= 30; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    newFactors.emplace_shared<BetweenFactor<Pose2> >(X(i - 1), X(i), Pose2(1, 0, 0), odoModel);
+    if (i >= 2)
+      newFactors.emplace_shared<BetweenFactor<Pose2> >(X(i - 2), X(i), Pose2(2, 0, 0), odoModel);
+    newValues.insert(X(i), Pose2(i + 0.1, 0.1, 0.01));
+    isam.waitForRelinearization();
+    // The first updates are batch steps anyway
+    const ISAM2Result result = isam.update(newFactors, newValues);
+    if (i > 3) EXPECT(!result.reordered);
+    expected.update(newFactors, newValues);
+  }
+  isam.waitForRelinearization();
+
+  EXPECT(isam.isam2().fillRatio() <= params.reorderThreshold);
+  EXPECT(assert_equal(expected.calculateEstimate(), isam.calculateEstimate(), 1e-6));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -26,6 +26,9 @@
 
 #include <boost/assign/list_of.hpp>
 #include <boost/range/adaptor/map.hpp>
+
+#include <thread>
+
 using namespace boost::assign;
 namespace br { using namespace boost::adaptors; using namespace boost::range; }
 
@@ -618,6 +621,91 @@ TEST(ISAM2, slamlike_solution_partial_relinearization_check)
   CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, slamlike_solution_parallel_relinearization)
+{
+  // Relinearize every step, with all threads and serially
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+  params.parallel.grainSize = 1;
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  ISAM2 isam = createSlamlikeISAM2(fullinit, fullgraph, params);
+
+  params.parallel = ParallelOptions::Serial();
+  ISAM2 serial = createSlamlikeISAM2(boost::none, boost::none, params);
+
+  CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+  EXPECT(assert_equal(serial.calculateEstimate(), isam.calculateEstimate()));
+
+  // Relinearizing all variables records the time spent
+  ISAM2UpdateParams updateParams;
+  updateParams.force_relinearize = true;
+  const ISAM2Result result = isam.update(NonlinearFactorGraph(), Values(), updateParams);
+  EXPECT(result.affectedFactorsTime >= 0.0);
+  EXPECT(result.relinearizeTime >= 0.0);
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, slamlike_solution_parallel_wildfire)
+{
+  // The wildfire threshold prunes the same cliques whether subtrees are
+  // back-substituted in parallel or serially
+  for (double threshold : {0.0, 0.001, 0.1}) {
+    for (bool dogleg : {false, true}) {
+      ISAM2Params params(ISAM2GaussNewtonParams(threshold), 0.0, 0, false);
+      if (dogleg) params.optimizationParams = ISAM2DoglegParams(1.0, threshold);
+      params.parallel = ParallelOptions(4);
+      ISAM2 isam = createSlamlikeISAM2(boost::none, boost::none, params, 20);
+
+      params.parallel = ParallelOptions::Serial();
+      ISAM2 serial = createSlamlikeISAM2(boost::none, boost::none, params, 20);
+
+      EXPECT(assert_equal(serial.getDelta(), isam.getDelta()));
+      EXPECT(assert_equal(serial.calculateEstimate(), isam.calculateEstimate()));
+    }
+  }
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, snapshot)
+{
+  ISAM2 isam = createSlamlikeISAM2(boost::none, boost::none,
+                                   ISAM2Params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false),
+                                   5);
+  const ISAM2Snapshot::shared_ptr snapshot = isam.snapshot();
+  const Values expected = isam.calculateEstimate();
+  const Matrix expectedCovariance = isam.marginalCovariance(0);
+  EXPECT(assert_equal(expected, snapshot->calculateEstimate()));
+  EXPECT(assert_equal(expected.at<Pose2>(0), snapshot->calculateEstimate<Pose2>(0)));
+  EXPECT(assert_equal(expectedCovariance, snapshot->marginalCovariance(0), 1e-9));
+
+  // Read the snapshot on two other threads while isam keeps updating
+  bool readerOk[2] = {true, true};
+  auto read = [&](size_t r) {
+    for (size_t i = 0; i < 20; ++i) {
+      readerOk[r] = readerOk[r] && assert_equal(expected, snapshot->calculateEstimate()) &&
+                    assert_equal(expectedCovariance, snapshot->marginalCovariance(0), 1e-9);
+    }
+  };
+  std::thread reader(read, 0), otherReader(read, 1);
+  Key previous = 0;
+  for (size_t i = 0; i < 10; ++i) {
+    const Key next = 200 + i;
+    NonlinearFactorGraph newFactors;
+    newFactors.emplace_shared<BetweenFactor<Pose2> >(previous, next, Pose2(1.0, 0.0, 0.0),
+                                                     odoNoise);
+    Values newValues;
+    newValues.insert(next, Pose2(i + 1.01, 0.01, 0.01));
+    isam.update(newFactors, newValues);
+    previous = next;
+  }
+  reader.join();
+  otherReader.join();
+  EXPECT(readerOk[0] && readerOk[1]);
+  EXPECT(!snapshot->valueExists(200));
+  EXPECT(assert_equal(isam.calculateEstimate(), isam.snapshot()->calculateEstimate()));
+}
+
 namespace {
   bool checkMarginalizeLeaves(ISAM2& isam, const FastList<Key>& leafKeys) {
     Matrix expectedAugmentedHessian, expected3AugmentedHessian;
@@ -807,6 +895,326 @@ TEST(ISAM2, marginalCovariance)
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, marginalCovariances)
+{
+  for (const auto factorization : {ISAM2Params::CHOLESKY, ISAM2Params::QR}) {
+    ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false, true, factorization);
+    Values fullinit;
+    NonlinearFactorGraph fullgraph;
+    ISAM2 isam = createSlamlikeISAM2(fullinit, fullgraph, params);
+
+    // Covariances are cached until an update changes them
+    for (size_t step = 0; step < 2; ++step) {
+      const Marginals marginals(isam.getFactorsUnsafe(), isam.getLinearizationPoint());
+      const KeyVector keys = isam.getLinearizationPoint().keys();
+      const FastMap<Key, Matrix> covariances = isam.marginalCovariances(keys);
+      for (Key key : keys) {
+        const Matrix expected = marginals.marginalInformation(key).inverse();
+        EXPECT(assert_equal(expected, covariances.at(key), 1e-7));
+        EXPECT(assert_equal(expected, isam.marginalCovariance(key), 1e-7));
+      }
+
+      // Add a pose closing a loop to the first one
+      NonlinearFactorGraph newFactors;
+      newFactors += BetweenFactor<Pose2>(5, 1000, Pose2(1.0, 0.0, 0.0), odoNoise);
+      newFactors += BetweenFactor<Pose2>(1000, 0, Pose2(-6.0, 0.0, 0.0), odoNoise);
+      Values newValues;
+      newValues.insert(1000, Pose2(6.01, 0.01, 0.01));
+      if (step == 0) isam.update(newFactors, newValues);
+    }
+  }
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, latencyHistograms)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+  params.evaluateNonlinearError = true;
+  ISAM2 isam(params);
+
+  NonlinearFactorGraph factors;
+  factors.addPrior(0, Pose2(), odoNoise);
+  Values values;
+  values.insert(0, Pose2(0.01, 0.01, 0.01));
+  const ISAM2Result result = isam.update(factors, values);
+
+  const ISAM2Result::Timing& timing = result.timing;
+  EXPECT(timing.total > 0.0);
+  EXPECT(timing.updateDelta + timing.addVariables + timing.relinearizeCheck +
+             timing.linearize + timing.ordering + timing.eliminate + timing.removeVariables +
+             timing.estimate <=
+         timing.total);
+  for (double phase : {timing.updateDelta, timing.addVariables, timing.relinearizeCheck,
+                       timing.linearize, timing.ordering, timing.eliminate,
+                       timing.removeVariables, timing.estimate})
+    EXPECT(phase >= 0.0);
+
+  for (size_t i = 0; i < 5; ++i) {
+    NonlinearFactorGraph newFactors;
+    newFactors += BetweenFactor<Pose2>(i, i + 1, Pose2(1.0, 0.0, 0.0), odoNoise);
+    Values newValues;
+    newValues.insert(i + 1, Pose2(i + 1.01, 0.01, 0.01));
+    isam.update(newFactors, newValues);
+  }
+  EXPECT_LONGS_EQUAL(6, isam.latencyHistograms().total.count());
+  EXPECT_LONGS_EQUAL(6, isam.latencyHistograms().eliminate.count());
+  EXPECT(isam.latencyHistograms().total.percentile(99) > 0.0);
+
+  isam.resetLatencyHistograms();
+  EXPECT_LONGS_EQUAL(0, isam.latencyHistograms().total.count());
+}
+
+/* ************************************************************************* */
+namespace {
+// Drive along a line with exact odometry, and measure every pose from the
+// one two steps back, so that old poses are not always leaves.  Relinearize at
+// every step, so that the marginals are linearized at the solution.
+void driveCompacting(ISAM2* isam, size_t steps,
+                     const std::function<void(size_t, const ISAM2Result&)>& check) {
+  NonlinearFactorGraph factors;
+  factors.addPrior(0, Pose2(), odoNoise);
+  Values values;
+  values.insert(0, Pose2(0.01, 0.01, 0.01));
+  isam->update(factors, values);
+
+  for (size_t i = 1; i <= steps; ++i) {
+    NonlinearFactorGraph newFactors;
+    newFactors += BetweenFactor<Pose2>(i - 1, i, Pose2(1.0, 0.0, 0.0), odoNoise);
+    if (i >= 2 && isam->valueExists(i - 2))
+      newFactors += BetweenFactor<Pose2>(i - 2, i, Pose2(2.0, 0.0, 0.0), odoNoise);
+    Values newValues;
+    newValues.insert(i, Pose2(i + 0.01, 0.01, 0.01));
+    ISAM2UpdateParams updateParams;
+    updateParams.timestamps = FastMap<Key, double>();
+    (*updateParams.timestamps)[i] = 0.5 * i;
+    check(i, isam->update(newFactors, newValues, updateParams));
+  }
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ISAM2, compactionMaxVariables)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1);
+  params.compaction.maxVariables = 10;
+  ISAM2 isam(params);
+
+  driveCompacting(&isam, 40, [&](size_t i, const ISAM2Result& result) {
+    // The oldest variables are marginalized as soon as there are too many
+    EXPECT_LONGS_EQUAL(std::min<size_t>(i + 1, 10), isam.getLinearizationPoint().size());
+    if (i >= 10) {
+      EXPECT_LONGS_EQUAL(1, result.marginalizedKeys.size());
+      EXPECT_LONGS_EQUAL(i - 10, result.marginalizedKeys.front());
+    }
+    EXPECT(result.memoryFootprint > 0);
+    EXPECT_LONGS_EQUAL(isam.memoryFootprint(), result.memoryFootprint);
+  });
+
+  // The marginals keep the estimate of the poses left
+  const Values estimate = isam.calculateEstimate();
+  for (Key j = 31; j <= 40; ++j)
+    EXPECT(assert_equal(Pose2(j, 0.0, 0.0), estimate.at<Pose2>(j), 1e-3));
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, compactionTimeHorizon)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1);
+  params.compaction.timeHorizon = 2.0;
+  ISAM2 isam(params);
+
+  // Pose 0 was added before any timestamp, so it is older than all of them
+  driveCompacting(&isam, 20, [&](size_t i, const ISAM2Result& result) {
+    for (Key j = 0; j <= i; ++j)
+      EXPECT(isam.valueExists(j) == (j > 0 && 0.5 * j >= 0.5 * i - 2.0));
+  });
+  EXPECT(assert_equal(Pose2(20.0, 0.0, 0.0), isam.calculateEstimate<Pose2>(20), 1e-3));
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, compactionMaxBytes)
+{
+  // Allow about as many bytes as 8 poses take
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1);
+  params.compaction.maxVariables = 8;
+  ISAM2 reference(params);
+  driveCompacting(&reference, 20, [](size_t, const ISAM2Result&) {});
+  params.compaction.maxVariables = 0;
+  params.compaction.maxBytes = reference.memoryFootprint();
+
+  ISAM2 isam(params);
+  driveCompacting(&isam, 40, [&](size_t i, const ISAM2Result& result) {
+    if (i > 20) EXPECT(result.memoryFootprint <= 1.25 * params.compaction.maxBytes);
+  });
+  EXPECT(isam.getLinearizationPoint().size() < 12);
+  EXPECT(assert_equal(Pose2(40.0, 0.0, 0.0), isam.calculateEstimate<Pose2>(40), 1e-3));
+}
+
+/* ************************************************************************* */
+namespace {
+size_t countNonzeros(const ISAM2& isam) {
+  size_t nonzeros = 0;
+  for (const auto& root : isam.roots()) nonzeros += root->calculate_nnz();
+  return nonzeros;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ISAM2, nonzeros)
+{
+  ISAM2 isam = createSlamlikeISAM2();
+  EXPECT_LONGS_EQUAL(countNonzeros(isam), isam.nonzeros());
+  EXPECT(isam.fillRatio() > 0.0);
+
+  // Also while marginalizing, which splits and removes cliques
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1);
+  params.compaction.maxVariables = 10;
+  ISAM2 compacting(params);
+  driveCompacting(&compacting, 30, [&](size_t, const ISAM2Result&) {
+    EXPECT_LONGS_EQUAL(countNonzeros(compacting), compacting.nonzeros());
+  });
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, forceReorder)
+{
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  ISAM2 isam = createSlamlikeISAM2(fullinit, fullgraph, ISAM2Params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false));
+
+  ISAM2UpdateParams updateParams;
+  updateParams.forceReorder = true;
+  const ISAM2Result result = isam.update(NonlinearFactorGraph(), Values(), updateParams);
+  EXPECT(result.reordered);
+  EXPECT_LONGS_EQUAL(fullinit.size(), result.variablesReeliminated);
+  EXPECT_DOUBLES_EQUAL(1.0, isam.fillRatio(), 1e-9);
+  EXPECT_LONGS_EQUAL(countNonzeros(isam), isam.nonzeros());
+  CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+
+  // Without new variables or relinearization there is nothing to do
+  EXPECT(!isam.update().reordered);
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, reorderThreshold)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1);
+  params.reorderThreshold = 1.05;
+  ISAM2 isam(params);
+
+  // Every update that finds the fill above the threshold reorders everything
+  size_t reorderings = 0;
+  double fillRatio = isam.fillRatio();
+  driveCompacting(&isam, 40, [&](size_t, const ISAM2Result& result) {
+    if (fillRatio > params.reorderThreshold) EXPECT(result.reordered);
+    if (result.reordered) {
+      ++reorderings;
+      EXPECT_DOUBLES_EQUAL(1.0, isam.fillRatio(), 1e-9);
+    }
+    EXPECT_LONGS_EQUAL(countNonzeros(isam), isam.nonzeros());
+    fillRatio = isam.fillRatio();
+  });
+  EXPECT(reorderings > 0);
+  EXPECT(assert_equal(Pose2(40.0, 0.0, 0.0), isam.calculateEstimate<Pose2>(40), 1e-3));
+}
+
+/* ************************************************************************* */
+namespace {
+// The factors and variables of step i of driveCompacting, without timestamps
+ISAM2UpdateStep drivingStep(size_t i) {
+  ISAM2UpdateStep step;
+  step.newFactors += BetweenFactor<Pose2>(i - 1, i, Pose2(1.0, 0.0, 0.0), odoNoise);
+  step.newFactors += BetweenFactor<Pose2>(i - 2, i, Pose2(2.0, 0.0, 0.0), odoNoise);
+  step.newTheta.insert(i, Pose2(i + 0.01, 0.01, 0.01));
+  return step;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ISAM2, updateBatch)
+{
+  // Without relinearization both solve the same linear system
+  const ISAM2Params params(ISAM2GaussNewtonParams(0.0), 0.0, 1, false);
+  ISAM2 sequential(params), batched(params);
+  driveCompacting(&sequential, 10, [](size_t, const ISAM2Result&) {});
+  driveCompacting(&batched, 10, [](size_t, const ISAM2Result&) {});
+  const size_t nrSlots = batched.getFactorsUnsafe().size();
+
+  // The second step removes an existing factor, the third the second factor
+  // of the first step
+  vector<ISAM2UpdateStep> steps;
+  for (size_t i = 11; i <= 15; ++i) steps.push_back(drivingStep(i));
+  steps[1].updateParams.removeFactorIndices.push_back(nrSlots - 1);
+  steps[2].updateParams.removeFactorIndices.push_back(nrSlots + 1);
+
+  FactorIndex firstStepLoop = 0;
+  for (size_t k = 0; k < steps.size(); ++k) {
+    ISAM2UpdateParams updateParams;
+    if (k == 1) updateParams.removeFactorIndices.push_back(nrSlots - 1);
+    if (k == 2) updateParams.removeFactorIndices.push_back(firstStepLoop);
+    const ISAM2Result result =
+        sequential.update(steps[k].newFactors, steps[k].newTheta, updateParams);
+    if (k == 0) firstStepLoop = result.newFactorsIndices[1];
+  }
+
+  const vector<ISAM2Result> results = batched.updateBatch(steps);
+  LONGS_EQUAL(steps.size(), results.size());
+  for (size_t k = 0; k < steps.size(); ++k) {
+    EXPECT_LONGS_EQUAL(2, results[k].newFactorsIndices.size());
+    EXPECT_LONGS_EQUAL(nrSlots + 2 * k, results[k].newFactorsIndices[0]);
+    EXPECT_LONGS_EQUAL(nrSlots + 2 * k + 1, results[k].newFactorsIndices[1]);
+  }
+  EXPECT(!batched.getFactorsUnsafe()[nrSlots - 1]);
+  EXPECT(!batched.getFactorsUnsafe()[nrSlots + 1]);
+  EXPECT(assert_equal(sequential.getFactorsUnsafe(), batched.getFactorsUnsafe()));
+  EXPECT(assert_equal(sequential.calculateEstimate(), batched.calculateEstimate(), 1e-9));
+
+  // Both go on the same way
+  for (ISAM2* isam : {&sequential, &batched}) {
+    const ISAM2UpdateStep step = drivingStep(16);
+    isam->update(step.newFactors, step.newTheta);
+  }
+  EXPECT(assert_equal(sequential.calculateEstimate(), batched.calculateEstimate(), 1e-9));
+  EXPECT(batched.updateBatch(vector<ISAM2UpdateStep>()).empty());
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, updateBatchRelinearizes)
+{
+  // A batch relinearizes if any of its steps would have
+  const ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 5);
+  ISAM2 isam(params);
+  driveCompacting(&isam, 5, [](size_t, const ISAM2Result&) {});
+
+  vector<ISAM2UpdateStep> steps;
+  for (size_t i = 6; i <= 8; ++i) steps.push_back(drivingStep(i));
+  EXPECT_LONGS_EQUAL(0, isam.updateBatch(steps).back().variablesRelinearized);
+  steps.clear();
+  for (size_t i = 9; i <= 11; ++i) steps.push_back(drivingStep(i));
+  EXPECT(isam.updateBatch(steps).back().variablesRelinearized > 0);
+  for (size_t k = 0; k < 5; ++k) isam.update();
+  EXPECT(assert_equal(Pose2(11.0, 0.0, 0.0), isam.calculateEstimate<Pose2>(11), 1e-3));
+}
+
+#ifdef GTSAM_SUPPORT_NESTED_DISSECTION
+/* ************************************************************************* */
+TEST(ISAM2, slamlike_solution_metis)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+  params.orderingType = Ordering::METIS;
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  ISAM2 isam = createSlamlikeISAM2(fullinit, fullgraph, params);
+
+  ISAM2UpdateParams updateParams;
+  updateParams.forceReorder = true;
+  isam.update(NonlinearFactorGraph(), Values(), updateParams);
+  EXPECT_LONGS_EQUAL(countNonzeros(isam), isam.nonzeros());
+  CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+}
+#endif
+
 /* ************************************************************************* */
 TEST(ISAM2, calculate_nnz)
 {
@@ -40,7 +40,8 @@ typedef GeneralSFMFactor<PinholeCamera<Cal3Bundler>, Point3> sfmFactor;
 using symbol_shorthand::P;
 
 /* ************************************************************************* */
-TEST(PinholeCamera, BAL) {
+// The dubrovnik-3-7 problem with GeneralSFMFactors
+static NonlinearFactorGraph balGraph(Values* initial) {
   string filename = findExampleDataFile("dubrovnik-3-7-pre");
   SfmData db;
   bool success = readBAL(filename, db);
@@ -54,7 +55,14 @@ TEST(PinholeCamera, BAL) {
       graph.emplace_shared<sfmFactor>(m.second, unit2, m.first, P(j));
   }
 
-  Values initial = initialCamerasAndPointsEstimate(db);
+  *initial = initialCamerasAndPointsEstimate(db);
+  return graph;
+}
+
+/* ************************************************************************* */
+TEST(PinholeCamera, BAL) {
+  Values initial;
+  const NonlinearFactorGraph graph = balGraph(&initial);
 
   LevenbergMarquardtOptimizer lm(graph, initial);
 
@@ -63,6 +71,21 @@ TEST(PinholeCamera, BAL) {
   EXPECT_DOUBLES_EQUAL(0.0199833, actualError, 1e-5);
 }
 
+/* ************************************************************************* */
+TEST(PinholeCamera, BALSchurComplement) {
+  Values initial;
+  const NonlinearFactorGraph graph = balGraph(&initial);
+
+  // Eliminating the points in closed form converges the same way
+  LevenbergMarquardtParams params;
+  params.linearSolverType = LevenbergMarquardtParams::SCHUR_COMPLEMENT;
+  LevenbergMarquardtOptimizer lm(graph, initial, params);
+
+  Values actual = lm.optimize();
+  double actualError = graph.error(actual);
+  EXPECT_DOUBLES_EQUAL(0.0199833, actualError, 1e-5);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
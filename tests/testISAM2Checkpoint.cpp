@@ -0,0 +1,248 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testISAM2Checkpoint.cpp
+ * @brief   Unit tests for binary checkpoints of ISAM2
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/nonlinear/ISAM2Checkpoint.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/serialization/export.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+// A measurement z of x_i, or of x_j - x_i + 0.1 x_i^2, with unit noise.  It
+// has no noise model or matrices, so its serialization is that of its keys.
+class ScalarFactor : public NonlinearFactor {
+  double z_ = 0.0;
+
+ public:
+  ScalarFactor() {}
+  ScalarFactor(Key i, double z) : NonlinearFactor(KeyVector{i}), z_(z) {}
+  ScalarFactor(Key i, Key j, double z) : NonlinearFactor(KeyVector{i, j}), z_(z) {}
+
+  double residual(const Values& x) const {
+    const double xi = x.at<double>(keys_[0]);
+    if (size() == 1) return xi - z_;
+    return x.at<double>(keys_[1]) - xi + 0.1 * xi * xi - z_;
+  }
+
+  double error(const Values& x) const override { return 0.5 * pow(residual(x), 2); }
+  size_t dim() const override { return 1; }
+
+  boost::shared_ptr<GaussianFactor> linearize(const Values& x) const override {
+    const Vector1 b(-residual(x));
+    if (size() == 1) return boost::make_shared<JacobianFactor>(keys_[0], I_1x1, b);
+    const double xi = x.at<double>(keys_[0]);
+    return boost::make_shared<JacobianFactor>(keys_[0], I_1x1 * (0.2 * xi - 1.0),
+                                              keys_[1], I_1x1, b);
+  }
+
+  bool equals(const NonlinearFactor& other, double tol = 1e-9) const override {
+    const ScalarFactor* e = dynamic_cast<const ScalarFactor*>(&other);
+    return e && NonlinearFactor::equals(other, tol) && std::abs(z_ - e->z_) <= tol;
+  }
+
+ private:
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE& ar, const unsigned int /*version*/) {
+    ar& boost::serialization::make_nvp(
+        "NonlinearFactor", boost::serialization::base_object<NonlinearFactor>(*this));
+    ar& BOOST_SERIALIZATION_NVP(z_);
+  }
+};
+}  // namespace
+
+// Nonlinear factors and values are stored with boost::serialization binary
+// archives, for which these exports register them
+GTSAM_VALUE_EXPORT(double);
+BOOST_CLASS_EXPORT_GUID(ScalarFactor, "ScalarFactor");
+
+static const string filename = "testISAM2Checkpoint.bin";
+
+namespace {
+// A chain of variables, with a loop closure to the variable 8 back at every
+// third step
+ISAM2Result drive(ISAM2* isam, size_t i) {
+  NonlinearFactorGraph factors;
+  if (i == 0) {
+    factors.emplace_shared<ScalarFactor>(0, 0.0);
+  } else {
+    factors.emplace_shared<ScalarFactor>(i - 1, i, 1.0);
+    if (i >= 8 && i % 3 == 0) factors.emplace_shared<ScalarFactor>(i - 8, i, 8.0);
+  }
+  Values values;
+  values.insert(i, i == 0 ? 0.1 : isam->calculateEstimate<double>(i - 1) + 1.2);
+  return isam->update(factors, values);
+}
+
+void expectRestored(const ISAM2& expected, const ISAM2& actual, TestResult& result_,
+                    const string& name_) {
+  EXPECT(expected.equals(actual));
+  EXPECT(assert_equal(expected.getLinearizationPoint(), actual.getLinearizationPoint()));
+  EXPECT(assert_equal(expected.getDelta(), actual.getDelta()));
+  EXPECT(assert_equal(expected.calculateEstimate(), actual.calculateEstimate()));
+  EXPECT_LONGS_EQUAL(expected.nonzeros(), actual.nonzeros());
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, appendAndRestore) {
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.01, 1);
+  ISAM2 isam(params);
+  ISAM2Checkpoint checkpoint(filename);
+
+  size_t fullSize = 0;
+  for (size_t i = 0; i < 30; ++i) {
+    drive(&isam, i);
+    const size_t bytes = checkpoint.append(isam);
+    if (i == 0) fullSize = bytes;
+    ISAM2 restored = ISAM2Checkpoint::Restore(filename, params);
+    expectRestored(isam, restored, result_, name_);
+  }
+  EXPECT_LONGS_EQUAL(30, checkpoint.segments());
+
+  // Both continue the same way, which needs the cached factors to be restored
+  ISAM2 restored = ISAM2Checkpoint::Restore(filename, params);
+  for (size_t i = 30; i < 40; ++i) {
+    drive(&isam, i);
+    drive(&restored, i);
+  }
+  expectRestored(isam, restored, result_, name_);
+
+  // Rewriting leaves a single segment, smaller than all appends together
+  const uint64_t appendedSize = checkpoint.fileSize();
+  checkpoint.rewrite(isam);
+  EXPECT_LONGS_EQUAL(1, checkpoint.segments());
+  EXPECT(checkpoint.fileSize() < appendedSize);
+  EXPECT(fullSize < checkpoint.fileSize());
+  expectRestored(isam, ISAM2Checkpoint::Restore(filename, params), result_, name_);
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, appendsOnlyChanges) {
+  // Without relinearization an update only re-eliminates the top of the tree
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.0, 1, false);
+  ISAM2 isam(params);
+  ISAM2Checkpoint checkpoint(filename);
+  for (size_t i = 0; i < 60; ++i) drive(&isam, i);
+  checkpoint.append(isam);
+  const uint64_t fullSize = checkpoint.fileSize();
+
+  drive(&isam, 60);
+  const size_t appended = checkpoint.append(isam);
+  EXPECT(appended < fullSize / 3);
+
+  // Appending without changes only writes the small sets
+  EXPECT(checkpoint.append(isam) < fullSize / 50);
+  expectRestored(isam, ISAM2Checkpoint::Restore(filename, params), result_, name_);
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, truncated) {
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.01, 1);
+  ISAM2 isam(params);
+  ISAM2Checkpoint checkpoint(filename);
+  for (size_t i = 0; i < 20; ++i) drive(&isam, i);
+  checkpoint.append(isam);
+  const ISAM2 expected = isam;
+  const uint64_t size = checkpoint.fileSize();
+
+  // A crash in the middle of an append loses that segment only
+  drive(&isam, 20);
+  checkpoint.append(isam);
+  string data;
+  {
+    ifstream file(filename.c_str(), ios::binary);
+    data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  }
+  EXPECT_LONGS_EQUAL(checkpoint.fileSize(), data.size());
+  for (const size_t cut : {size_t(8), size_t(16), size_t((data.size() - size) / 2)}) {
+    vector<double> aligned((data.size() - cut + 7) / 8);
+    memcpy(aligned.data(), data.data(), data.size() - cut);
+    const ISAM2 restored = ISAM2Checkpoint::Restore(
+        reinterpret_cast<const char*>(aligned.data()), data.size() - cut, params);
+    expectRestored(expected, restored, result_, name_);
+  }
+
+  // Without a complete segment there is nothing to restore
+  CHECK_EXCEPTION(ISAM2Checkpoint::Restore(data.data(), 16, params), std::runtime_error);
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, marginalizeAndDogleg) {
+  // Marginalizing splits cliques in place, Dogleg keeps more deltas
+  ISAM2Params params(ISAM2DoglegParams(), 0.01, 1);
+  params.compaction.maxVariables = 12;
+  ISAM2 isam(params);
+  ISAM2Checkpoint checkpoint(filename);
+  for (size_t i = 0; i < 30; ++i) {
+    drive(&isam, i);
+    checkpoint.append(isam);
+    expectRestored(isam, ISAM2Checkpoint::Restore(filename, params), result_, name_);
+  }
+  EXPECT_LONGS_EQUAL(12, isam.getLinearizationPoint().size());
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, failedAppend) {
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.01, 1);
+  ISAM2 isam(params);
+  ISAM2Checkpoint checkpoint(filename);
+  for (size_t i = 0; i < 10; ++i) {
+    drive(&isam, i);
+    checkpoint.append(isam);
+  }
+
+  // An append that cannot write, here as the file was replaced by a directory
+  const string saved = filename + ".saved";
+  std::rename(filename.c_str(), saved.c_str());
+  boost::filesystem::create_directory(filename);
+  drive(&isam, 10);
+  CHECK_EXCEPTION(checkpoint.append(isam), std::runtime_error);
+  EXPECT_LONGS_EQUAL(0, checkpoint.segments());
+  boost::filesystem::remove(filename);
+  std::rename(saved.c_str(), filename.c_str());
+
+  // The next append does not build on the segment that was never written
+  drive(&isam, 11);
+  checkpoint.append(isam);
+  EXPECT_LONGS_EQUAL(1, checkpoint.segments());
+  expectRestored(isam, ISAM2Checkpoint::Restore(filename, params), result_, name_);
+  std::remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
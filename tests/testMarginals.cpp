@@ -191,6 +191,36 @@ TEST(Marginals, planarSLAMmarginals) {
   testJointMarginals(marginals);
 }
 
+/* ************************************************************************* */
+TEST(Marginals, marginalCovariances) {
+  // A loop of poses observing two landmarks
+  NonlinearFactorGraph graph;
+  Values values;
+  graph.addPrior(0, Pose2(), noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.2, 0.05)));
+  const auto odometryModel = noiseModel::Diagonal::Sigmas(Vector3(0.3, 0.2, 0.1));
+  const auto measurementModel = noiseModel::Diagonal::Sigmas(Vector2(0.05, 0.3));
+  for (size_t i = 0; i < 8; ++i) {
+    values.insert(i, Pose2(cos(i * M_PI / 4), sin(i * M_PI / 4), i * M_PI / 4 + M_PI_2));
+    graph += BetweenFactor<Pose2>(i, (i + 1) % 8, Pose2(0.77, 0, M_PI / 4), odometryModel);
+    graph += BearingRangeFactor<Pose2, Point2>(i, 100 + i % 2, Rot2::fromAngle(0.1 * i),
+                                               1.0, measurementModel);
+  }
+  values.insert(100, Point2(0.1, 0.1));
+  values.insert(101, Point2(-0.1, 0.1));
+  const KeyVector keys = values.keys();
+
+  for (Marginals::Factorization factorization : {Marginals::CHOLESKY, Marginals::QR}) {
+    const Marginals marginals(graph, values, factorization);
+    const FastMap<Key, Matrix> covariances = marginals.marginalCovariances(keys);
+    EXPECT_LONGS_EQUAL(keys.size(), covariances.size());
+    for (Key key : keys) {
+      const Matrix expected = marginals.marginalInformation(key).inverse();
+      EXPECT(assert_equal(expected, covariances.at(key), 1e-9));
+      EXPECT(assert_equal(expected, marginals.marginalCovariance(key), 1e-9));
+    }
+  }
+}
+
 /* ************************************************************************* */
 TEST(Marginals, order) {
   NonlinearFactorGraph fg;
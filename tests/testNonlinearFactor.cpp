@@ -233,6 +233,37 @@ TEST( NonlinearFactor, linearize_constraint2 )
   CHECK(assert_equal((const GaussianFactor&)expected, *actual));
 }
 
+/* ************************************************************************* */
+// A factor with its own linearize, e.g. dropping the noise model as TriangulationFactor does
+class TestLinearizeFactor : public NoiseModelFactor1<Point2> {
+public:
+  TestLinearizeFactor()
+      : NoiseModelFactor1<Point2>(noiseModel::Isotropic::Sigma(2, 0.5), symbol_shorthand::X(1)) {}
+
+  Vector evaluateError(const Point2& p, boost::optional<Matrix&> H = boost::none) const override {
+    if (H) *H = I_2x2;
+    return p;
+  }
+
+  boost::shared_ptr<GaussianFactor> linearize(const Values& x) const override {
+    return boost::make_shared<JacobianFactor>(key(), I_2x2, -x.at<Point2>(key()));
+  }
+};
+
+/* ************************************ */
+TEST( NonlinearFactor, linearizeInto_override )
+{
+  TestLinearizeFactor f0;
+  Values config;
+  config.insert(X(1), Point2(1.0, 2.0));
+
+  // Relinearizing goes through the override instead of writing the whitened system
+  GaussianFactor::shared_ptr actual = f0.linearize(config);
+  config.update(X(1), Point2(3.0, 4.0));
+  f0.linearizeInto(config, actual);
+  CHECK(assert_equal(*f0.linearize(config), *actual));
+}
+
 /* ************************************************************************* */
 class TestFactor4 : public NoiseModelFactor4<double, double, double, double> {
 public:
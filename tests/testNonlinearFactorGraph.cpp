@@ -24,6 +24,7 @@
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/symbolic/SymbolicFactorGraph.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/LinearContainerFactor.h>
 #include <gtsam/geometry/Pose2.h>
 #include <gtsam/geometry/Pose3.h>
 #include <gtsam/sam/RangeFactor.h>
@@ -116,6 +117,117 @@ TEST( NonlinearFactorGraph, linearize )
   CHECK(assert_equal(expected,linearFG)); // Needs correct linearizations
 }
 
+/* ************************************************************************* */
+TEST( NonlinearFactorGraph, linearizeParallel )
+{
+  // A graph with a null factor, linearized with tasks of a single factor
+  const NonlinearFactorGraph small = createNonlinearFactorGraph();
+  NonlinearFactorGraph fg = small;
+  fg.push_back(NonlinearFactor::shared_ptr());
+  fg.push_back(small.begin(), small.end());
+  Values initial = createNoisyValues();
+
+  const ParallelOptions parallel(4, 1);
+  GaussianFactorGraph serial = *fg.linearize(initial, ParallelOptions::Serial());
+  GaussianFactorGraph actual = *fg.linearize(initial, parallel);
+  LONGS_EQUAL(9, actual.size());
+  EXPECT(!actual[4]);
+  EXPECT(assert_equal(serial, actual));
+
+  DOUBLES_EQUAL(fg.error(initial, ParallelOptions::Serial()), fg.error(initial, parallel), 1e-9);
+}
+
+/* ************************************************************************* */
+TEST( NonlinearFactorGraph, linearizeInto )
+{
+  NonlinearFactorGraph fg = createNonlinearFactorGraph();
+  const Values initial = createNoisyValues();
+  const Values values = createValues();
+
+  // Linearizing into an empty graph creates all factors
+  GaussianFactorGraph linearFG;
+  fg.linearizeInto(initial, linearFG);
+  EXPECT(assert_equal(createGaussianFactorGraph(), linearFG));
+
+  // Relinearizing reuses the factors of the previous linearization
+  const GaussianFactor* first = linearFG[0].get();
+  const GaussianFactorGraph expected = *fg.linearize(values);
+  fg.linearizeInto(values, linearFG, ParallelOptions(4, 1));
+  EXPECT(assert_equal(expected, linearFG));
+  EXPECT(first == linearFG[0].get());
+
+  // Factors shared with another graph are replaced, and removed factors leave empty slots
+  const GaussianFactorGraph shared = linearFG;
+  fg.remove(1);
+  fg.linearizeInto(initial, linearFG);
+  EXPECT(first != linearFG[0].get());
+  EXPECT(!linearFG[1]);
+  EXPECT(assert_equal(*createGaussianFactorGraph()[0], *linearFG[0]));
+  EXPECT(assert_equal(expected, shared));
+}
+
+/* ************************************************************************* */
+TEST( NonlinearFactorGraph, batchedErrors )
+{
+  const NonlinearFactorGraph small = createNonlinearFactorGraph();
+  NonlinearFactorGraph fg = small;
+  fg.push_back(NonlinearFactor::shared_ptr());
+  fg.push_back(small.begin(), small.end());
+  Values initial = createNoisyValues();
+
+  // stacked in factor order, the null factor takes no rows
+  Vector unwhitened, whitened;
+  fg.unwhitenedErrors(initial, unwhitened, ParallelOptions(4, 1));
+  fg.whitenedErrors(initial, whitened, ParallelOptions(4, 1));
+  LONGS_EQUAL(16, unwhitened.size());
+  LONGS_EQUAL(16, whitened.size());
+  size_t row = 0;
+  for (const auto& factor : fg) {
+    if (!factor) continue;
+    auto noiseModelFactor = boost::dynamic_pointer_cast<NoiseModelFactor>(factor);
+    EXPECT(assert_equal(noiseModelFactor->unwhitenedError(initial),
+                        Vector(unwhitened.segment(row, 2))));
+    EXPECT(assert_equal(noiseModelFactor->whitenedError(initial),
+                        Vector(whitened.segment(row, 2))));
+    row += 2;
+  }
+  DOUBLES_EQUAL(fg.error(initial), 0.5 * whitened.squaredNorm(), 1e-9);
+
+  // the vector is reused if the size is right
+  const double* data = whitened.data();
+  fg.whitenedErrors(initial, whitened);
+  EXPECT(data == whitened.data());
+
+  // one weight per factor
+  Vector weights;
+  fg.weights(initial, weights, ParallelOptions(4, 1));
+  LONGS_EQUAL(9, weights.size());
+  DOUBLES_EQUAL(0.0, weights(4), 0);
+  auto first = boost::dynamic_pointer_cast<NoiseModelFactor>(fg[0]);
+  DOUBLES_EQUAL(first->weight(initial), weights(0), 1e-9);
+
+  // factors without a noise model are rejected
+  fg.emplace_shared<LinearContainerFactor>(
+      JacobianFactor(X(1), I_2x2, Vector2::Zero()));
+  CHECK_EXCEPTION(fg.whitenedErrors(initial, whitened), std::invalid_argument);
+  CHECK_EXCEPTION(fg.weights(initial, weights), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST( NonlinearFactorGraph, deterministicError )
+{
+  // Deterministic reductions give bitwise identical results for any number of threads
+  const NonlinearFactorGraph small = createNonlinearFactorGraph();
+  NonlinearFactorGraph fg;
+  for (size_t i = 0; i < 200; ++i) fg.push_back(small.begin(), small.end());
+  Values initial = createNoisyValues();
+
+  const double serial = fg.error(initial, ParallelOptions(1, 0, true));
+  for (size_t nrThreads : {2, 3, 4})
+    EXPECT(serial == fg.error(initial, ParallelOptions(nrThreads, 0, true)));
+  DOUBLES_EQUAL(200 * small.error(initial), serial, 1e-6);
+}
+
 /* ************************************************************************* */
 TEST( NonlinearFactorGraph, clone )
 {
@@ -201,6 +313,42 @@ TEST(NonlinearFactorGraph, UpdateCholesky) {
   EXPECT(assert_equal(initial, fg.updateCholesky(initial, dampen), 1e-6));
 }
 
+/* ************************************************************************* */
+TEST(NonlinearFactorGraph, linearizeToHessianFactorParallel) {
+  // Chunks of a few factors are linearized into Hessians of their own and summed
+  const NonlinearFactorGraph small = createNonlinearFactorGraph();
+  NonlinearFactorGraph fg;
+  for (size_t i = 0; i < 5; ++i) {
+    fg.push_back(small.begin(), small.end());
+    fg.push_back(NonlinearFactor::shared_ptr());
+  }
+  Values initial = createNoisyValues();
+  Ordering ordering;
+  ordering += L(1), X(2), X(1);
+
+  const auto serial = fg.linearizeToHessianFactor(initial, ordering, nullptr,
+                                                  ParallelOptions::Serial());
+  for (size_t nrThreads : {2, 4}) {
+    const ParallelOptions parallel(nrThreads, 3);
+    EXPECT(assert_equal(*serial, *fg.linearizeToHessianFactor(initial, ordering, nullptr,
+                                                              parallel), 1e-9));
+    EXPECT(assert_equal(fg.updateCholesky(initial, ordering, nullptr, ParallelOptions::Serial()),
+                        fg.updateCholesky(initial, ordering, nullptr, parallel), 1e-9));
+  }
+
+  // Deterministic accumulation gives the same Hessian for any number of threads, with enough
+  // factors for several chunks of at least 64 factors
+  NonlinearFactorGraph large;
+  for (size_t i = 0; i < 250; ++i) large.push_back(small.begin(), small.end());
+  const auto deterministic =
+      large.linearizeToHessianFactor(initial, nullptr, ParallelOptions(1, 0, true));
+  EXPECT(assert_equal(*large.linearizeToHessianFactor(initial), *deterministic, 1e-9));
+  for (size_t nrThreads : {2, 3, 4})
+    EXPECT(assert_equal(*deterministic, *large.linearizeToHessianFactor(
+                                            initial, nullptr, ParallelOptions(nrThreads, 0, true)),
+                        0));
+}
+
 /* ************************************************************************* */
 // Example from issue #452 which threw an ILS error. The reason was a very 
 // weak prior on heading, which was tightened, and the ILS disappeared.
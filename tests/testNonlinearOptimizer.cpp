@@ -139,6 +139,25 @@ TEST( NonlinearOptimizer, SimpleGNOptimizer )
   DOUBLES_EQUAL(0,fg.error(actual),tol);
 }
 
+/* ************************************************************************* */
+TEST( NonlinearOptimizer, GNError )
+{
+  // Gaussian factors, whose error is taken from the stacked whitened errors
+  NonlinearFactorGraph fg = example::createNonlinearFactorGraph();
+  const Values c0 = example::createNoisyValues();
+  GaussNewtonOptimizer optimizer(fg, c0);
+  optimizer.iterate();
+  DOUBLES_EQUAL(fg.error(optimizer.values()), optimizer.error(), 1e-9);
+
+  // a robust factor, whose error is not half its squared whitened error
+  fg += BetweenFactor<Point2>(X(1), X(2), Point2(5, 0),
+                              noiseModel::Robust::Create(noiseModel::mEstimator::Huber::Create(1.0),
+                                                         noiseModel::Isotropic::Sigma(2, 1)));
+  GaussNewtonOptimizer robust(fg, c0);
+  robust.iterate();
+  DOUBLES_EQUAL(fg.error(robust.values()), robust.error(), 1e-9);
+}
+
 /* ************************************************************************* */
 TEST( NonlinearOptimizer, SimpleDLOptimizer )
 {
@@ -159,6 +178,8 @@ TEST( NonlinearOptimizer, optimization_method )
   paramsQR.linearSolverType = LevenbergMarquardtParams::MULTIFRONTAL_QR;
   LevenbergMarquardtParams paramsChol;
   paramsChol.linearSolverType = LevenbergMarquardtParams::MULTIFRONTAL_CHOLESKY;
+  LevenbergMarquardtParams paramsCholmod;
+  paramsCholmod.linearSolverType = LevenbergMarquardtParams::CHOLMOD;
 
   NonlinearFactorGraph fg = example::createReallyNonlinearFactorGraph();
 
@@ -171,6 +192,35 @@ TEST( NonlinearOptimizer, optimization_method )
 
   Values actualMFChol = LevenbergMarquardtOptimizer(fg, c0, paramsChol).optimize();
   DOUBLES_EQUAL(0,fg.error(actualMFChol),tol);
+
+  Values actualCholmod = LevenbergMarquardtOptimizer(fg, c0, paramsCholmod).optimize();
+  DOUBLES_EQUAL(0,fg.error(actualCholmod),tol);
+}
+
+/* ************************************************************************* */
+TEST( NonlinearOptimizer, Cholmod )
+{
+  const NonlinearFactorGraph fg = example::createNonlinearFactorGraph();
+  const Values c0 = example::createNoisyValues();
+
+  // Every iteration should agree with the multifrontal solver
+  LevenbergMarquardtParams lmParams;
+  LevenbergMarquardtParams lmParamsCholmod;
+  lmParamsCholmod.linearSolverType = LevenbergMarquardtParams::CHOLMOD;
+  LevenbergMarquardtOptimizer expectedLM(fg, c0, lmParams);
+  LevenbergMarquardtOptimizer actualLM(fg, c0, lmParamsCholmod);
+  for (size_t i = 0; i < 3; ++i) {
+    expectedLM.iterate();
+    actualLM.iterate();
+    CHECK(assert_equal(expectedLM.values(), actualLM.values(), 1e-9));
+  }
+
+  // Gauss-Newton, with ordering chosen by the solver
+  GaussNewtonParams gnParams;
+  gnParams.linearSolverType = GaussNewtonParams::CHOLMOD;
+  Values expected = GaussNewtonOptimizer(fg, c0).optimize();
+  Values actual = GaussNewtonOptimizer(fg, c0, gnParams).optimize();
+  CHECK(assert_equal(expected, actual, 1e-9));
 }
 
 /* ************************************************************************* */
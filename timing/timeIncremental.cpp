@@ -23,7 +23,9 @@
 #include <gtsam/nonlinear/Marginals.h>
 #include <gtsam/base/timing.h>
 
+#include <cstdlib>
 #include <fstream>
+#include <stdexcept>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/export.hpp>
@@ -67,13 +69,28 @@ double chi2_red(const gtsam::NonlinearFactorGraph& graph, const gtsam::Values& c
   return 2. * graph.error(config) / dof; // kaess: added factor 2, graph.error returns half of actual error
 }
 
+// Usage: timeIncremental [dataset] [colamd|metis] [reorderThreshold]
+// The dataset is an example data file or a path to one, e.g. a Manhattan or
+// city10000 file in g2o/toro format, victoria_park by default.  The shipped
+// w20000 becomes indeterminant after a few thousand steps with the noise
+// models used here.
 int main(int argc, char *argv[]) {
 
+  ISAM2Params params;
+  if (argc > 2) {
+    const string orderingType = argv[2];
+    if (orderingType == "metis")
+      params.orderingType = Ordering::METIS;
+    else if (orderingType != "colamd")
+      throw invalid_argument("Unknown ordering type " + orderingType);
+  }
+  if (argc > 3) params.reorderThreshold = atof(argv[3]);
+
   cout << "Loading data..." << endl;
 
   gttic_(Find_datafile);
   //string datasetFile = findExampleDataFile("w10000-odom");
-  string datasetFile = findExampleDataFile("victoria_park");
+  string datasetFile = findExampleDataFile(argc > 1 ? argv[1] : "victoria_park");
   std::pair<NonlinearFactorGraph::shared_ptr, Values::shared_ptr> data =
     load2D(datasetFile);
   gttoc_(Find_datafile);
@@ -83,7 +100,8 @@ int main(int argc, char *argv[]) {
 
   cout << "Playing forward time steps..." << endl;
 
-  ISAM2 isam2;
+  ISAM2 isam2(params);
+  size_t reorderings = 0;
 
   size_t nextMeasurement = 0;
   for(size_t step=1; nextMeasurement < measurements.size(); ++step) {
@@ -117,23 +135,19 @@ int main(int argc, char *argv[]) {
         // Add a new factor
         newFactors.push_back(measurement);
 
-        // Initialize the new variable
-        if(measurement->key1() == step && measurement->key2() == step-1) {
-          if(step == 1)
-            newVariables.insert(step, measurement->measured().inverse());
-          else {
-            Pose prevPose = isam2.calculateEstimate<Pose>(step-1);
-            newVariables.insert(step, prevPose * measurement->measured().inverse());
-          }
-          //        cout << "Initializing " << step << endl;
-        } else if(measurement->key2() == step && measurement->key1() == step-1) {
-          if(step == 1)
-            newVariables.insert(step, measurement->measured());
-          else {
-            Pose prevPose = isam2.calculateEstimate<Pose>(step-1);
-            newVariables.insert(step, prevPose * measurement->measured());
-          }
-          //        cout << "Initializing " << step << endl;
+        // Initialize the new variable from the other one, which is not
+        // necessarily step-1, as some datasets number landmarks and poses
+        // together
+        const Key other = measurement->key1() == step ? measurement->key2()
+                                                      : measurement->key1();
+        if(other < step && !newVariables.exists(step)) {
+          const Pose otherPose = newVariables.exists(other)
+                                     ? newVariables.at<Pose>(other)
+                                     : isam2.calculateEstimate<Pose>(other);
+          if(measurement->key1() == step)
+            newVariables.insert(step, otherPose * measurement->measured().inverse());
+          else
+            newVariables.insert(step, otherPose * measurement->measured());
         }
       }
       else if(BearingRangeFactor<Pose, Point2>::shared_ptr measurement =
@@ -151,7 +165,8 @@ int main(int argc, char *argv[]) {
         // Initialize new landmark
         if(!isam2.getLinearizationPoint().exists(lmKey))
         {
-          Pose pose = isam2.calculateEstimate<Pose>(poseKey);
+          Pose pose = newVariables.exists(poseKey) ? newVariables.at<Pose>(poseKey)
+                                                   : isam2.calculateEstimate<Pose>(poseKey);
           Rot2 measuredBearing = measurement->measured().bearing();
           double measuredRange = measurement->measured().range();
           newVariables.insert(lmKey,
@@ -168,7 +183,7 @@ int main(int argc, char *argv[]) {
 
     // Update iSAM2
     gttic_(Update_ISAM2);
-    isam2.update(newFactors, newVariables);
+    if (isam2.update(newFactors, newVariables).reordered) ++reorderings;
     gttoc_(Update_ISAM2);
 
     if(step % 100 == 0) {
@@ -182,7 +197,9 @@ int main(int argc, char *argv[]) {
     tictoc_finishedIteration_();
 
     if(step % 1000 == 0) {
-      cout << "Step " << step << endl;
+      cout << "Step " << step << ", nonzeros " << isam2.nonzeros()
+           << ", fill ratio " << isam2.fillRatio() << ", reorderings "
+           << reorderings << endl;
       tictoc_print_();
     }
   }
@@ -0,0 +1,89 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeMultifrontalSolver.cpp
+ * @brief   Time multifrontal elimination with and without reusing the
+ *          junction tree across iterations, on a BAL problem
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/PinholeCamera.h>
+#include <gtsam/linear/MultifrontalSolver.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/timing.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::C;
+using symbol_shorthand::P;
+
+typedef PinholeCamera<Cal3Bundler> Camera;
+typedef GeneralSFMFactor<Camera, Point3> SfmFactor;
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  // Bundle adjustment, optionally on a user-provided BAL file
+  SfmData db;
+  const string filename =
+      argc > 1 ? argv[1] : findExampleDataFile("dubrovnik-3-7-pre");
+  if (!readBAL(filename, db)) {
+    cout << "Could not access file!" << endl;
+    return 1;
+  }
+  const size_t nrIterations = argc > 2 ? atoi(argv[2]) : 20;
+
+  NonlinearFactorGraph graph;
+  const auto noise = noiseModel::Unit::Create(2);
+  for (size_t j = 0; j < db.number_tracks(); j++)
+    for (const SfmMeasurement& m : db.tracks[j].measurements)
+      graph.emplace_shared<SfmFactor>(m.second, noise, C(m.first), P(j));
+
+  // Weak priors on all variables, like the damping of Levenberg-Marquardt
+  for (size_t i = 0; i < db.number_cameras(); i++)
+    graph.addPrior(C(i), db.cameras[i], noiseModel::Isotropic::Sigma(9, 10.0));
+  for (size_t j = 0; j < db.number_tracks(); j++)
+    graph.addPrior(P(j), db.tracks[j].p, noiseModel::Isotropic::Sigma(3, 10.0));
+
+  Values initial;
+  for (size_t i = 0; i < db.number_cameras(); i++)
+    initial.insert(C(i), db.cameras[i]);
+  for (size_t j = 0; j < db.number_tracks(); j++)
+    initial.insert(P(j), db.tracks[j].p);
+
+  // Every iteration of an optimizer eliminates a graph with the same structure
+  const GaussianFactorGraph linear = *graph.linearize(initial);
+  cout << filename << ": " << graph.size() << " factors, " << initial.size()
+       << " variables, " << nrIterations << " iterations" << endl;
+
+  // Compute the ordering, variable index and trees in every iteration
+  for (size_t i = 0; i < nrIterations; i++) {
+    gttic_(eliminateMultifrontal);
+    linear.eliminateMultifrontal();
+  }
+
+  // Compute them once and only eliminate numerically afterwards
+  MultifrontalSolver solver;
+  for (size_t i = 0; i < nrIterations; i++) {
+    gttic_(MultifrontalSolver);
+    solver.eliminate(linear);
+  }
+
+  tictoc_finishedIteration_();
+  tictoc_print_();
+  return 0;
+}
@@ -0,0 +1,74 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeParallelElimination.cpp
+ * @brief   Thread scaling of parallel multifrontal elimination and
+ *          back-substitution (DepthFirstForestParallel), on TBB or on the
+ *          GTSAM ThreadPool
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/slam/dataset.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/base/ThreadPool.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  // Usage: timeParallelElimination [dataset] [repetitions]
+  const string dataset = argc > 1 ? argv[1] : "w20000.txt";
+  const size_t repetitions = argc > 2 ? atoi(argv[2]) : 3;
+
+  NonlinearFactorGraph::shared_ptr graph;
+  Values::shared_ptr initial;
+  boost::tie(graph, initial) = load2D(findExampleDataFile(dataset));
+  graph->addPrior(0, Pose2(), noiseModel::Isotropic::Sigma(3, 1e-6));
+
+  const GaussianFactorGraph::shared_ptr linear = graph->linearize(*initial);
+  const Ordering ordering = Ordering::Colamd(*linear);
+  cout << dataset << ": " << linear->size() << " factors, " << ordering.size()
+       << " variables" << endl;
+
+  double baseline = 0.0;
+  for (int nThreads = 1; nThreads <= 64; nThreads *= 2) {
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::duration<double> Seconds;
+    double eliminate = 0.0, solve = 0.0;
+    runWithThreads(ParallelOptions(nThreads), [&] {
+      for (size_t i = 0; i < repetitions; ++i) {
+        const Clock::time_point t0 = Clock::now();
+        const GaussianBayesTree::shared_ptr bayesTree =
+            linear->eliminateMultifrontal(ordering);
+        const Clock::time_point t1 = Clock::now();
+        const VectorValues delta = bayesTree->optimize();
+        const Clock::time_point t2 = Clock::now();
+        eliminate += Seconds(t1 - t0).count();
+        solve += Seconds(t2 - t1).count();
+      }
+    });
+    eliminate /= repetitions;
+    solve /= repetitions;
+    if (nThreads == 1) baseline = eliminate + solve;
+    cout << nThreads << " threads: eliminate " << eliminate << " s, optimize "
+         << solve << " s, speedup " << baseline / (eliminate + solve) << endl;
+  }
+  return 0;
+}
@@ -35,16 +35,20 @@ using symbol_shorthand::K;
 using symbol_shorthand::P;
 
 static bool gUseSchur = true;
+static bool gSchurComplement = false;  // eliminate points with SCHUR_COMPLEMENT
 static SharedNoiseModel gNoiseModel = noiseModel::Unit::Create(2);
+static IterativeOptimizationParameters::shared_ptr gIterativeParams;  // if set, solve iteratively
 
 // parse options and read BAL file
 SfmData preamble(int argc, char* argv[]) {
   // primitive argument parsing:
   if (argc > 2) {
-    if (strcmp(argv[1], "--colamd"))
+    if (!strcmp(argv[1], "--schur-complement"))
+      gSchurComplement = true;
+    else if (strcmp(argv[1], "--colamd"))
       gUseSchur = false;
     else
-      throw runtime_error("Usage: timeSFMBALxxx [--colamd] [BALfile]");
+      throw runtime_error("Usage: timeSFMBALxxx [--colamd|--schur-complement] [BALfile]");
   }
 
   // Load BAL file
@@ -70,7 +74,12 @@ int optimize(const SfmData& db, const NonlinearFactorGraph& graph,
 //  params.setLinearSolverType("SEQUENTIAL_CHOLESKY");
 //  params.setVerbosityLM("SUMMARY");
 
-  if (gUseSchur) {
+  if (gSchurComplement) {
+    params.linearSolverType = NonlinearOptimizerParams::SCHUR_COMPLEMENT;
+  } else if (gIterativeParams) {
+    params.linearSolverType = NonlinearOptimizerParams::Iterative;
+    params.iterativeParams = gIterativeParams;
+  } else if (gUseSchur) {
     // Create Schur-complement ordering
     Ordering ordering;
     for (size_t j = 0; j < db.number_tracks(); j++) ordering.push_back(P(j));
@@ -19,6 +19,7 @@
 #include "timeSFMBAL.h"
 
 #include <gtsam/slam/SmartProjectionFactor.h>
+#include <gtsam/slam/SchurPCGSolver.h>
 #include <gtsam/geometry/Cal3Bundler.h>
 #include <gtsam/geometry/PinholeCamera.h>
 #include <gtsam/geometry/Point3.h>
@@ -30,13 +31,25 @@ typedef PinholeCamera<Cal3Bundler> Camera;
 typedef SmartProjectionFactor<Camera> SfmFactor;
 
 int main(int argc, char* argv[]) {
+  // --pcg linearizes to implicit Schur factors and solves with SchurPCGSolver
+  const bool pcg = argc > 1 && !strcmp(argv[1], "--pcg");
+  if (pcg) {
+    --argc;
+    ++argv;
+  }
+
   // parse options and read BAL file
   SfmData db = preamble(argc, argv);
 
   // Add smart factors to graph
+  SmartProjectionParams smartParams;
+  if (pcg) {
+    smartParams.setLinearizationMode(IMPLICIT_SCHUR);
+    gIterativeParams = boost::make_shared<SchurPCGSolver<Camera>::Parameters>();
+  }
   NonlinearFactorGraph graph;
   for (size_t j = 0; j < db.number_tracks(); j++) {
-    auto smartFactor = boost::make_shared<SfmFactor>(gNoiseModel);
+    auto smartFactor = boost::make_shared<SfmFactor>(gNoiseModel, smartParams);
     for (const SfmMeasurement& m : db.tracks[j].measurements) {
       size_t i = m.first;
       Point2 z = m.second;
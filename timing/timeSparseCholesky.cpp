@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeSparseCholesky.cpp
+ * @brief   Time the CHOLMOD (sparse Cholesky) linear solver against
+ *          MULTIFRONTAL_CHOLESKY on a pose graph and a BAL problem
+ * @date    Oct 15, 2026
+ */
+
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/PinholeCamera.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/timing.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::C;
+using symbol_shorthand::P;
+
+typedef PinholeCamera<Cal3Bundler> Camera;
+typedef GeneralSFMFactor<Camera, Point3> SfmFactor;
+
+/* ************************************************************************* */
+// Run LM with both linear solvers and report the final errors
+static void compare(const string& name, const NonlinearFactorGraph& graph,
+                    const Values& initial) {
+  LevenbergMarquardtParams params;
+  params.maxIterations = 10;
+
+  params.linearSolverType = LevenbergMarquardtParams::MULTIFRONTAL_CHOLESKY;
+  double multifrontalError, cholmodError;
+  {
+    gttic_(MULTIFRONTAL_CHOLESKY);
+    LevenbergMarquardtOptimizer lm(graph, initial, params);
+    multifrontalError = graph.error(lm.optimize());
+  }
+
+  params.linearSolverType = LevenbergMarquardtParams::CHOLMOD;
+  {
+    gttic_(CHOLMOD);
+    LevenbergMarquardtOptimizer lm(graph, initial, params);
+    cholmodError = graph.error(lm.optimize());
+  }
+
+  tictoc_finishedIteration_();
+  cout << name << ": final error MULTIFRONTAL_CHOLESKY " << multifrontalError
+       << ", CHOLMOD " << cholmodError << endl;
+  tictoc_print_();
+  tictoc_reset_();
+}
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  try {
+    // Pose graph
+    NonlinearFactorGraph::shared_ptr poseGraph;
+    Values::shared_ptr poses;
+    boost::tie(poseGraph, poses) = load2D(findExampleDataFile("w20000.txt"));
+    poseGraph->addPrior(0, Pose2(), noiseModel::Isotropic::Sigma(3, 1e-6));
+    compare("w20000", *poseGraph, *poses);
+
+    // Bundle adjustment, optionally on a user-provided BAL file
+    SfmData db;
+    const string filename =
+        argc > 1 ? argv[1] : findExampleDataFile("dubrovnik-3-7-pre");
+    if (!readBAL(filename, db)) throw runtime_error("Could not access file!");
+
+    NonlinearFactorGraph graph;
+    const auto noise = noiseModel::Unit::Create(2);
+    for (size_t j = 0; j < db.number_tracks(); j++)
+      for (const SfmMeasurement& m : db.tracks[j].measurements)
+        graph.emplace_shared<SfmFactor>(m.second, noise, C(m.first), P(j));
+
+    Values initial;
+    for (size_t i = 0; i < db.number_cameras(); i++)
+      initial.insert(C(i), db.cameras[i]);
+    for (size_t j = 0; j < db.number_tracks(); j++)
+      initial.insert(P(j), db.tracks[j].p);
+    compare(filename, graph, initial);
+  } catch (std::exception& e) {
+    cout << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
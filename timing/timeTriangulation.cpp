@@ -0,0 +1,98 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeTriangulation.cpp
+ * @brief   Time triangulating many tracks one at a time against in a batch
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/geometry/triangulation.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/geometry/PinholeCamera.h>
+#include <gtsam/base/timing.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace gtsam;
+
+typedef PinholeCamera<Cal3_S2> Camera;
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  const size_t nrCameras = 100, nrTracks = argc > 1 ? atoi(argv[1]) : 100000,
+               trackLength = 5;
+
+  // Cameras on a circle of radius 10, looking at the origin
+  const Cal3_S2 K(500, 500, 0, 640, 480);
+  CameraSet<Camera> cameras;
+  for (size_t i = 0; i < nrCameras; ++i) {
+    const double theta = 2 * M_PI * i / nrCameras;
+    cameras.push_back(Camera::Lookat(Point3(10 * cos(theta), 10 * sin(theta), 0),
+                                     Point3(0, 0, 0), Point3(0, 0, 1), K));
+  }
+
+  // Points near the origin, seen with one pixel of noise by consecutive cameras
+  mt19937 rng(42);
+  uniform_real_distribution<double> position(-2, 2);
+  normal_distribution<double> pixel(0, 1);
+  vector<TriangulationTrack<Camera> > tracks(nrTracks);
+  for (TriangulationTrack<Camera>& track : tracks) {
+    const Point3 point(position(rng), position(rng), position(rng));
+    const size_t first = rng() % nrCameras;
+    for (size_t k = 0; k < trackLength; ++k) {
+      const size_t i = (first + k) % nrCameras;
+      track.emplace_back(i, cameras[i].project(point) + Point2(pixel(rng), pixel(rng)));
+    }
+  }
+
+  for (const bool refine : {false, true}) {
+    const TriangulationParameters params(1.0, refine);
+    cout << (refine ? "With" : "Without") << " refinement:" << endl;
+
+    size_t validSingle = 0;
+    {
+      gttic_(oneAtATime);
+      for (const TriangulationTrack<Camera>& track : tracks) {
+        CameraSet<Camera> trackCameras;
+        Point2Vector measured;
+        for (const auto& measurement : track) {
+          trackCameras.push_back(cameras[measurement.first]);
+          measured.push_back(measurement.second);
+        }
+        validSingle += triangulateSafe(trackCameras, measured, params).valid();
+      }
+    }
+
+    size_t validSerial = 0, validParallel = 0;
+    {
+      gttic_(batchSerial);
+      for (const TriangulationResult& result :
+           triangulateSafe(cameras, tracks, params, ParallelOptions::Serial()))
+        validSerial += result.valid();
+    }
+    {
+      gttic_(batchParallel);
+      for (const TriangulationResult& result : triangulateSafe(cameras, tracks, params))
+        validParallel += result.valid();
+    }
+
+    tictoc_finishedIteration_();
+    tictoc_print_();
+    tictoc_reset_();
+    cout << "valid points: " << validSingle << " one at a time, " << validSerial
+         << " batched, " << validParallel << " batched in parallel" << endl;
+  }
+  return 0;
+}
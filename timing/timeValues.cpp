@@ -0,0 +1,140 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeValues.cpp
+ * @brief   Time the block storage of Values against the boost::ptr_map storage it
+ *          replaced, on insertion, copying, lookup, retract and localCoordinates
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/ptr_container/ptr_map.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// The previous Values storage, reduced to the operations timed below
+class PtrMapValues {
+  typedef boost::ptr_map<Key, Value, std::less<Key>, ValueCloneAllocator,
+                         boost::fast_pool_allocator<std::pair<const Key, void*> > >
+      KeyValueMap;
+  KeyValueMap values_;
+
+ public:
+  void insert(Key j, const Value& value) { values_.insert(j, value.clone_()); }
+
+  const Value& at(Key j) const { return *values_.find(j)->second; }
+
+  PtrMapValues retract(const VectorValues& delta) const {
+    PtrMapValues result;
+    for (auto it = values_.begin(); it != values_.end(); ++it) {
+      Key key = it->first;
+      const VectorValues::const_iterator d = delta.find(key);
+      if (d != delta.end())
+        result.values_.insert(key, it->second->retract_(d->second));
+      else
+        result.values_.insert(key, it->second->clone_());
+    }
+    return result;
+  }
+
+  VectorValues localCoordinates(const PtrMapValues& other) const {
+    VectorValues result;
+    auto jt = other.values_.begin();
+    for (auto it = values_.begin(); it != values_.end(); ++it, ++jt)
+      result.insert(it->first, it->second->localCoordinates_(*jt->second));
+    return result;
+  }
+};
+
+/* ************************************************************************* */
+typedef std::chrono::steady_clock Clock;
+
+// Average seconds per call of f over a number of repetitions
+static double timeIt(size_t repetitions, const std::function<void()>& f) {
+  const Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < repetitions; ++i) f();
+  return std::chrono::duration<double>(Clock::now() - start).count() / repetitions;
+}
+
+static void report(const string& name, double ptrMap, double values) {
+  cout << setw(20) << name << setw(14) << ptrMap << setw(14) << values << setw(10)
+       << ptrMap / values << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  // Usage: timeValues [number of poses] [repetitions]
+  const size_t n = argc > 1 ? atoi(argv[1]) : 500000;
+  const size_t repetitions = argc > 2 ? atoi(argv[2]) : 5;
+
+  // Poses on a helix, and a small update for all of them
+  vector<Pose3> poses;
+  VectorValues delta;
+  for (size_t i = 0; i < n; ++i) {
+    const double t = 0.01 * i;
+    poses.push_back(Pose3(Rot3::Ypr(t, 0.1, 0.2), Point3(cos(t), sin(t), 0.1 * t)));
+    delta.insert(Symbol('x', i), Vector6::Constant(1e-3));
+  }
+
+  cout << n << " Pose3 values, seconds per call" << endl;
+  cout << setw(20) << "" << setw(14) << "ptr_map" << setw(14) << "Values" << setw(10)
+       << "speedup" << endl;
+
+  PtrMapValues ptrMap;
+  Values values;
+  report("insert", timeIt(repetitions, [&] {
+           ptrMap = PtrMapValues();
+           for (size_t i = 0; i < n; ++i) ptrMap.insert(Symbol('x', i), genericValue(poses[i]));
+         }),
+         timeIt(repetitions, [&] {
+           values = Values();
+           for (size_t i = 0; i < n; ++i) values.insert(Symbol('x', i), poses[i]);
+         }));
+
+  PtrMapValues ptrMapCopy;
+  Values valuesCopy;
+  report("copy", timeIt(repetitions, [&] { ptrMapCopy = ptrMap; }),
+         timeIt(repetitions, [&] { valuesCopy = values; }));
+
+  double sum = 0.0;
+  report("at", timeIt(repetitions, [&] {
+           for (size_t i = 0; i < n; ++i)
+             sum += ptrMap.at(Symbol('x', i)).cast<Pose3>().x();
+         }),
+         timeIt(repetitions, [&] {
+           for (size_t i = 0; i < n; ++i) sum += values.at<Pose3>(Symbol('x', i)).x();
+         }));
+
+  PtrMapValues ptrMapRetracted;
+  Values valuesRetracted;
+  report("retract", timeIt(repetitions, [&] { ptrMapRetracted = ptrMap.retract(delta); }),
+         timeIt(repetitions, [&] { valuesRetracted = values.retract(delta); }));
+
+  report("localCoordinates",
+         timeIt(repetitions, [&] { ptrMap.localCoordinates(ptrMapRetracted); }),
+         timeIt(repetitions, [&] { values.localCoordinates(valuesRetracted); }));
+
+  if (sum == 0.0) cout << endl;  // keep the lookups from being optimized away
+  return 0;
+}
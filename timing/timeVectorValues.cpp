@@ -0,0 +1,115 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeVectorValues.cpp
+ * @brief   Time the serial bulk operations of VectorValues against splitting them over
+ *          threads, which needs a serial pass over the map to find the vectors first
+ * @date    Oct 16, 2026
+ */
+
+#include <gtsam/base/ThreadPool.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+typedef std::chrono::steady_clock Clock;
+
+// Average seconds per call of f over a number of repetitions
+static double timeIt(size_t repetitions, const std::function<void()>& f) {
+  const Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < repetitions; ++i) f();
+  return std::chrono::duration<double>(Clock::now() - start).count() / repetitions;
+}
+
+static void report(const string& name, double serial, double parallel) {
+  cout << setw(14) << name << setw(14) << serial << setw(14) << parallel << setw(10)
+       << serial / parallel << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  // Usage: timeVectorValues [number of 6-dimensional variables] [threads] [repetitions]
+  const size_t n = argc > 1 ? atoi(argv[1]) : 1000000;
+  const size_t threads = argc > 2 ? atoi(argv[2]) : 4;
+  const size_t repetitions = argc > 3 ? atoi(argv[3]) : 10;
+  const ParallelOptions parallel = ParallelOptions(threads).resolved(n, 256);
+
+  VectorValues x, y;
+  for (size_t j = 0; j < n; ++j) {
+    x.insert(j, Vector6::Constant(1e-3 * j));
+    y.insert(j, Vector6::Constant(1.0));
+  }
+
+  cout << n << " Vector6 variables, " << threads << " threads, seconds per call" << endl;
+  cout << setw(14) << "" << setw(14) << "serial" << setw(14) << "parallel" << setw(10)
+       << "speedup" << endl;
+
+  // The parallel versions pair up the vectors in one pass over both maps, then split the pairs
+  typedef pair<Vector*, const Vector*> Pair;
+  const auto pairUp = [&]() {
+    vector<Pair> pairs;
+    pairs.reserve(n);
+    VectorValues::const_iterator jy = y.begin();
+    for (VectorValues::iterator jx = x.begin(); jx != x.end(); ++jx, ++jy)
+      pairs.emplace_back(&jx->second, &jy->second);
+    return pairs;
+  };
+
+  double sum = 0.0;
+  report("dot", timeIt(repetitions, [&] { sum += x.dot(y); }), timeIt(repetitions, [&] {
+           const vector<Pair> pairs = pairUp();
+           sum += parallelReduce(0, n, 0.0,
+                                 [&](size_t first, size_t last, double result) {
+                                   for (size_t i = first; i < last; ++i)
+                                     result += pairs[i].first->dot(*pairs[i].second);
+                                   return result;
+                                 },
+                                 std::plus<double>(), parallel);
+         }));
+
+  report("squaredNorm", timeIt(repetitions, [&] { sum += x.squaredNorm(); }),
+         timeIt(repetitions, [&] {
+           const vector<Pair> pairs = pairUp();
+           sum += parallelReduce(0, n, 0.0,
+                                 [&](size_t first, size_t last, double result) {
+                                   for (size_t i = first; i < last; ++i)
+                                     result += pairs[i].first->squaredNorm();
+                                   return result;
+                                 },
+                                 std::plus<double>(), parallel);
+         }));
+
+  report("addInPlace", timeIt(repetitions, [&] { x.addInPlace(y); }), timeIt(repetitions, [&] {
+           const vector<Pair> pairs = pairUp();
+           parallelFor(0, n, [&](size_t first, size_t last) {
+             for (size_t i = first; i < last; ++i) *pairs[i].first += *pairs[i].second;
+           }, parallel);
+         }));
+
+  report("scaleInPlace", timeIt(repetitions, [&] { x.scaleInPlace(0.5); }),
+         timeIt(repetitions, [&] {
+           const vector<Pair> pairs = pairUp();
+           parallelFor(0, n, [&](size_t first, size_t last) {
+             for (size_t i = first; i < last; ++i) *pairs[i].first *= 0.5;
+           }, parallel);
+         }));
+
+  if (sum == 0.0) cout << endl;  // keep the reductions from being optimized away
+  return 0;
+}